@@ -258,7 +258,9 @@ DENG_HEADERS += \
     include/gl/gl_draw.h \
     include/gl/gl_main.h \
     include/gl/gl_model.h \
+    include/gl/gl_resample.h \
     include/gl/gl_tex.h \
+    include/gl/gl_texcache.h \
     include/gl/gl_texmanager.h \
     include/gl/gltextureunit.h \
     include/gl/svg.h \
@@ -291,6 +293,7 @@ DENG_HEADERS += \
     include/render/biassurface.h \
     include/render/biastracker.h \
     include/render/blockmapvisual.h \
+    include/render/cliprangearray.h \
     include/render/decoration.h \
     include/render/drawlist.h \
     include/render/drawlists.h \
@@ -467,6 +470,7 @@ DENG_HEADERS += \
     include/uri.hh \
     include/versioninfo.h \
     include/world/blockmap.h \
+    include/world/bsp/bspcache.h \
     include/world/bsp/bsptreenode.h \
     include/world/bsp/convexsubspace.h \
     include/world/bsp/edgetip.h \
@@ -620,7 +624,9 @@ SOURCES += \
     src/gl/gl_drawvectorgraphic.cpp \
     src/gl/gl_main.cpp \
     src/gl/gl_model.cpp \
+    src/gl/gl_resample.cpp \
     src/gl/gl_tex.cpp \
+    src/gl/gl_texcache.cpp \
     src/gl/gl_texmanager.cpp \
     src/gl/svg.cpp \
     src/gl/sys_opengl.cpp \
@@ -650,6 +656,7 @@ SOURCES += \
     src/render/biassurface.cpp \
     src/render/biastracker.cpp \
     src/render/blockmapvisual.cpp \
+    src/render/cliprangearray.cpp \
     src/render/decoration.cpp \
     src/render/drawlist.cpp \
     src/render/drawlists.cpp \
@@ -695,6 +702,7 @@ SOURCES += \
     src/resource/fonts.cpp \
     src/resource/hq2x.cpp \
     src/resource/image.cpp \
+    src/resource/lumpcache.cpp \
     src/resource/material.cpp \
     src/resource/materialanimation.cpp \
     src/resource/materialarchive.cpp \
@@ -817,6 +825,7 @@ SOURCES += \
     src/world/api_map.cpp \
     src/world/api_mapedit.cpp \
     src/world/blockmap.cpp \
+    src/world/bsp/bspcache.cpp \
     src/world/bsp/convexsubspace.cpp \
     src/world/bsp/hplane.cpp \
     src/world/bsp/linesegment.cpp \
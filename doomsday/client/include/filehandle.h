@@ -107,6 +107,21 @@ public:
      */
     FileHandle& rewind();
 
+    /**
+     * Provides direct, read-only access to a range of the file's contents.
+     * Native files are memory-mapped in their entirety the first time this is
+     * called; buffered handles return a pointer into the buffer. The view
+     * remains valid until the handle is closed.
+     *
+     * @param offset  Offset in bytes from the start of the file (relative to
+     *                the base offset, like seek()).
+     * @param length  Number of bytes in the range.
+     *
+     * @return  Pointer to the first byte of the range, or @c 0 if the range is
+     * out of bounds or the file could not be mapped.
+     */
+    uint8_t const* map(size_t offset, size_t length);
+
     friend class FileHandleBuilder;
 
 private:
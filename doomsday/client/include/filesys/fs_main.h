@@ -380,6 +380,20 @@ public:
      */
     File1 &interpret(FileHandle &hndl, String path, FileInfo const &info);
 
+    /**
+     * Recognises the formats of a set of native files ahead of opening them.
+     * The headers are read concurrently, each file on a separate handle. The
+     * files are not opened or indexed; when one of them is later opened with
+     * openFile(), it is interpreted directly with the recognised type, so the
+     * order of the loaded files is still determined by the caller.
+     *
+     * The results of the previous call are discarded.
+     *
+     * @param paths  Paths of the native files. Paths that cannot be opened
+     *               as native files are ignored.
+     */
+    void recogniseFormats(QStringList const &paths);
+
     /**
      * Indexes @a file (which must have been opened with this file system) into
      * this file system and adds it to the list of loaded files.
@@ -408,6 +422,17 @@ public:
      */
     lumpnum_t lumpNumForName(String name);
 
+    /**
+     * Begin decompressing the data of lumps (in the primary index) into the lump
+     * cache in background threads, so that it is ready when needed. Only lumps
+     * compressed in ZIP packages need this; others are ignored.
+     *
+     * @param lumpNums  Logical lump numbers of the lumps to prefetch.
+     *
+     * @see Zip::prefetchLumps()
+     */
+    void prefetchLumps(QList<lumpnum_t> const& lumpNums);
+
     /**
      * Provides access to the main index of the file system. This can be
      * used for efficiently looking up files based on name.
@@ -579,6 +604,13 @@ de::String App_BasePath();
 extern "C" {
 #endif // __cplusplus
 
+/**
+ * Memory-mapped lump access (cvar): 0=Off, 1=On. When enabled, uncompressed
+ * lumps are accessed directly in the mapped container instead of being copied
+ * into the lump cache.
+ */
+extern byte fileMapLumps;
+
 /**
  * C wrapper API:
  */
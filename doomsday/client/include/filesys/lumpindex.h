@@ -119,6 +119,14 @@ public:
      */
     void catalogLump(File1& lump);
 
+    /**
+     * Append many lumps to the index at once. Prefer this to repeatedly
+     * calling catalogLump() when adding all the lumps of a file.
+     *
+     * @param lumps     Lumps to be added, in order.
+     */
+    void catalogLumps(Lumps const& lumps);
+
     /**
      * Prune all lumps catalogued from @a file.
      *
@@ -142,6 +150,12 @@ public:
      */
     static void print(LumpIndex const& index);
 
+    /**
+     * Measure the cost of building and searching an index of @a numLumps
+     * synthetic lumps, and print the results.
+     */
+    static void benchmark(int numLumps);
+
 private:
     struct Instance;
     Instance* d;
@@ -145,6 +145,15 @@ namespace de
             : FileType(name, rclassId)
         {}
 
+        /**
+         * Determines whether the file appears to be of this type. Only the
+         * handle is accessed, so different files may be recognised in
+         * parallel (see FS1::recogniseFormats()).
+         *
+         * @param hndl  Handle to the file to be recognised.
+         */
+        virtual bool recognise(de::FileHandle& hndl) const = 0;
+
         /**
          * Attempt to interpret a file file of this type.
          *
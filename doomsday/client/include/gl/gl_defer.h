@@ -77,6 +77,14 @@ void GL_ReleaseReservedNames(void);
  */
 void GL_DeferTextureUpload(const struct texturecontent_s* content);
 
+/**
+ * Adds a new deferred texture upload task to the queue, without copying.
+ *
+ * @param content  Texture content to upload. Ownership is given to the deferred
+ *                 task (see GL_ConstructTextureContentCopy()).
+ */
+void GL_DeferTextureContentUpload(struct texturecontent_s* content);
+
 void GL_DeferSetVSync(boolean enableVSync);
 
 // Deferring functions for various function signatures.
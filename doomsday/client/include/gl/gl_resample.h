@@ -0,0 +1,62 @@
+/** @file gl_resample.h Image resampling and mipmap reduction. @ingroup gl
+ *
+ * The functions only depend on libdeng and libdeng2.
+ *
+ * @authors Copyright © 2003-2013 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2006-2013 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef LIBDENG_IMAGE_RESAMPLING_H
+#define LIBDENG_IMAGE_RESAMPLING_H
+
+#include <de/types.h>
+
+uint8_t* GL_ScaleBuffer(const uint8_t* pixels, int width, int height,
+    int pixelSize, int outWidth, int outHeight);
+
+void* GL_ScaleBufferEx(const void* datain, int width, int height, int pixelSize,
+    /*GLint typein,*/ int rowLength, int alignment, int skiprows, int skipPixels,
+    int outWidth, int outHeight, /*GLint typeout,*/ int outRowLength, int outAlignment,
+    int outSkipRows, int outSkipPixels);
+
+uint8_t* GL_ScaleBufferNearest(const uint8_t* pixels, int width, int height,
+    int pixelSize, int outWidth, int outHeight);
+
+/**
+ * Works within the given data, reducing the size of the picture to half
+ * its original.
+ *
+ * @param pixels     RGB(A) pixel data to process (in/out).
+ * @param width      Width of the final texture, must be power of two.
+ * @param height     Height of the final texture, must be power of two.
+ * @param pixelSize  Size of a pixel in bytes.
+ */
+void GL_DownMipmap32(uint8_t* pixels, int width, int height, int pixelSize);
+
+/**
+ * Works within the given data, reducing the size of the picture to half
+ * its original.
+ *
+ * @param in        Pixel data to process (paletted, in/out).
+ * @param fadedOut  Faded result image.
+ * @param width     Width of the final texture, must be power of two.
+ * @param height    Height of the final texture, must be power of two.
+ * @param fade      Fade factor (0..1).
+ */
+void GL_DownMipmap8(uint8_t* in, uint8_t* fadedOut, int width, int height, float fade);
+
+#endif // LIBDENG_IMAGE_RESAMPLING_H
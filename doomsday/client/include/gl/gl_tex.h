@@ -25,6 +25,7 @@
 
 #include "color.h"
 #include "resource/r_data.h"
+#include "gl/gl_resample.h"
 
 typedef struct colorpalette_analysis_s {
     colorpaletteid_t paletteId;
@@ -226,40 +227,6 @@ void FindClipRegionNonAlpha(const uint8_t* pixels, int width, int height,
  */
 void SharpenPixels(uint8_t* pixels, int width, int height, int pixelSize);
 
-uint8_t* GL_ScaleBuffer(const uint8_t* pixels, int width, int height,
-    int pixelSize, int outWidth, int outHeight);
-
-void* GL_ScaleBufferEx(const void* datain, int width, int height, int pixelSize,
-    /*GLint typein,*/ int rowLength, int alignment, int skiprows, int skipPixels,
-    int outWidth, int outHeight, /*GLint typeout,*/ int outRowLength, int outAlignment,
-    int outSkipRows, int outSkipPixels);
-
-uint8_t* GL_ScaleBufferNearest(const uint8_t* pixels, int width, int height,
-    int pixelSize, int outWidth, int outHeight);
-
-/**
- * Works within the given data, reducing the size of the picture to half
- * its original.
- *
- * @param pixels     RGB(A) pixel data to process (in/out).
- * @param width      Width of the final texture, must be power of two.
- * @param height     Height of the final texture, must be power of two.
- * @param pixelSize  Size of a pixel in bytes.
- */
-void GL_DownMipmap32(uint8_t* pixels, int width, int height, int pixelSize);
-
-/**
- * Works within the given data, reducing the size of the picture to half
- * its original.
- *
- * @param in        Pixel data to process (paletted, in/out).
- * @param fadedOut  Faded result image.
- * @param width     Width of the final texture, must be power of two.
- * @param height    Height of the final texture, must be power of two.
- * @param fade      Fade factor (0..1).
- */
-void GL_DownMipmap8(uint8_t* in, uint8_t* fadedOut, int width, int height, float fade);
-
 boolean GL_PalettizeImage(uint8_t* out, int outformat, const struct colorpalette_s* palette,
     boolean gammaCorrect, const uint8_t* in, int informat, int width, int height);
 
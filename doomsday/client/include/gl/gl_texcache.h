@@ -0,0 +1,95 @@
+/**
+ * @file gl_texcache.h
+ * Persistent cache of processed texture content. @ingroup gl
+ *
+ * Preparing the content of a texture variant (filtering, upscaling, palette
+ * conversion and resizing) gives the same result for the same input, yet it
+ * is repeated each time the engine is started. The processed content is
+ * therefore stored on disk, in the "texcache" directory under the runtime
+ * directory, so that later sessions can skip the work.
+ *
+ * Each entry is addressed by a hash of everything that affects the result:
+ * the pixels of the source image (and its palette), the relevant parts of the
+ * variant specification, and the texture settings. Stale entries are never
+ * found, so there is no need to invalidate anything. However, stale entries
+ * are not removed either: the directory grows without limit and has to be
+ * deleted by the user to reclaim the space. The cache is therefore disabled
+ * by default.
+ *
+ * The functions are thread-safe.
+ *
+ * @authors Copyright © 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef LIBDENG_GL_TEXCACHE_H
+#define LIBDENG_GL_TEXCACHE_H
+
+#ifndef __CLIENT__
+#  error "gl/gl_texcache.h only exists in the Client"
+#endif
+
+#ifndef __cplusplus
+#  error "gl/gl_texcache.h requires C++"
+#endif
+
+#include <de/String>
+#include "gl/texturecontent.h"
+#include "resource/image.h"
+#include "resource/texturevariantspec.h"
+
+/// Texture content cache mode (cvar): 0=Off (default), 1=On, 2=On (compressed entries).
+DENG_EXTERN_C byte texCacheMode;
+
+/**
+ * Composes the key of the cache entry for the content prepared from @a image
+ * in accordance with @a spec.
+ *
+ * @return  Key of the entry, or an empty string if the content should not be
+ * cached (e.g., the cache is disabled).
+ */
+de::String GL_TexCacheKey(image_t const &image, texturevariantspecification_t const &spec);
+
+/**
+ * Looks up processed texture content from the cache.
+ *
+ * @param key      Key of the entry.
+ * @param content  If found, the format, dimensions, flags and pixels of the
+ *                 content are written here. The pixels are allocated with
+ *                 M_Malloc(). Other members of the content are not changed.
+ * @param image    If found, the dimensions and flags of the source image
+ *                 after preparation are written here.
+ *
+ * @return  @c true, if the entry was found.
+ */
+bool GL_TexCacheFind(de::String const &key, texturecontent_t &content, image_t &image);
+
+/**
+ * Stores processed texture content in the cache.
+ *
+ * @param key      Key of the entry.
+ * @param content  Processed content (see @c TXCF_PROCESSED).
+ * @param image    Source image after preparation.
+ */
+void GL_TexCacheInsert(de::String const &key, texturecontent_t const &content, image_t const &image);
+
+/**
+ * Returns the number of cache lookups that found an entry (@a hits) and the
+ * number that did not (@a misses), since the start of the session.
+ */
+void GL_TexCacheStats(int &hits, int &misses);
+
+#endif /* LIBDENG_GL_TEXCACHE_H */
@@ -59,6 +59,7 @@ DENG_EXTERN_C boolean noHighResTex;
 DENG_EXTERN_C boolean noHighResPatches;
 DENG_EXTERN_C boolean highResWithPWAD;
 DENG_EXTERN_C byte loadExtAlways;
+DENG_EXTERN_C byte prepareTexturesAsync;
 
 void GL_TexRegister();
 
@@ -193,7 +194,8 @@ GLUploadMethod GL_ChooseUploadMethod(texturecontent_t const &content);
  * the supplied specification. The image data will be transformed in-place.
  *
  * @param c             Texture content to be completed.
- * @param glTexName     GL name for the texture we intend to upload.
+ * @param glTexName     GL name for the texture we intend to upload (zero if
+ *                      the content will not be uploaded).
  * @param image         Source image containing the pixel data to be prepared.
  * @param spec          Specification describing any transformations which
  *                      should be applied to the image.
@@ -206,7 +208,41 @@ void GL_PrepareTextureContent(texturecontent_t &c, DGLuint glTexName,
     de::TextureManifest const &textureManifest);
 
 /**
- * @param method  GL upload method. By default the upload is deferred.
+ * Performs the CPU-side processing of texture content for uploading: paletted
+ * images are converted to truecolor, gamma correction and the smart filter are
+ * applied, and the image is resized as required by GL. Since GL is not used,
+ * this can be done in any thread.
+ *
+ * @param content  Texture content to process. Must not be processed already.
+ *
+ * @return  New texture content (flagged @c TXCF_PROCESSED) that owns its
+ * pixels. Destroy with GL_DestroyTextureContent().
+ */
+texturecontent_t *GL_ConstructProcessedTextureContent(texturecontent_t const &content);
+
+/**
+ * Prepares texture content from @a image in accordance with @a spec (see
+ * GL_PrepareTextureContent()) and processes it for uploading (see
+ * GL_ConstructProcessedTextureContent()). The processed content is looked up
+ * from the persistent texture content cache first, and stored there if not
+ * found. Since GL is not used, this can be done in any thread.
+ *
+ * @param glTexName  GL name for the texture we intend to upload (or zero).
+ * @param image      Source image. Prepared in place; if the content is found
+ *                   in the cache, only the dimensions and flags of the image
+ *                   are updated to what they would be after preparation.
+ * @param spec       Specification of the variant.
+ * @param textureManifest  Manifest for the logical texture being prepared.
+ *
+ * @return  New processed texture content. Destroy with GL_DestroyTextureContent().
+ */
+texturecontent_t *GL_ConstructPreparedTextureContent(DGLuint glTexName, image_t &image,
+    texturevariantspecification_t const &spec, de::TextureManifest const &textureManifest);
+
+/**
+ * @param method  GL upload method. By default the upload is deferred. When
+ *                deferred, unprocessed content is processed in the calling
+ *                thread and only the upload itself is deferred.
  *
  * @note Can be rather time-consuming due to forced scaling operations and
  * the generation of mipmaps.
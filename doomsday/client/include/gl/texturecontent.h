@@ -41,6 +41,7 @@ extern "C" {
 #define TXCF_UPLOAD_ARG_NOSTRETCH       0x20
 #define TXCF_UPLOAD_ARG_NOSMARTFILTER   0x40
 #define TXCF_NEVER_DEFER                0x80
+#define TXCF_PROCESSED                  0x100 ///< Pixels are ready for uploading as-is.
 /*@}*/
 
 /**
@@ -0,0 +1,95 @@
+/** @file cliprangearray.h Sorted array of clipped angle ranges.
+ *
+ * @authors Copyright © 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_CLIENT_RENDER_CLIPRANGEARRAY_H
+#define DENG_CLIENT_RENDER_CLIPRANGEARRAY_H
+
+#include <vector>
+
+#include <de/binangle.h>
+
+/**
+ * Clipped angle ranges of the angle clipper, kept in a flat array sorted by
+ * start angle. Ranges which overlap or touch each other are merged, so the
+ * ranges in the array are always disjoint. Lookups use binary searches.
+ *
+ * The array keeps its capacity when cleared, so no allocations are needed
+ * once it has grown to the size required by a frame.
+ *
+ * @ingroup render
+ */
+class ClipRangeArray
+{
+public:
+    struct Range
+    {
+        /// The start and end angles (start < end).
+        binangle_t start, end;
+
+        Range(binangle_t start = 0, binangle_t end = 0) : start(start), end(end)
+        {}
+    };
+    typedef std::vector<Range> Ranges;
+
+public:
+    ClipRangeArray();
+
+    /**
+     * Removes all ranges (the capacity of the array is retained).
+     */
+    void clear();
+
+    /**
+     * Adds a range, merging it with all the existing ranges it overlaps or
+     * touches.
+     */
+    void add(binangle_t startAngle, binangle_t endAngle);
+
+    /**
+     * Returns @c true iff the range is not entirely contained by a clipped
+     * range.
+     */
+    bool isRangeVisible(binangle_t startAngle, binangle_t endAngle) const;
+
+    /**
+     * Returns @c true iff the angle is not strictly inside a clipped range.
+     */
+    bool isAngleVisible(binangle_t angle) const;
+
+    /**
+     * Returns @c true iff the ranges cover all angles.
+     */
+    bool isFull() const;
+
+    /**
+     * Provides access to the ranges, in ascending order.
+     */
+    Ranges const &ranges() const;
+
+private:
+    /**
+     * @return  The range with the greatest start angle less than (or equal to,
+     *          if @a inclusive) @a angle; otherwise @c 0.
+     */
+    Range const *rangeBefore(binangle_t angle, bool inclusive) const;
+
+    Ranges _ranges;
+};
+
+#endif // DENG_CLIENT_RENDER_CLIPRANGEARRAY_H
@@ -38,6 +38,7 @@
 #include "Face"
 
 DENG_EXTERN_C int devNoCulling;
+DENG_EXTERN_C byte devClipRangeArray;
 
 void C_Init();
 
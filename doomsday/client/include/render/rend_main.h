@@ -110,6 +110,8 @@ DENG_EXTERN_C int useShinySurfaces;
 DENG_EXTERN_C float detailFactor, detailScale;
 
 DENG_EXTERN_C byte devRendSkyAlways;
+DENG_EXTERN_C byte rendInfoBsp;
+DENG_EXTERN_C byte rendInfoLists;
 DENG_EXTERN_C byte rendInfoLums;
 DENG_EXTERN_C byte devDrawLums;
 
@@ -27,6 +27,8 @@
 #include <de/size.h>
 #include <de/str.h>
 
+namespace de { class AtlasTexture; }
+
 // Data for a character.
 typedef struct {
     RectRaw geometry;
@@ -77,6 +79,9 @@ typedef struct {
     patchid_t patch;
     de::Texture::Variant *tex;
     uint8_t border;
+
+    /// Area of the glyph in the font's atlas (in texels), if the font has one.
+    RectRaw atlasRect;
 } bitmapcompositefont_char_t;
 
 typedef struct bitmapcompositefont_s {
@@ -86,6 +91,10 @@ typedef struct bitmapcompositefont_s {
     /// Definition used to construct this else @c NULL if not applicable.
     struct ded_compositefont_s *_def;
 
+    /// Atlas containing all the glyphs, else @c NULL if not applicable (the
+    /// glyphs then have their own textures).
+    de::AtlasTexture *_atlas;
+
     /// Character map.
     bitmapcompositefont_char_t _chars[MAX_CHARS];
 } bitmapcompositefont_t;
@@ -105,6 +114,16 @@ void BitmapCompositeFont_SetDefinition(font_t *font, struct ded_compositefont_s
 patchid_t BitmapCompositeFont_CharPatch(font_t *font, unsigned char ch);
 void BitmapCompositeFont_CharSetPatch(font_t *font, unsigned char ch, char const *encodedPatchName);
 
+/**
+ * Returns the GL name of the texture atlas containing all the glyphs of the
+ * font, or zero if the glyphs have their own textures (see
+ * BitmapCompositeFont_CharTexture()). The atlas texture coordinates returned
+ * by BitmapCompositeFont_CharCoords() are in texels.
+ */
+DGLuint BitmapCompositeFont_GLTextureName(font_t *font);
+int BitmapCompositeFont_TextureHeight(font_t *font);
+int BitmapCompositeFont_TextureWidth(font_t *font);
+
 de::Texture::Variant *BitmapCompositeFont_CharTexture(font_t *font, unsigned char ch);
 void BitmapCompositeFont_ReleaseTextures(font_t *font);
 
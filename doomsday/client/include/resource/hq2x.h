@@ -42,7 +42,8 @@ void GL_InitSmartFilterHQ2x(void);
  *
  * Uses 32-bit data and our native ABGR8888 pixel format.
  * Alpha is taken into account in the processing to preserve edges.
- * (Not quite as efficient as the original version.)
+ * Large images are processed in bands of rows using multiple threads; the
+ * result does not depend on the number of threads.
  *
  * @param src  R8G8B8A8 source image to be scaled.
  * @param width  Width of the source image in pixels.
@@ -33,13 +33,37 @@
 #include <de/memory.h>
 #include <de/memoryzone.h>
 
+/// Budget for the data of all lump caches, in megabytes (cvar); 0=Unlimited.
+DENG_EXTERN_C int lumpCacheBudget;
+
+/**
+ * Cached lump data is kept in a least-recently-used order shared by all
+ * caches. When the combined size of the data exceeds the budget
+ * (@ref lumpCacheBudget), the least recently used data that is not locked
+ * is freed.
+ *
+ * @note Must only be used in the main thread.
+ */
 class LumpCache
 {
+public:
+    /// Statistics of all lump caches since the start of the session.
+    struct Stats
+    {
+        uint hits;
+        uint misses;
+        uint evictions;
+        size_t evictedBytes;
+        size_t bytes;       ///< Present size of the cached data.
+        size_t peakBytes;
+    };
+
 private:
     class CacheRecord
     {
     public:
-        explicit CacheRecord(uint8_t* data = 0) : data_(data) {}
+        explicit CacheRecord(uint8_t* data = 0)
+            : data_(data), size_(0), lruPrev(0), lruNext(0), linked(false) {}
         ~CacheRecord()
         {
             clearData();
@@ -53,16 +77,27 @@ private:
                 Z_ChangeTag2(data_, PU_APPSTATIC);
                 Z_ChangeUser(data_, (void*)&data_);
             }
+            return peek();
+        }
+
+        /// Returns the data without locking it.
+        uint8_t* peek() const
+        {
+            // Purged by the Zone?
+            if(!data_) const_cast<CacheRecord*>(this)->unlink();
+            else       const_cast<CacheRecord*>(this)->touch();
             return data_;
         }
 
-        uint8_t const* replaceData(uint8_t* newData)
+        uint8_t const* replaceData(uint8_t* newData, size_t size)
         {
             clearData();
             data_ = newData;
             if(data_)
             {
                 Z_ChangeUser(data_, &data_);
+                size_ = size;
+                touch();
             }
             return newData;
         }
@@ -82,7 +117,9 @@ private:
                 }
                 // Mark the data as unowned.
                 Z_ChangeUser(data_, (void*) 0x2);
+                data_ = 0;
             }
+            unlink();
             if(retCleared) *retCleared = hasData;
             return *this;
         }
@@ -103,8 +140,22 @@ private:
             return *this;
         }
 
+        /// Frees the data, if it is not locked.
+        bool evict();
+
     private:
+        /// Moves the record to the most recently used end of the order.
+        void touch();
+
+        void unlink();
+
         uint8_t* data_;
+        size_t size_;
+        CacheRecord* lruPrev;
+        CacheRecord* lruNext;
+        bool linked;
+
+        friend class LumpCache;
     };
     typedef std::vector<CacheRecord> DataCache;
 
@@ -125,10 +176,37 @@ public:
     {
         LOG_AS("LumpCache::data");
         CacheRecord const* record = cacheRecord(lumpIdx);
-        return record? record->data() : 0;
+        uint8_t const* found = record? record->data() : 0;
+        countLookup(found != 0);
+        return found;
+    }
+
+    /// @return  @c true iff data for lump @a lumpIdx is presently cached.
+    bool contains(uint lumpIdx) const
+    {
+        CacheRecord const* record = cacheRecord(lumpIdx);
+        return record && record->data_;
+    }
+
+    /**
+     * Returns the cached data of lump @a lumpIdx (if any) without locking it.
+     * The data may be purged by the next allocation, so it must be used
+     * immediately.
+     */
+    uint8_t const* peek(uint lumpIdx) const
+    {
+        CacheRecord const* record = cacheRecord(lumpIdx);
+        uint8_t const* found = record? record->peek() : 0;
+        countLookup(found != 0);
+        return found;
     }
 
-    LumpCache& insert(uint lumpIdx, uint8_t* data)
+    /**
+     * @param lumpIdx  Index of the lump.
+     * @param data     Data of the lump, allocated from the Zone.
+     * @param size     Size of @a data in bytes.
+     */
+    LumpCache& insert(uint lumpIdx, uint8_t* data, size_t size)
     {
         LOG_AS("LumpCache::insert");
         if(!isValidIndex(lumpIdx)) throw de::Error("LumpCache::insert", QString("Invalid index %1").arg(lumpIdx));
@@ -140,13 +218,16 @@ public:
         }
 
         CacheRecord* record = cacheRecord(lumpIdx);
-        record->replaceData(data);
+        record->replaceData(data, size);
+
+        // Make room by evicting the least recently used data.
+        enforceBudget();
         return *this;
     }
 
-    LumpCache& insertAndLock(uint lumpIdx, uint8_t* data)
+    LumpCache& insertAndLock(uint lumpIdx, uint8_t* data, size_t size)
     {
-        return insert(lumpIdx, data).lock(lumpIdx);
+        return insert(lumpIdx, data, size).lock(lumpIdx);
     }
 
     LumpCache& lock(uint lumpIdx)
@@ -163,7 +244,7 @@ public:
         LOG_AS("LumpCache::unlock");
         if(!isValidIndex(lumpIdx)) throw de::Error("LumpCache::unlock", QString("Invalid index %1").arg(lumpIdx));
         CacheRecord* record = cacheRecord(lumpIdx);
-        record->unlock();
+        if(record) record->unlock();
         return *this;
     }
 
@@ -193,7 +274,17 @@ public:
         return *this;
     }
 
+    /**
+     * Frees the least recently used data of all caches, until their combined
+     * size is within the budget. Locked data is not freed.
+     */
+    static void enforceBudget();
+
+    static Stats const& stats();
+
 private:
+    static void countLookup(bool hit);
+
     CacheRecord* cacheRecord(uint lumpIdx)
     {
         if(!isValidIndex(lumpIdx)) return 0;
@@ -212,6 +303,11 @@ private:
 
     /// The cached data.
     DataCache* dataCache;
+
+    /// Least (head) to most (tail) recently used records of all caches.
+    static CacheRecord* lruHead;
+    static CacheRecord* lruTail;
+    static Stats stats_;
 };
 
 #endif /* LIBDENG_FILESYS_LUMPCACHE_H */
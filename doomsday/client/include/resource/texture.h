@@ -150,7 +150,13 @@ public:
          * GL texture will result in "uninitialized" white texels being used
          * instead.
          *
-         * @return  GL-name of the uploaded texture.
+         * Map surface variants may be prepared in a background thread (cvar
+         * "rend-tex-async"). While the preparation is underway, zero is
+         * returned; calling prepare() again later completes the preparation
+         * by uploading the content.
+         *
+         * @return  GL-name of the uploaded texture, or zero if not (yet)
+         * available.
          */
         uint prepare();
 
@@ -23,6 +23,7 @@
 
 #include "filesys/file.h"
 #include "filesys/fileinfo.h"
+#include <QList>
 #include <de/PathTree>
 
 namespace de {
@@ -126,6 +127,17 @@ public:
      */
     uint8_t const *cacheLump(int lumpIdx);
 
+    /**
+     * Begin decompressing lumps into the cache in background threads. Returns
+     * once the compressed data has been read. The lumps are inserted into the
+     * cache (unlocked) when they are next accessed, waiting for the
+     * decompression to finish if necessary. Lumps that are not compressed or
+     * that are already cached are skipped.
+     *
+     * @param lumpIdxs  Lump indices associated with the data to be cached.
+     */
+    void prefetchLumps(QList<int> const &lumpIdxs);
+
     /**
      * Remove a lock on a cached data lump.
      *
@@ -0,0 +1,121 @@
+/** @file bspcache.h Persistent cache of built map BSPs.
+ *
+ * @authors Copyright © 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_WORLD_BSP_BSPCACHE_H
+#define DENG_WORLD_BSP_BSPCACHE_H
+
+#include <QList>
+
+#include <de/String>
+#include <de/Vector>
+
+#include "world/bsp/partitioner.h"
+
+class Sector;
+
+namespace de {
+
+class MapElement;
+class Mesh;
+
+namespace bsp {
+
+/**
+ * Persistent cache of the output of the Partitioner.
+ *
+ * An entry stores the new vertexes, the half-edge geometry (including the
+ * extra meshes of BSP leafs), the line side segments and the BSP tree of a
+ * map. Entries are keyed by a hash of the map geometry the BSP is built from
+ * (vertex coordinates, lines and their sectors) together with the split cost
+ * factor, so an entry is only found for an unchanged map. Entries are fully
+ * validated against the map before anything is constructed; an entry that
+ * does not match is ignored and the BSP is built again (replacing the entry).
+ *
+ * Unclosed sectors found while partitioning are stored in the entry so that
+ * they are reported for a map loaded from the cache, too.
+ *
+ * @ingroup bsp
+ */
+class BspCache : DENG2_OBSERVES(Partitioner, UnclosedSectorFound)
+{
+public:
+    struct UnclosedSector
+    {
+        Sector *sector;
+        Vector2d nearPoint;
+
+        UnclosedSector(Sector *sector = 0, Vector2d const &nearPoint = Vector2d())
+            : sector(sector), nearPoint(nearPoint) {}
+    };
+    typedef QList<UnclosedSector> UnclosedSectors;
+
+public:
+    /**
+     * Composes the key of the entry for the BSP of the given map geometry.
+     * The mesh must not yet contain any of the elements produced by the
+     * build.
+     *
+     * @param lines            Lines to build the BSP for.
+     * @param sectors          All sectors of the map.
+     * @param mesh             Map geometry mesh.
+     * @param splitCostFactor  Cost factor attributed to splitting a half-edge.
+     */
+    BspCache(Partitioner::LineSet const &lines, QList<Sector *> const &sectors,
+             Mesh &mesh, int splitCostFactor);
+
+    /**
+     * Returns the key of the entry.
+     */
+    String const &key() const;
+
+    /**
+     * Looks up the entry and constructs the BSP it describes. New vertexes,
+     * half-edges and faces are added to the mesh and line side segments to
+     * the lines, exactly as the Partitioner would have done.
+     *
+     * @return  Root element of the BSP tree (ownership of the tree is given
+     * to the caller), or @c 0 if no valid entry was found (nothing has been
+     * changed).
+     */
+    MapElement *load();
+
+    /**
+     * Stores the BSP built by the Partitioner in the cache.
+     *
+     * @param root  Root element of the BSP tree.
+     */
+    void store(MapElement const &root);
+
+    /**
+     * Returns the unclosed sectors found while partitioning (observed while
+     * building, or read from the entry).
+     */
+    UnclosedSectors const &unclosedSectors() const;
+
+    // Observes Partitioner UnclosedSectorFound.
+    void unclosedSectorFound(Sector &sector, Vector2d const &nearPoint);
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+} // namespace bsp
+} // namespace de
+
+#endif // DENG_WORLD_BSP_BSPCACHE_H
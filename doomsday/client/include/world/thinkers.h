@@ -38,6 +38,11 @@ class Thinkers
 public:
     Thinkers();
 
+    /**
+     * Register the console commands, variables, etc..., of this module.
+     */
+    static void consoleRegister();
+
     /**
      * Returns @c true iff the thinker lists been initialized.
      */
@@ -64,6 +69,29 @@ public:
      */
     void remove(thinker_t &thinker);
 
+    /**
+     * Run all thinkers for one tic. Thinkers flagged for removal are destroyed
+     * when their turn comes up.
+     *
+     * If the @c thinker-packed cvar was set when the thinkers were created,
+     * the lists are run using a contiguous index of their thinkers rather than
+     * by following the thinker links.
+     *
+     * @param flags  Thinker filter flags.
+     */
+    void run(byte flags);
+
+    /**
+     * Allocates memory for a new mobj (@c MOBJ_SIZE bytes, zeroed). The memory
+     * is never freed individually; unused mobjs are recycled.
+     *
+     * If the @c thinker-packed cvar was set when the thinkers were created,
+     * the mobjs are allocated in contiguous batches which are released along
+     * with the thinkers. Otherwise they are allocated from the memory zone and
+     * purged when the map is unloaded.
+     */
+    struct mobj_s *newMobj();
+
     /**
      * Iterate the list of thinkers making a callback for each.
      *
@@ -78,7 +106,8 @@ public:
                 int (*callback) (thinker_t *th, void *), void *context = 0);
 
     /**
-     * Locates a mobj by it's unique identifier in the map.
+     * Locates a mobj by it's unique identifier in the map. Lookup is done
+     * using a hash of the mobjs currently linked in the thinker lists.
      *
      * @param id  Unique id of the mobj to lookup.
      */
@@ -92,9 +121,17 @@ public:
     /**
      * @param id     New thinker id.
      * @param inUse  In-use state of @a id. @c true = the id is in use.
+     *               Marking an id as free also removes any mobj using it
+     *               from the id lookup hash.
      */
     void setMobjId(thid_t id, bool inUse = true);
 
+    /**
+     * Measure the cost of running @a numThinkers synthetic thinkers, both in
+     * linked and in packed mode, and print the results.
+     */
+    static void benchmark(int numThinkers);
+
 private:
     DENG2_PRIVATE(d)
 };
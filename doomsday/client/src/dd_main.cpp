@@ -31,9 +31,14 @@
 #  include <objbase.h>
 #endif
 
+#include <QFile>
+#include <QList>
+#include <QPair>
 #include <QStringList>
+#include <de/AllocationProfiler>
 #include <de/App>
 #include <de/NativePath>
+#include <de/Time>
 #include <de/binangle.h>
 
 #ifdef __CLIENT__
@@ -98,9 +103,14 @@ public:
     ZipFileType() : NativeFileType("FT_ZIP", RC_PACKAGE)
     {}
 
+    bool recognise(de::FileHandle& hndl) const
+    {
+        return Zip::recognise(hndl);
+    }
+
     de::File1* interpret(de::FileHandle& hndl, String path, FileInfo const& info) const
     {
-        if(Zip::recognise(hndl))
+        if(recognise(hndl))
         {
             LOG_AS("ZipFileType");
             LOG_VERBOSE("Interpreted \"" + NativePath(path).pretty() + "\".");
@@ -116,9 +126,14 @@ public:
     WadFileType() : NativeFileType("FT_WAD", RC_PACKAGE)
     {}
 
+    bool recognise(de::FileHandle& hndl) const
+    {
+        return Wad::recognise(hndl);
+    }
+
     de::File1* interpret(de::FileHandle& hndl, String path, FileInfo const& info) const
     {
-        if(Wad::recognise(hndl))
+        if(recognise(hndl))
         {
             LOG_AS("WadFileType");
             LOG_VERBOSE("Interpreted \"" + NativePath(path).pretty() + "\".");
@@ -186,6 +201,35 @@ static Materials *materials;
 // The app's global Texture collection.
 static Textures *textures;
 
+/// Durations of the startup phases (seconds), in the order they completed.
+static QList<QPair<String, double> > startupPhases;
+static de::Time startupPhaseStartedAt;
+
+/**
+ * Marks the end of a startup phase. The time elapsed since the end of the
+ * previous phase is attributed to @a name.
+ */
+static void endStartupPhase(char const *name)
+{
+    startupPhases.append(qMakePair(String(name), double(startupPhaseStartedAt.since())));
+    startupPhaseStartedAt = de::Time();
+}
+
+static void printStartupPhases()
+{
+    double total = 0;
+    for(int i = 0; i < startupPhases.size(); ++i)
+    {
+        total += startupPhases[i].second;
+    }
+
+    LOG_INFO("Startup completed in %.2f seconds:") << total;
+    for(int i = 0; i < startupPhases.size(); ++i)
+    {
+        LOG_INFO("  %-24s %6.2f s") << startupPhases[i].first << startupPhases[i].second;
+    }
+}
+
 #ifdef __CLIENT__
 
 D_CMD(CheckForUpdates)
@@ -224,6 +268,95 @@ D_CMD(ShowUpdateSettings)
 
 #endif // __CLIENT__
 
+/**
+ * Prints the amount of memory allocated from the zone with each purge tag.
+ */
+D_CMD(ZoneStatus)
+{
+    DENG_UNUSED(src); DENG_UNUSED(argc); DENG_UNUSED(argv);
+
+    uint totalBlocks = 0;
+    size_t totalBytes = 0;
+
+    Con_Message("Memory zone allocations by purge tag:");
+    for(int tag = 0; tag <= PU_PURGELEVEL; ++tag)
+    {
+        uint blocks = 0;
+        size_t const bytes = Z_TagMemory(tag, &blocks);
+        if(!blocks) continue;
+
+        Con_Message("  Tag %3i: %6u blocks, %10.1f KB", tag, blocks, bytes / 1024.0);
+        totalBlocks += blocks;
+        totalBytes  += bytes;
+    }
+    Con_Message("Total: %u blocks, %.1f KB", totalBlocks, totalBytes / 1024.0);
+    return true;
+}
+
+/**
+ * Controls the allocation profiler and prints or saves its report.
+ */
+D_CMD(AllocationProfiler)
+{
+    DENG_UNUSED(src);
+
+    if(!stricmp(argv[1], "on") || !stricmp(argv[1], "off"))
+    {
+        bool const enable = !stricmp(argv[1], "on");
+        AllocationProfiler::setEnabled(enable);
+        Con_Message("Allocation profiler %s.", enable? "enabled" : "disabled");
+        return true;
+    }
+
+    if(!stricmp(argv[1], "clear"))
+    {
+        AllocationProfiler::clear();
+        Con_Message("Allocation profile cleared.");
+        return true;
+    }
+
+    if(!stricmp(argv[1], "report"))
+    {
+        AllocationProfiler::SortOrder order = AllocationProfiler::ByTotalBytes;
+        if(argc > 2)
+        {
+            if(!stricmp(argv[2], "count"))         order = AllocationProfiler::ByCount;
+            else if(!stricmp(argv[2], "live"))     order = AllocationProfiler::ByLiveBytes;
+            else if(!stricmp(argv[2], "lifetime")) order = AllocationProfiler::ByLifetime;
+            else if(stricmp(argv[2], "bytes"))
+            {
+                Con_Message("Unknown sort order \"%s\".", argv[2]);
+                return false;
+            }
+        }
+
+        String const report = AllocationProfiler::report(order);
+
+        if(argc > 3)
+        {
+            NativePath const path = NativePath(argv[3]).expand();
+            QFile file(path);
+            if(!file.open(QFile::WriteOnly | QFile::Text))
+            {
+                Con_Message("Failed to write \"%s\".", path.pretty().toUtf8().constData());
+                return false;
+            }
+            file.write(report.toUtf8());
+            Con_Message("Allocation profile written to \"%s\".", path.pretty().toUtf8().constData());
+            return true;
+        }
+
+        foreach(QString const &line, report.split('\n', QString::SkipEmptyParts))
+        {
+            Con_Message("%s", line.toUtf8().constData());
+        }
+        return true;
+    }
+
+    Con_Message("Usage: %s (on|off|clear|report) [bytes|count|live|lifetime] [file]", argv[0]);
+    return false;
+}
+
 void App_DeleteMaterials()
 {
     delete materials;
@@ -650,6 +783,8 @@ void DD_Register(void)
     C_CMD("updatesettings",  "", ShowUpdateSettings);
     C_CMD("lastupdated",     "", LastUpdated);
 #endif
+    C_CMD("allocprofiler",   "s*", AllocationProfiler);
+    C_CMD("zonestatus",      "", ZoneStatus);
 
     DD_RegisterLoop();
     F_Register();
@@ -794,6 +929,14 @@ static int loadFilesFromDataGameAuto()
     FS1::PathList found;
     findAllGameDataPaths(found);
 
+    // Recognise the formats of the native files in parallel.
+    QStringList paths;
+    DENG2_FOR_EACH_CONST(FS1::PathList, i, found)
+    {
+        if(!(i->attrib & A_SUBDIR)) paths << i->path;
+    }
+    App_FileSystem().recogniseFormats(paths);
+
     int numLoaded = 0;
     DENG2_FOR_EACH_CONST(FS1::PathList, i, found)
     {
@@ -932,6 +1075,16 @@ static int DD_LoadGameStartupResourcesWorker(void* parameters)
 
     Game::Manifests const& gameManifests = App_CurrentGame().manifests();
     int const numPackages = gameManifests.count(RC_PACKAGE);
+
+    // Recognise the formats of the packages in parallel.
+    QStringList packagePaths;
+    for(Game::Manifests::const_iterator i = gameManifests.find(RC_PACKAGE);
+        i != gameManifests.end() && i.key() == RC_PACKAGE; ++i)
+    {
+        packagePaths << (*i)->resolvedPath(false/*do not locate resource*/);
+    }
+    App_FileSystem().recogniseFormats(packagePaths);
+
     int packageIdx = 0;
     for(Game::Manifests::const_iterator i = gameManifests.find(RC_PACKAGE);
         i != gameManifests.end() && i.key() == RC_PACKAGE; ++i, ++packageIdx)
@@ -953,6 +1106,22 @@ static int DD_LoadGameStartupResourcesWorker(void* parameters)
     return 0;
 }
 
+/**
+ * Recognise the formats of all the files in the list in parallel, ahead of
+ * loading them with addListFiles().
+ */
+static void recogniseListFiles(ddstring_t*** list, size_t* listSize)
+{
+    if(!list || !listSize) return;
+
+    QStringList paths;
+    for(size_t i = 0; i < *listSize; ++i)
+    {
+        paths << Str_Text((*list)[i]);
+    }
+    App_FileSystem().recogniseFormats(paths);
+}
+
 static int addListFiles(ddstring_t*** list, size_t* listSize, FileType const& ftype)
 {
     size_t i;
@@ -1139,6 +1308,8 @@ static int DD_LoadAddonResourcesWorker(void* parameters)
         listFilesFromDataGameAuto(&sessionResourceFileList, &numSessionResourceFileList);
         if(numSessionResourceFileList > 0)
         {
+            recogniseListFiles(&sessionResourceFileList, &numSessionResourceFileList);
+
             addListFiles(&sessionResourceFileList, &numSessionResourceFileList, DD_FileTypeByName("FT_ZIP"));
 
             addListFiles(&sessionResourceFileList, &numSessionResourceFileList, DD_FileTypeByName("FT_WAD"));
@@ -1866,6 +2037,9 @@ boolean DD_Init(void)
     }
 #endif
 
+    startupPhases.clear();
+    startupPhaseStartedAt = de::Time();
+
 #ifdef __CLIENT__
     if(!GL_EarlyInit())
     {
@@ -1883,6 +2057,7 @@ boolean DD_Init(void)
 
     Fonts_Init();
     FR_Init();
+    endStartupPhase("Early init");
 
 #ifdef __CLIENT__
     // Enter busy mode until startup complete.
@@ -1895,6 +2070,7 @@ boolean DD_Init(void)
 #ifdef __CLIENT__
     GL_Init();
     GL_InitRefresh();
+    endStartupPhase("GL init");
 #endif
 
 #ifdef __CLIENT__
@@ -1903,6 +2079,7 @@ boolean DD_Init(void)
 #endif
     BusyMode_RunNewTaskWithName(BUSYF_STARTUP | BUSYF_PROGRESS_BAR | (verbose? BUSYF_CONSOLE_OUTPUT : 0),
                                 DD_DummyWorker, 0, "Buffering...");
+    endStartupPhase("Deferred uploads");
 
     // Add resource paths specified using -iwad on the command line.
     FS1::Scheme& scheme = App_FileSystem().scheme(DD_ResourceClassByName("RC_PACKAGE").defaultScheme());
@@ -1935,6 +2112,7 @@ boolean DD_Init(void)
     Con_InitProgress2(200, .25f, 1); // Second half.
 #endif
     App_Games().locateAllResources();
+    endStartupPhase("Locating resources");
 
     // Attempt automatic game selection.
     if(!CommandLine_Exists("-noautoselect") || isDedicated)
@@ -1977,12 +2155,14 @@ boolean DD_Init(void)
         }
 #endif
     }
+    endStartupPhase("Loading game");
 
     initPathLumpMappings();
 
     // Re-initialize the filesystem subspace schemess as there are now new
     // resources to be found on existing search paths (probably that is).
     App_FileSystem().resetAllSchemes();
+    endStartupPhase("Rescanning schemes");
 
     // One-time execution of various command line features available during startup.
     if(CommandLine_CheckWith("-dumplump", 1))
@@ -2102,7 +2282,9 @@ boolean DD_Init(void)
         /// GameSelection widget where as the server will not.
         //Con_Execute(CMDS_DDAY, "listgames", false, false);
     }
+    endStartupPhase("Finishing");
 
+    printStartupPhases();
     return true;
 }
 
@@ -2135,6 +2317,7 @@ static int DD_StartupWorker(void* /*parm*/)
         Con_Message("--(!)-- User directory not found (check -userdir).");
 
     DD_InitResourceSystem();
+    endStartupPhase("Resource system");
 
     Con_SetProgress(40);
 
@@ -2168,6 +2351,7 @@ static int DD_StartupWorker(void* /*parm*/)
     de::File1 *loadedFile = tryLoadFile(de::Uri(foundPath, RC_NULL));
     DENG2_ASSERT(loadedFile != 0);
     DENG2_UNUSED(loadedFile);
+    endStartupPhase("Network and packages");
 
     /*
      * No more lumps/packages will be loaded in startup mode after this point.
@@ -2180,6 +2364,7 @@ static int DD_StartupWorker(void* /*parm*/)
 
     // Execute the startup script (Startup.cfg).
     Con_ParseCommands("startup.cfg");
+    endStartupPhase("Help and startup.cfg");
     Con_SetProgress(90);
 
     R_BuildTexGammaLut();
@@ -2193,9 +2378,11 @@ static int DD_StartupWorker(void* /*parm*/)
     DENG_ASSERT(!materials);
     materials = new Materials();
     DD_CreateMaterialSchemes();
+    endStartupPhase("Textures and materials");
     Con_SetProgress(140);
 
     R_Init();
+    endStartupPhase("Renderer");
     Con_SetProgress(165);
 
     Net_InitGame();
@@ -2219,6 +2406,7 @@ static int DD_StartupWorker(void* /*parm*/)
     Con_SetProgress(199);
 
     DD_CallHooks(HOOK_INIT, 0, 0); // Any initialization hooks?
+    endStartupPhase("Subsystems");
     Con_SetProgress(200);
 
 #ifdef WIN32
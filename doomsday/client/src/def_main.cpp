@@ -25,6 +25,7 @@
 #include <ctype.h>
 
 #include <de/NativePath>
+#include <QHash>
 #include <QTextStream>
 
 #include "de_base.h"
@@ -88,6 +89,195 @@ ded_count_t countStatePtcGens;
 static boolean defsInited = false;
 static mobjinfo_t* gettingFor;
 
+/**
+ * Case-insensitive hash of definition identifiers to definition indices.
+ * Identifiers are compared like stricmp() does, i.e., with ASCII case folding.
+ * When the same identifier is inserted multiple times the first insertion wins.
+ */
+class DefIdIndex
+{
+public:
+    void clear()
+    {
+        _ids.clear();
+    }
+
+    void insert(char const *id, int idx)
+    {
+        if(!id || !id[0]) return;
+        QByteArray const key = foldCase(id);
+        if(!_ids.contains(key))
+        {
+            _ids.insert(key, idx);
+        }
+    }
+
+    /// @return  Index associated with @a id; otherwise @c -1.
+    int find(char const *id) const
+    {
+        if(!id || !id[0]) return -1;
+        return _ids.value(foldCase(id), -1);
+    }
+
+private:
+    static QByteArray foldCase(char const *id)
+    {
+        QByteArray key(id);
+        for(int i = 0; i < key.size(); ++i)
+        {
+            key[i] = tolower((unsigned char) key.at(i));
+        }
+        return key;
+    }
+
+    QHash<QByteArray, int> _ids;
+};
+
+/**
+ * Identifier indices for the definition databases. The index is built once all
+ * definitions have been read and patched (see Def_Read()); until then lookups
+ * fall back to searching the definition arrays linearly.
+ */
+static struct DefinitionIndex
+{
+    bool built;
+    DefIdIndex sprites;
+    DefIdIndex mobjs;
+    DefIdIndex mobjNames;  ///< Last definition wins.
+    DefIdIndex states;
+    DefIdIndex models;
+    DefIdIndex sounds;
+    DefIdIndex soundNames;
+    DefIdIndex music;
+    DefIdIndex values;     ///< Last definition wins.
+    DefIdIndex skies;      ///< Last definition wins.
+    DefIdIndex flags;      ///< Last definition wins.
+    DefIdIndex texts;
+    DefIdIndex lastTexts;  ///< Last definition wins.
+    DefIdIndex finales;    ///< Last definition wins.
+
+    /// Action links of the loaded game.
+    actionlink_t *actionLinks;
+    DefIdIndex actions;
+
+    void clear()
+    {
+        built = false;
+        sprites.clear();
+        mobjs.clear();
+        mobjNames.clear();
+        states.clear();
+        models.clear();
+        sounds.clear();
+        soundNames.clear();
+        music.clear();
+        values.clear();
+        skies.clear();
+        flags.clear();
+        texts.clear();
+        lastTexts.clear();
+        finales.clear();
+
+        actionLinks = 0;
+        actions.clear();
+    }
+} defIndex;
+
+static void indexMusic()
+{
+    defIndex.music.clear();
+    for(int i = 0; i < defs.count.music.num; ++i)
+    {
+        defIndex.music.insert(defs.music[i].id, i);
+    }
+}
+
+/**
+ * (Re)build the identifier index for the current definitions. Must be called
+ * again should the definition arrays be modified (other than via Def_Set()).
+ */
+static void buildDefinitionIndex()
+{
+    de::Time begunAt;
+
+    defIndex.clear();
+
+    for(int i = 0; i < countSprNames.num; ++i)
+    {
+        defIndex.sprites.insert(sprNames[i].name, i);
+    }
+    for(int i = 0; i < defs.count.mobjs.num; ++i)
+    {
+        defIndex.mobjs.insert(defs.mobjs[i].id, i);
+    }
+    for(int i = defs.count.mobjs.num - 1; i >= 0; --i)
+    {
+        defIndex.mobjNames.insert(defs.mobjs[i].name, i);
+    }
+    for(int i = 0; i < defs.count.states.num; ++i)
+    {
+        defIndex.states.insert(defs.states[i].id, i);
+    }
+    for(int i = 0; i < (int)defs.models.size(); ++i)
+    {
+        defIndex.models.insert(defs.models[i].id, i);
+    }
+    for(int i = 0; i < defs.count.sounds.num; ++i)
+    {
+        defIndex.sounds.insert(defs.sounds[i].id, i);
+        defIndex.soundNames.insert(defs.sounds[i].name, i);
+    }
+    indexMusic();
+    for(int i = defs.count.values.num - 1; i >= 0; --i)
+    {
+        defIndex.values.insert(defs.values[i].id, i);
+    }
+    for(int i = defs.count.skies.num - 1; i >= 0; --i)
+    {
+        defIndex.skies.insert(defs.skies[i].id, i);
+    }
+    for(int i = defs.count.flags.num - 1; i >= 0; --i)
+    {
+        defIndex.flags.insert(defs.flags[i].id, i);
+    }
+    for(int i = 0; i < defs.count.text.num; ++i)
+    {
+        defIndex.texts.insert(defs.text[i].id, i);
+    }
+    for(int i = defs.count.text.num - 1; i >= 0; --i)
+    {
+        defIndex.lastTexts.insert(defs.text[i].id, i);
+    }
+    for(int i = defs.count.finales.num - 1; i >= 0; --i)
+    {
+        defIndex.finales.insert(defs.finales[i].id, i);
+    }
+
+    defIndex.built = true;
+
+    LOG_DEBUG("Definition index built in %.2f seconds.") << begunAt.since();
+}
+
+/**
+ * Returns the identifier index of the loaded game's action links, or @c 0 if
+ * the definition index has not yet been built.
+ */
+static DefIdIndex const *actionIndex(actionlink_t *links)
+{
+    if(!defIndex.built || !links) return 0;
+
+    if(defIndex.actionLinks != links)
+    {
+        defIndex.actions.clear();
+        for(actionlink_t *linkIt = links; linkIt->name; linkIt++)
+        {
+            defIndex.actions.insert(linkIt->name, linkIt - links);
+        }
+        defIndex.actionLinks = links;
+    }
+    return &defIndex.actions;
+}
+
 xgclass_t nullXgClassLinks; // Used when none defined.
 xgclass_t* xgClassLinks;
 
@@ -167,6 +357,7 @@ void Def_Destroy(void)
     DED_DelArray((void**) &statePtcGens, &countStatePtcGens);
     DED_DelArray((void**) &stateLights, &countStateLights);
 
+    defIndex.clear();
     defsInited = false;
 }
 
@@ -181,6 +372,9 @@ int Def_GetSpriteNum(const char* name)
     if(!name || !name[0])
         return -1;
 
+    if(defIndex.built)
+        return defIndex.sprites.find(name);
+
     for(i = 0; i < countSprNames.num; ++i)
         if(!stricmp(sprNames[i].name, name))
             return i;
@@ -195,6 +389,9 @@ int Def_GetMobjNum(const char* id)
     if(!id || !id[0])
         return -1;
 
+    if(defIndex.built)
+        return defIndex.mobjs.find(id);
+
     for(i = 0; i < defs.count.mobjs.num; ++i)
         if(!stricmp(defs.mobjs[i].id, id))
             return i;
@@ -209,6 +406,9 @@ int Def_GetMobjNumForName(const char* name)
     if(!name || !name[0])
         return -1;
 
+    if(defIndex.built)
+        return defIndex.mobjNames.find(name);
+
     for(i = defs.count.mobjs.num -1; i >= 0; --i)
         if(!stricmp(defs.mobjs[i].name, name))
             return i;
@@ -225,6 +425,9 @@ const char* Def_GetMobjName(int num)
 
 int Def_GetStateNum(const char* id)
 {
+    if(defIndex.built)
+        return defIndex.states.find(id);
+
     int idx = -1;
     if(id && id[0] && defs.count.states.num)
     {
@@ -240,6 +443,9 @@ int Def_GetStateNum(const char* id)
 
 int Def_GetModelNum(const char* id)
 {
+    if(defIndex.built)
+        return defIndex.models.find(id);
+
     int idx = -1;
     if(id && id[0] && !defs.models.empty())
     {
@@ -255,6 +461,9 @@ int Def_GetModelNum(const char* id)
 
 int Def_GetSoundNum(const char* id)
 {
+    if(defIndex.built)
+        return defIndex.sounds.find(id);
+
     int idx = -1;
     if(id && id[0] && defs.count.sounds.num)
     {
@@ -279,6 +488,12 @@ int Def_GetSoundNumForName(const char* name)
     if(!name || !name[0])
         return -1;
 
+    if(defIndex.built)
+    {
+        i = defIndex.soundNames.find(name);
+        return (i >= 0? i : 0);
+    }
+
     for(i = 0; i < defs.count.sounds.num; ++i)
         if(!stricmp(defs.sounds[i].name, name))
             return i;
@@ -288,6 +503,9 @@ int Def_GetSoundNumForName(const char* name)
 
 int Def_GetMusicNum(const char* id)
 {
+    if(defIndex.built)
+        return defIndex.music.find(id);
+
     int idx = -1;
     if(id && id[0] && defs.count.music.num)
     {
@@ -309,8 +527,14 @@ acfnptr_t Def_GetActionPtr(const char* name)
     if(!App_GameLoaded()) return 0;
 
     // Action links are provided by the game, who owns the actual action functions.
-    for(linkIt = (actionlink_t*) gx.GetVariable(DD_ACTION_LINK);
-        linkIt && linkIt->name; linkIt++)
+    actionlink_t* links = (actionlink_t*) gx.GetVariable(DD_ACTION_LINK);
+    if(DefIdIndex const* index = actionIndex(links))
+    {
+        int const idx = index->find(name);
+        return (idx >= 0? links[idx].func : 0);
+    }
+
+    for(linkIt = links; linkIt && linkIt->name; linkIt++)
     {
         actionlink_t* link = linkIt;
         if(!stricmp(name, link->name))
@@ -325,6 +549,9 @@ int Def_GetActionNum(const char* name)
     {
         // Action links are provided by the game, who owns the actual action functions.
         actionlink_t* links = (actionlink_t*) gx.GetVariable(DD_ACTION_LINK);
+        if(DefIdIndex const* index = actionIndex(links))
+            return index->find(name);
+
         actionlink_t* linkIt;
         for(linkIt = links; linkIt && linkIt->name; linkIt++)
         {
@@ -340,6 +567,12 @@ ded_value_t* Def_GetValueById(char const* id)
 {
     if(!id || !id[0]) return NULL;
 
+    if(defIndex.built)
+    {
+        int const idx = defIndex.values.find(id);
+        return (idx >= 0? defs.values + idx : 0);
+    }
+
     // Read backwards to allow patching.
     for(int i = defs.count.values.num - 1; i >= 0; i--)
     {
@@ -375,6 +608,12 @@ ded_sky_t* Def_GetSky(char const* id)
 {
     if(!id || !id[0]) return NULL;
 
+    if(defIndex.built)
+    {
+        int const idx = defIndex.skies.find(id);
+        return (idx >= 0? defs.skies + idx : NULL);
+    }
+
     for(int i = defs.count.skies.num - 1; i >= 0; i--)
     {
         if(!stricmp(defs.skies[i].id, id))
@@ -594,6 +833,12 @@ ded_flag_t *Def_GetFlag(char const *flag)
         return 0;
     }
 
+    if(defIndex.built)
+    {
+        int const idx = defIndex.flags.find(flag);
+        return (idx >= 0? defs.flags + idx : 0);
+    }
+
     for(int i = defs.count.flags.num - 1; i >= 0; i--)
     {
         if(!stricmp(defs.flags[i].id, flag))
@@ -653,6 +898,9 @@ int Def_EvalFlags(char *ptr)
 
 int Def_GetTextNumForName(const char* name)
 {
+    if(defIndex.built)
+        return defIndex.texts.find(name);
+
     int idx = -1;
     if(name && name[0] && defs.count.text.num)
     {
@@ -1467,6 +1715,9 @@ void Def_Read()
         strcpy(sprNames[i].name, defs.sprites[i].id);
     }
 
+    // All definitions have now been read and patched; index them for lookup.
+    buildDefinitionIndex();
+
     // States.
     DED_NewEntries((void **) &states, &countStates, sizeof(*states), defs.count.states.num);
 
@@ -2216,6 +2467,12 @@ int Def_Get(int type, const char* id, void* out)
         return true; }
 
     case DD_DEF_TEXT:
+        if(id && id[0] && defIndex.built)
+        {
+            i = defIndex.lastTexts.find(id);
+            if(i >= 0 && out) *(char**) out = defs.text[i].text;
+            return i;
+        }
         if(id && id[0])
         {
             // Read backwards to allow patching.
@@ -2230,7 +2487,11 @@ int Def_Get(int type, const char* id, void* out)
 
     case DD_DEF_VALUE: {
         int idx = -1; // Not found.
-        if(id && id[0])
+        if(id && id[0] && defIndex.built)
+        {
+            idx = defIndex.values.find(id);
+        }
+        else if(id && id[0])
         {
             // Read backwards to allow patching.
             for(idx = defs.count.values.num - 1; idx >= 0; idx--)
@@ -2254,19 +2515,28 @@ int Def_Get(int type, const char* id, void* out)
 
     case DD_DEF_FINALE: { // Find InFine script by ID.
         finalescript_t* fin = (finalescript_t*) out;
-        for(i = defs.count.finales.num - 1; i >= 0; i--)
+        int idx = -1; // Not found.
+        if(defIndex.built)
         {
-            if(stricmp(defs.finales[i].id, id)) continue;
-
-            if(fin)
+            idx = defIndex.finales.find(id);
+        }
+        else
+        {
+            for(idx = defs.count.finales.num - 1; idx >= 0; idx--)
             {
-                fin->before = defs.finales[i].before;
-                fin->after  = defs.finales[i].after;
-                fin->script = defs.finales[i].script;
+                if(!stricmp(defs.finales[idx].id, id))
+                    break;
             }
-            return true;
         }
-        return false; }
+        if(idx < 0) return false;
+
+        if(fin)
+        {
+            fin->before = defs.finales[idx].before;
+            fin->after  = defs.finales[idx].after;
+            fin->script = defs.finales[idx].script;
+        }
+        return true; }
 
     case DD_DEF_FINALE_BEFORE: {
         finalescript_t *fin = (finalescript_t *) out;
@@ -2423,7 +2693,10 @@ int Def_Set(int type, int index, int value, const void* ptr)
         {
         case DD_ID:
             if(ptr)
+            {
                 strcpy(musdef->id, (char const*) ptr);
+                if(defIndex.built) indexMusic();
+            }
             break;
 
         case DD_LUMP:
@@ -33,6 +33,7 @@
 
 #include "filehandle.h"
 
+#include <QFile>
 #include <de/memory.h>
 #include <de/memoryblockset.h>
 #include <de/NativePath>
@@ -61,7 +62,14 @@ struct FileHandle::Instance
     uint8_t* data;
     uint8_t* pos;
 
-    Instance() : file(0), list(0), baseOffset(0), hndl(0), size(0), data(0), pos(0)
+    /// Memory-mapped view of a native file (see FileHandle::map()).
+    QFile* mapFile;
+    uint8_t* mapped;
+    size_t mappedSize;
+    bool mapFailed;
+
+    Instance() : file(0), list(0), baseOffset(0), hndl(0), size(0), data(0), pos(0),
+        mapFile(0), mapped(0), mappedSize(0), mapFailed(false)
     {
         flags.eof  = false;
         flags.open = false;
@@ -220,6 +228,13 @@ FileHandle::~FileHandle()
 FileHandle& FileHandle::close()
 {
     if(!d->flags.open) return *this;
+    if(d->mapFile)
+    {
+        if(d->mapped) d->mapFile->unmap(d->mapped);
+        delete d->mapFile; d->mapFile = 0;
+        d->mapped = 0;
+        d->mappedSize = 0;
+    }
     if(d->hndl)
     {
         fclose(d->hndl); d->hndl = 0;
@@ -401,6 +416,51 @@ de::FileHandle& FileHandle::rewind()
     return *this;
 }
 
+uint8_t const* FileHandle::map(size_t offset, size_t length)
+{
+    errorIfNotValid(*this, "FileHandle::map");
+    if(d->flags.reference)
+    {
+        return d->file->handle().map(offset, length);
+    }
+    if(!d->flags.open) return 0;
+
+    if(!d->hndl)
+    {
+        // Buffered; the contents are already in memory.
+        if(!d->data || offset > d->size || length > d->size - offset) return 0;
+        return d->data + offset;
+    }
+
+    if(!d->mapFile && !d->mapFailed)
+    {
+        LOG_AS("FileHandle::map");
+
+        // The mapping shares the already open native file handle.
+        d->mapFile = new QFile;
+        if(d->mapFile->open(d->hndl, QFile::ReadOnly, QFile::DontCloseHandle))
+        {
+            d->mappedSize = size_t(d->mapFile->size());
+            if(d->mappedSize)
+            {
+                d->mapped = d->mapFile->map(0, d->mapFile->size());
+            }
+        }
+        if(!d->mapped)
+        {
+            LOG_DEBUG("Failed to map file %p: %s") << dintptr(this) << d->mapFile->errorString();
+            delete d->mapFile; d->mapFile = 0;
+            d->mappedSize = 0;
+            d->mapFailed = true;
+        }
+    }
+    if(!d->mapped) return 0;
+
+    offset += d->baseOffset;
+    if(offset > d->mappedSize || length > d->mappedSize - offset) return 0;
+    return d->mapped + offset;
+}
+
 } // namespace de
 
 /**
@@ -24,12 +24,16 @@
 #include <ctime>
 
 #include <QDir>
+#include <QHash>
 #include <QList>
+#include <QScopedPointer>
+#include <QVector>
 #include <QtAlgorithms>
 
 #include <de/App>
 #include <de/Log>
 #include <de/NativePath>
+#include <de/TaskPool>
 #include <de/memory.h>
 
 #define DENG_NO_API_MACROS_FILESYS
@@ -45,6 +49,8 @@
 #include "filesys/fileinfo.h"
 #include "filesys/lumpindex.h"
 
+#include "resource/lumpcache.h"
+
 #include "resource/wad.h"
 #include "resource/zip.h"
 #include "Game"
@@ -55,9 +61,13 @@ D_CMD(Dir);
 D_CMD(DumpLump);
 D_CMD(ListFiles);
 D_CMD(ListLumps);
+D_CMD(BenchLumpIndex);
+D_CMD(LumpCacheStats);
 
 static FS1* fileSystem;
 
+byte fileMapLumps = 0;
+
 typedef QList<FileId> FileIds;
 
 /**
@@ -81,6 +91,13 @@ typedef QList<LumpMapping> LumpMappings;
 typedef QPair<QString, QString> PathMapping;
 typedef QList<PathMapping> PathMappings;
 
+/**
+ * Native file types recognised ahead of time (see FS1::recogniseFormats()),
+ * keyed by the expanded native path of the file. A @c 0 type means the file
+ * is not of any native file type.
+ */
+typedef QHash<QString, NativeFileType const *> RecognisedTypes;
+
 static bool applyPathMapping(ddstring_t* path, PathMapping const& vdm);
 
 struct FS1::Instance
@@ -116,6 +133,9 @@ struct FS1::Instance
     /// System subspace schemes containing subsets of the total files.
     Schemes schemes;
 
+    /// Formats of the native files about to be opened.
+    RecognisedTypes recognisedTypes;
+
     Instance(FS1* d) : self(*d),
         loadingForStartup(true),
         loadedFilesCRC(0),
@@ -338,6 +358,7 @@ struct FS1::Instance
 
         FileHandle* hndl = 0;
         FileInfo info; // The temporary info descriptor.
+        RecognisedTypes::iterator recognised = recognisedTypes.end();
 
         // First check for lumps?
         if(!reqNativeFile)
@@ -375,6 +396,9 @@ struct FS1::Instance
 
                 // Prepare the temporary info descriptor.
                 info = FileInfo(_api_F.GetLastModified(foundPath.toUtf8().constData()));
+
+                // Perhaps the format is already known?
+                recognised = recognisedTypes.find(foundPath);
             }
         }
 
@@ -385,7 +409,28 @@ struct FS1::Instance
         // been mapped to another location. We want the file to be attributed with
         // the path it is to be known by throughout the virtual file system.
 
-        File1& file = self.interpret(*hndl, path, info);
+        File1* interpreted = 0;
+        if(recognised != recognisedTypes.end())
+        {
+            NativeFileType const* fileType = recognised.value();
+            recognisedTypes.erase(recognised);
+
+            if(fileType)
+            {
+                interpreted = fileType->interpret(*hndl, path, info);
+            }
+            else
+            {
+                // Not of any native file type; use a generic file.
+                interpreted = new File1(*hndl, path, info);
+            }
+        }
+        // Not recognised in advance (or the file has changed since)?
+        if(!interpreted)
+        {
+            interpreted = &self.interpret(*hndl, path, info);
+        }
+        File1& file = *interpreted;
 
         if(loadingForStartup)
         {
@@ -431,6 +476,11 @@ void FS1::consoleRegister()
     C_CMD("dump", "s", DumpLump);
     C_CMD("listfiles", "", ListFiles);
     C_CMD("listlumps", "", ListLumps);
+    C_CMD("benchlumpindex", "i", BenchLumpIndex);
+    C_CMD("lumpcachestats", "", LumpCacheStats);
+
+    C_VAR_BYTE("file-map-lumps", &fileMapLumps, 0, 0, 1);
+    C_VAR_INT("file-cache-budget", &lumpCacheBudget, 0, 0, 65536);
 }
 
 /**
@@ -488,28 +538,33 @@ void FS1::index(de::File1& file)
     {
         if(!zip->empty())
         {
-            // Insert the lumps into their rightful places in the index.
+            LumpIndex::Lumps lumps;
+            lumps.reserve(zip->lumpCount());
             for(int i = 0; i < zip->lumpCount(); ++i)
             {
-                File1& lump = zip->lump(i);
+                lumps.push_back(&zip->lump(i));
+            }
 
-                d->primaryIndex.catalogLump(lump);
+            // Insert the lumps into their rightful places in the index.
+            d->primaryIndex.catalogLumps(lumps);
 
-                // Zip files go into a special ZipFile index as well.
-                d->zipFileIndex.catalogLump(lump);
-            }
+            // Zip files go into a special ZipFile index as well.
+            d->zipFileIndex.catalogLumps(lumps);
         }
     }
     else if(Wad* wad = dynamic_cast<Wad*>(&file))
     {
         if(!wad->empty())
         {
-            // Insert the lumps into their rightful places in the index.
+            LumpIndex::Lumps lumps;
+            lumps.reserve(wad->lumpCount());
             for(int i = 0; i < wad->lumpCount(); ++i)
             {
-                File1& lump = wad->lump(i);
-                d->primaryIndex.catalogLump(lump);
+                lumps.push_back(&wad->lump(i));
             }
+
+            // Insert the lumps into their rightful places in the index.
+            d->primaryIndex.catalogLumps(lumps);
         }
     }
 
@@ -738,6 +793,29 @@ lumpnum_t FS1::lumpNumForName(String name)
     return d->primaryIndex.lastIndexForPath(Path(name));
 }
 
+void FS1::prefetchLumps(QList<lumpnum_t> const& lumpNums)
+{
+    LOG_AS("FS1::prefetchLumps");
+
+    // Group the lumps by package.
+    QMap<Zip*, QList<int> > zipLumps;
+    DENG2_FOR_EACH_CONST(QList<lumpnum_t>, i, lumpNums)
+    {
+        if(!d->primaryIndex.isValidIndex(*i)) continue;
+
+        File1& lump = d->primaryIndex.lump(*i);
+        if(Zip* zip = dynamic_cast<Zip*>(&lump.container()))
+        {
+            zipLumps[zip].append(lump.info().lumpIdx);
+        }
+    }
+
+    for(QMap<Zip*, QList<int> >::iterator i = zipLumps.begin(); i != zipLumps.end(); ++i)
+    {
+        i.key()->prefetchLumps(i.value());
+    }
+}
+
 void FS1::releaseFile(de::File1& file)
 {
     for(int i = d->openFiles.size() - 1; i >= 0; i--)
@@ -957,6 +1035,82 @@ de::File1 &FS1::interpret(de::FileHandle &hndl, String filePath, FileInfo const
     return *interpretedFile;
 }
 
+namespace {
+
+/**
+ * Reads the headers of a set of native files, each on its own handle, and
+ * determines their native file type. The file types are only inspected.
+ */
+struct RecogniseWork : public TaskPool::IRangeWork
+{
+    QVector<NativePath> const &paths;
+    QVector<NativeFileType const *> const &guesses;
+    QVector<NativeFileType const *> types;
+    QVector<bool> opened;
+
+    RecogniseWork(QVector<NativePath> const &_paths, QVector<NativeFileType const *> const &_guesses)
+        : paths(_paths), guesses(_guesses), types(_paths.size()), opened(_paths.size())
+    {}
+
+    void processRange(int start, int end)
+    {
+        for(int i = start; i < end; ++i)
+        {
+            FILE* found = fopen(paths[i].toUtf8().constData(), "rb");
+            if(!found) continue;
+
+            opened[i] = true;
+
+            // The handle takes ownership of the native file.
+            QScopedPointer<FileHandle> hndl(FileHandleBuilder::fromNativeFile(*found, 0));
+            types[i] = recognise(*hndl, guesses[i]);
+        }
+    }
+
+    /// Tries the types in the same order as FS1::interpret().
+    static NativeFileType const* recognise(FileHandle& hndl, NativeFileType const* guess)
+    {
+        if(guess && guess->recognise(hndl)) return guess;
+
+        FileTypes const& fileTypes = DD_FileTypes();
+        DENG2_FOR_EACH_CONST(FileTypes, i, fileTypes)
+        {
+            NativeFileType const* fileType = dynamic_cast<NativeFileType const*>(*i);
+            if(!fileType || fileType == guess) continue;
+
+            if(fileType->recognise(hndl)) return fileType;
+        }
+        return 0;
+    }
+};
+
+} // namespace
+
+void FS1::recogniseFormats(QStringList const& paths)
+{
+    d->recognisedTypes.clear();
+
+    // Resolve the native paths the same way openFile() does.
+    QVector<NativePath> nativePaths;
+    QVector<NativeFileType const*> guesses;
+    foreach(QString const& path, paths)
+    {
+        if(path.isEmpty()) continue;
+
+        nativePaths.append(NativePath(NativePath::workPath().withSeparators('/') / (App_BasePath() / path)));
+        guesses.append(dynamic_cast<NativeFileType const*>(&DD_GuessFileTypeFromFileName(path)));
+    }
+
+    RecogniseWork work(nativePaths, guesses);
+    TaskPool::parallelFor(work, nativePaths.size());
+
+    for(int i = 0; i < nativePaths.size(); ++i)
+    {
+        if(!work.opened[i]) continue;
+        d->recognisedTypes.insert(nativePaths[i].expand().withSeparators('/'), work.types[i]);
+    }
+}
+
 de::FileHandle& FS1::openFile(String const& path, String const& mode, size_t baseOffset, bool allowDuplicate)
 {
 #if _DEBUG
@@ -1198,6 +1352,35 @@ D_CMD(ListLumps)
     return false;
 }
 
+D_CMD(BenchLumpIndex)
+{
+    DENG_UNUSED(src); DENG_UNUSED(argc);
+
+    int const numLumps = strtol(argv[1], 0, 0);
+    if(numLumps <= 0)
+    {
+        Con_Printf("Usage: %s (num-lumps)\n", argv[0]);
+        return false;
+    }
+
+    LumpIndex::benchmark(numLumps);
+    return true;
+}
+
+D_CMD(LumpCacheStats)
+{
+    DENG_UNUSED(src); DENG_UNUSED(argc); DENG_UNUSED(argv);
+
+    LumpCache::Stats const& stats = LumpCache::stats();
+
+    Con_Printf("Lump cache: %.1f MB (peak %.1f MB), budget: ", stats.bytes / 1048576.0, stats.peakBytes / 1048576.0);
+    if(lumpCacheBudget > 0) Con_Printf("%i MB\n", lumpCacheBudget);
+    else                    Con_Printf("unlimited\n");
+    Con_Printf("Lookups: %u hits, %u misses\n", stats.hits, stats.misses);
+    Con_Printf("Evicted: %u lumps (%.1f MB)\n", stats.evictions, stats.evictedBytes / 1048576.0);
+    return true;
+}
+
 /// List presently loaded files in original load order.
 D_CMD(ListFiles)
 {
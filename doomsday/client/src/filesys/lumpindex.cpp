@@ -36,6 +36,7 @@
 
 #include <de/Log>
 #include <de/NativePath>
+#include <de/Time>
 #include <de/mathutil.h>
 
 namespace de {
@@ -49,29 +50,94 @@ namespace de {
 #define LIF_NEED_PRUNE_DUPLICATES       0x40000000 ///< Path duplicate records must be pruned.
 ///@}
 
-/// Stores indexes into LumpIndex::Instance::records forming a chain of
-/// PathTree::Node fragment hashes. For ultra-fast name lookups.
-struct LumpIndexHashRecord
+/// A chain of lumps whose names hash to the same bucket. For ultra-fast
+/// name lookups.
+struct LumpIndexHashBucket
 {
-    lumpnum_t head, next;
+    lumpnum_t head; ///< Last lump in the chain.
+    lumpnum_t tail; ///< First lump in the chain.
 };
 
+/// Links a lump into the chain of its bucket.
+struct LumpIndexHashLink
+{
+    lumpnum_t next; ///< Earlier lump in the chain.
+    lumpnum_t prev; ///< Later lump in the chain.
+    uint hash;
+};
+
+/**
+ * Case-insensitive hash of a lump name. Unlike Path::Segment::hash(), this
+ * covers the full range of @c uint so that the chains stay short even when
+ * there are tens of thousands of lumps in the index.
+ */
+static uint nameHash(String const& name)
+{
+    uint hash = 2166136261u;
+    for(int i = 0; i < name.length(); ++i)
+    {
+        hash ^= name.at(i).toLower().unicode();
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 struct LumpIndex::Instance
 {
-    typedef QVector<LumpIndexHashRecord> HashMap;
+    typedef QVector<LumpIndexHashBucket> HashBuckets;
+    typedef QVector<LumpIndexHashLink> HashLinks;
 
     LumpIndex* self;
     int flags; /// @ref lumpIndexFlags
     LumpIndex::Lumps lumps;
-    HashMap* hashMap;
+
+    /// Number of buckets is a power of two.
+    HashBuckets buckets;
+
+    /// One for each lump.
+    HashLinks links;
 
     Instance(LumpIndex* d, int _flags)
-        : self(d), flags(_flags & ~LIF_INTERNAL_MASK), lumps(), hashMap(0)
+        : self(d), flags(_flags & ~LIF_INTERNAL_MASK), lumps()
     {}
 
-    ~Instance()
+    static uint lumpHash(File1 const& lump)
+    {
+        return nameHash(lump.directoryNode().name());
+    }
+
+    static bool isSamePath(File1 const& a, File1 const& b)
     {
-        if(hashMap) delete hashMap;
+        if(a.directoryNode().name().compare(b.directoryNode().name(), Qt::CaseInsensitive)) return false;
+        return !a.composePath().compare(b.composePath(), Qt::CaseInsensitive);
+    }
+
+    /**
+     * Determines which of two lumps with the same path is kept when duplicates
+     * are pruned: the one from the file loaded first; of lumps in the same
+     * file, the one cataloged last.
+     */
+    bool isPreferred(lumpnum_t a, lumpnum_t b) const
+    {
+        uint const orderA = lumps[a]->container().loadOrderIndex();
+        uint const orderB = lumps[b]->container().loadOrderIndex();
+        if(orderA != orderB) return orderA < orderB;
+        return a > b;
+    }
+
+    /// Prepends lump @a idx to the chain of its bucket. Lumps must be linked
+    /// in first-to-last order, so that the last lump appears first in the chain.
+    void linkLump(lumpnum_t idx, uint hash)
+    {
+        LumpIndexHashBucket& bucket = buckets[hash & (buckets.size() - 1)];
+        LumpIndexHashLink& link = links[idx];
+
+        link.hash = hash;
+        link.prev = -1;
+        link.next = bucket.head;
+        if(bucket.head >= 0) links[bucket.head].prev = idx;
+        else                 bucket.tail = idx;
+        bucket.head = idx;
     }
 
     void buildHashMap()
@@ -79,25 +145,18 @@ struct LumpIndex::Instance
         if(!(flags & LIF_NEED_REBUILD_HASH)) return;
 
         int const numElements = lumps.size();
-        if(!hashMap)    hashMap = new HashMap(numElements);
-        else            hashMap->resize(numElements);
 
-        // Clear the chains.
-        DENG2_FOR_EACH(HashMap, i, *hashMap)
-        {
-            i->head = -1;
-        }
+        // Leave room for lumps cataloged later (see appendLump()).
+        int numBuckets = 16;
+        while(numBuckets < numElements * 2) numBuckets <<= 1;
+
+        LumpIndexHashBucket const emptyBucket = { -1, -1 };
+        buckets.fill(emptyBucket, numBuckets);
+        links.resize(numElements);
 
-        // Prepend nodes to each chain, in first-to-last load order, so that
-        // the last lump with a given name appears first in the chain.
         for(int i = 0; i < numElements; ++i)
         {
-            File1 const& lump = *(lumps[i]);
-            PathTree::Node const& node = lump.directoryNode();
-            ushort j = node.hash() % (unsigned)numElements;
-
-            (*hashMap)[i].next = (*hashMap)[j].head; // Prepend to the chain.
-            (*hashMap)[j].head = i;
+            linkLump(i, lumpHash(*lumps[i]));
         }
 
         flags &= ~LIF_NEED_REBUILD_HASH;
@@ -105,6 +164,75 @@ struct LumpIndex::Instance
         LOG_DEBUG("Rebuilt hashMap for LumpIndex %p.") << self;
     }
 
+    /**
+     * Append @a lump to the index. While there is room in the hash map, the
+     * lump is linked into it directly, and duplicates need only be pruned if
+     * the lump's path is already present.
+     */
+    void appendLump(File1& lump)
+    {
+        lumpnum_t const idx = lumps.size();
+        lumps.push_back(&lump);
+
+        if((flags & LIF_NEED_REBUILD_HASH) || lumps.size() > buckets.size())
+        {
+            // We'll need to rebuild the name hash chains.
+            flags |= LIF_NEED_REBUILD_HASH;
+
+            if(flags & LIF_UNIQUE_PATHS)
+            {
+                // We may need to prune duplicate paths.
+                flags |= LIF_NEED_PRUNE_DUPLICATES;
+            }
+            return;
+        }
+
+        links.resize(lumps.size());
+        linkLump(idx, lumpHash(lump));
+
+        if((flags & LIF_UNIQUE_PATHS) && !(flags & LIF_NEED_PRUNE_DUPLICATES))
+        {
+            for(lumpnum_t k = links[idx].next; k >= 0; k = links[k].next)
+            {
+                if(links[k].hash != links[idx].hash) continue;
+                if(!isSamePath(lump, *lumps[k])) continue;
+
+                flags |= LIF_NEED_PRUNE_DUPLICATES;
+                break;
+            }
+        }
+    }
+
+    /**
+     * Find the last (or first) lump whose path matches @a path.
+     */
+    lumpnum_t findPath(Path const& path, bool firstMatch)
+    {
+        if(path.isEmpty() || lumps.empty()) return -1;
+
+        // We may need to prune path-duplicate lumps.
+        pruneDuplicates();
+
+        // We may need to rebuild the path hash map.
+        buildHashMap();
+
+        uint const hash = nameHash(path.lastSegment());
+        LumpIndexHashBucket const& bucket = buckets[hash & (buckets.size() - 1)];
+
+        for(lumpnum_t idx = firstMatch? bucket.tail : bucket.head; idx >= 0;
+            idx = firstMatch? links[idx].prev : links[idx].next)
+        {
+            if(links[idx].hash != hash) continue;
+
+            PathTree::Node const& node = lumps[idx]->directoryNode();
+            if(node.comparePath(path, 0)) continue;
+
+            // This is the lump we are looking for.
+            return idx;
+        }
+        return -1;
+    }
+
     /**
      * @param pruneFlags  Passed by reference to avoid deep copy on value-write.
      * @param file        Flag only those lumps contained by this file.
@@ -127,28 +255,6 @@ struct LumpIndex::Instance
         return numFlagged;
     }
 
-    struct LumpSortInfo
-    {
-        File1 const* lump;
-        String* path;
-        int origIndex;
-    };
-    static int lumpSorter(void const* a, void const* b)
-    {
-        LumpSortInfo const* infoA = (LumpSortInfo const*)a;
-        LumpSortInfo const* infoB = (LumpSortInfo const*)b;
-        int result = infoA->path->compare(infoB->path, Qt::CaseInsensitive);
-        if(0 != result) return result;
-
-        // Still matched; try the file load order indexes.
-        result = (infoA->lump->container().loadOrderIndex() -
-                  infoB->lump->container().loadOrderIndex());
-        if(0 != result) return result;
-
-        // Still matched (i.e., present in the same package); use the original indexes.
-        return (infoB->origIndex - infoA->origIndex);
-    }
-
     /**
      * @param pruneFlags  Passed by reference to avoid deep copy on value-write.
      * @return Number of lumps newly flagged during this op.
@@ -164,36 +270,34 @@ struct LumpIndex::Instance
         int const numRecords = lumps.size();
         if(numRecords <= 1) return 0;
 
-        // Sort in descending load order for pruning.
-        LumpSortInfo* sortInfos = new LumpSortInfo[numRecords];
-        for(int i = 0; i < numRecords; ++i)
-        {
-            LumpSortInfo& sortInfo   = sortInfos[i];
-            File1 const* lump = lumps[i];
+        // Lumps with the same path are in the same chain.
+        buildHashMap();
 
-            sortInfo.lump = lump;
-            sortInfo.origIndex = i;
-            sortInfo.path = new String(lump->composePath());
-        }
-        qsort(sortInfos, numRecords, sizeof(*sortInfos), lumpSorter);
-
-        // Flag the lumps we'll be pruning.
+        // Compare each lump with the earlier lumps in its chain. Of any two
+        // with the same path one is flagged, so only the preferred remains.
         int numFlagged = 0;
         for(int i = 1; i < numRecords; ++i)
         {
             if(pruneFlags.testBit(i)) continue;
-            if(sortInfos[i - 1].path->compare(sortInfos[i].path, Qt::CaseInsensitive)) continue;
-            pruneFlags.setBit(sortInfos[i].origIndex, true);
-            numFlagged += 1;
-        }
 
-        // Free temporary sort data.
-        for(int i = 0; i < numRecords; ++i)
-        {
-            LumpSortInfo& sortInfo = sortInfos[i];
-            delete sortInfo.path;
+            for(lumpnum_t k = links[i].next; k >= 0; k = links[k].next)
+            {
+                if(pruneFlags.testBit(k)) continue;
+                if(links[k].hash != links[i].hash) continue;
+                if(!isSamePath(*lumps[i], *lumps[k])) continue;
+
+                numFlagged += 1;
+                if(isPreferred(i, k))
+                {
+                    pruneFlags.setBit(k, true);
+                }
+                else
+                {
+                    pruneFlags.setBit(i, true);
+                    break;
+                }
+            }
         }
-        delete[] sortInfos;
 
         return numFlagged;
     }
@@ -340,22 +444,32 @@ bool LumpIndex::pruneLump(File1& lump)
 
 void LumpIndex::catalogLump(File1& lump)
 {
-    d->lumps.push_back(&lump);
+    d->appendLump(lump);
+}
+
+void LumpIndex::catalogLumps(Lumps const& lumps)
+{
+    if(lumps.isEmpty()) return;
 
-    // We'll need to rebuild the name hash chains.
-    d->flags |= LIF_NEED_REBUILD_HASH;
+    d->lumps.reserve(d->lumps.size() + lumps.size());
 
-    if(d->flags & LIF_UNIQUE_PATHS)
+    // Rather than outgrow the hash map part way through, rebuild it once.
+    if(d->lumps.size() + lumps.size() > d->buckets.size())
     {
-        // We may need to prune duplicate paths.
-        d->flags |= LIF_NEED_PRUNE_DUPLICATES;
+        d->flags |= LIF_NEED_REBUILD_HASH;
+    }
+
+    DENG2_FOR_EACH_CONST(Lumps, i, lumps)
+    {
+        d->appendLump(**i);
     }
 }
 
 void LumpIndex::clear()
 {
     d->lumps.clear();
-    d->flags &= ~(LIF_NEED_REBUILD_HASH | LIF_NEED_PRUNE_DUPLICATES);
+    d->flags &= ~LIF_NEED_PRUNE_DUPLICATES;
+    d->flags |= LIF_NEED_REBUILD_HASH;
 }
 
 bool LumpIndex::catalogues(File1& file)
@@ -373,57 +487,12 @@ bool LumpIndex::catalogues(File1& file)
 
 lumpnum_t LumpIndex::lastIndexForPath(Path const& path) const
 {
-    if(path.isEmpty() || d->lumps.empty()) return -1;
-
-    // We may need to prune path-duplicate lumps.
-    d->pruneDuplicates();
-
-    // We may need to rebuild the path hash map.
-    d->buildHashMap();
-    DENG_ASSERT(d->hashMap);
-
-    // Perform the search.
-    ushort hash = path.lastSegment().hash() % d->hashMap->size();
-    if((*d->hashMap)[hash].head == -1) return -1;
-
-    for(int idx = (*d->hashMap)[hash].head; idx != -1; idx = (*d->hashMap)[idx].next)
-    {
-        File1 const& lump = *d->lumps[idx];
-        PathTree::Node const& node = lump.directoryNode();
-
-        if(node.comparePath(path, 0)) continue;
-
-        // This is the lump we are looking for.
-        return idx;
-    }
-
-    return -1;
+    return d->findPath(path, false /*last match*/);
 }
 
-/// @todo Make use of the hash!
 lumpnum_t LumpIndex::firstIndexForPath(Path const &path) const
 {
-    if(path.isEmpty() || d->lumps.empty()) return -1;
-
-    // We may need to prune path-duplicate lumps.
-    d->pruneDuplicates();
-
-    // We may need to rebuild the path hash map.
-    d->buildHashMap();
-    DENG_ASSERT(d->hashMap);
-
-    // Perform the search.
-    for(lumpnum_t idx = 0; idx < d->lumps.size(); ++idx)
-    {
-        File1 const& lump = *d->lumps[idx];
-        PathTree::Node const& node = lump.directoryNode();
-
-        if(node.comparePath(path, 0)) continue;
-
-        // This is the lump we are looking for.
-        return idx;
-    }
-    return -1;
+    return d->findPath(path, true /*first match*/);
 }
 
 void LumpIndex::print(LumpIndex const& index)
@@ -448,4 +517,75 @@ void LumpIndex::print(LumpIndex const& index)
     Con_Printf("---End of lumps---\n");
 }
 
+namespace internal {
+
+/// Lump in the synthetic index of LumpIndex::benchmark().
+class SyntheticLump : public File1
+{
+public:
+    SyntheticLump(FileHandle& hndl, String path, PathTree::Node& node, File1& container)
+        : File1(hndl, path, FileInfo(), &container), node_(node)
+    {}
+
+    PathTree::Node const& directoryNode() const { return node_; }
+
+private:
+    PathTree::Node& node_;
+};
+
+} // namespace internal
+
+void LumpIndex::benchmark(int numLumps)
+{
+    LOG_AS("LumpIndex::benchmark");
+
+    // The synthetic container is backed by an empty temporary file; the
+    // lumps only refer to it and are never read.
+    FILE* nativeFile = tmpfile();
+    if(!nativeFile)
+    {
+        LOG_WARNING("Failed to create a temporary file for the synthetic container.");
+        return;
+    }
+    File1 container(*FileHandleBuilder::fromNativeFile(*nativeFile, 0), "synthetic.wad", FileInfo());
+    PathTree directory(PathTree::MultiLeaf);
+
+    // Every tenth lump repeats the name of an earlier one (like map data lumps).
+    Lumps synthetic;
+    for(int i = 0; i < numLumps; ++i)
+    {
+        String const path = String("LUMP%1.lmp").arg(i % 10? i : i / 10, 6, 10, QChar('0'));
+        synthetic.push_back(new internal::SyntheticLump(*FileHandleBuilder::fromFile(container), path,
+                                                        directory.insert(Path(path)), container));
+    }
+
+    Time startedAt;
+    LumpIndex index;
+    index.catalogLumps(synthetic);
+    index.lastIndexForPath(Path("LUMP000000.lmp")); // Builds the hash map.
+    TimeDelta const buildTime = startedAt.since();
+
+    startedAt = Time();
+    int found = 0;
+    for(int i = 0; i < numLumps; ++i)
+    {
+        Path const path(String("LUMP%1.lmp").arg(i, 6, 10, QChar('0')));
+        if(index.lastIndexForPath(path) >= 0)  found++;
+        if(index.firstIndexForPath(path) >= 0) found++;
+    }
+    TimeDelta const searchTime = startedAt.since();
+
+    startedAt = Time();
+    LumpIndex uniqueIndex(LIF_UNIQUE_PATHS);
+    uniqueIndex.catalogLumps(synthetic);
+    int const uniqueSize = uniqueIndex.size(); // Prunes the duplicates.
+    TimeDelta const pruneTime = startedAt.since();
+
+    LOG_INFO("%i lumps indexed in %.2f ms") << numLumps << buildTime * 1000;
+    LOG_INFO("%i searches (%i found) in %.2f ms") << numLumps * 2 << found << searchTime * 1000;
+    LOG_INFO("%i unique paths pruned in %.2f ms") << uniqueSize << pruneTime * 1000;
+
+    qDeleteAll(synthetic);
+}
+
 } // namespace de
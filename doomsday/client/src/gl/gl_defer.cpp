@@ -440,6 +440,17 @@ void GL_DeferTextureUpload(struct texturecontent_s const *content)
     enqueueTask(DTT_UPLOAD_TEXTURECONTENT, GL_ConstructTextureContentCopy(content));
 }
 
+void GL_DeferTextureContentUpload(struct texturecontent_s *content)
+{
+    if(novideo)
+    {
+        GL_DestroyTextureContent(content);
+        return;
+    }
+
+    enqueueTask(DTT_UPLOAD_TEXTURECONTENT, content);
+}
+
 void GL_DeferSetVSync(boolean enableVSync)
 {
     enqueueTask(DTT_SET_VSYNC, M_MemDup(&enableVSync, sizeof(enableVSync)));
@@ -0,0 +1,617 @@
+/** @file gl_resample.cpp Image resampling and mipmap reduction.
+ *
+ * @authors Copyright © 2003-2013 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2005-2013 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include <cstring>
+
+#include <de/libdeng1.h>
+#include <de/fixedpoint.h>
+#include <de/memory.h>
+#include <de/math.h>
+#include <de/TaskPool>
+
+#include "gl/gl_resample.h"
+
+/// Minimum number of output pixels processed by one thread.
+#define MIN_PIXELS_PER_BAND     (16384)
+
+/**
+ * Len is measured in out units. Comps is the number of components per
+ * pixel, or rather the number of bytes per pixel (3 or 4). The strides must
+ * be byte-aligned anyway, though; not in pixels.
+ *
+ * @todo Probably could be optimized.
+ */
+static void scaleLine(const uint8_t* in, int inStride, uint8_t* out, int outStride,
+    int outLen, int inLen, int comps)
+{
+    float inToOutScale = outLen / (float) inLen;
+    int i, c;
+
+    if(inToOutScale > 1)
+    {
+        // Magnification is done using linear interpolation.
+        fixed_t inPosDelta = (FRACUNIT * (inLen - 1)) / (outLen - 1);
+        fixed_t inPos = inPosDelta;
+        const uint8_t* col1, *col2;
+        int weight, invWeight;
+
+        // The first pixel.
+        memcpy(out, in, comps);
+        out += outStride;
+
+        // Step at each out pixel between the first and last ones.
+        for(i = 1; i < outLen - 1; ++i, out += outStride, inPos += inPosDelta)
+        {
+            col1 = in + (inPos >> FRACBITS) * inStride;
+            col2 = col1 + inStride;
+            weight = inPos & 0xffff;
+            invWeight = 0x10000 - weight;
+
+            for(c = 0; c < comps; ++c)
+                out[c] = (uint8_t)((col1[c] * invWeight + col2[c] * weight) >> 16);
+        }
+
+        // The last pixel.
+        memcpy(out, in + (inLen - 1) * inStride, comps);
+        return;
+    }
+
+    if(inToOutScale < 1)
+    {
+        // Minification needs to calculate the average of each of
+        // the pixels contained by the out pixel.
+        uint cumul[4] = { 0, 0, 0, 0 }, count = 0;
+        int outpos = 0;
+
+        for(i = 0; i < inLen; ++i, in += inStride)
+        {
+            if((int) (i * inToOutScale) != outpos)
+            {
+                outpos = (int) (i * inToOutScale);
+
+                for(c = 0; c < comps; ++c)
+                {
+                    out[c] = (uint8_t)(cumul[c] / count);
+                    cumul[c] = 0;
+                }
+                count = 0;
+                out += outStride;
+            }
+            for(c = 0; c < comps; ++c)
+                cumul[c] += in[c];
+            count++;
+        }
+        // Fill in the last pixel, too.
+        if(count)
+            for(c = 0; c < comps; ++c)
+                out[c] = (uint8_t)(cumul[c] / count);
+        return;
+    }
+
+    // No need for scaling.
+    for(i = outLen; i > 0; i--, out += outStride, in += inStride)
+    {
+        for(c = 0; c < comps; ++c)
+            out[c] = in[c];
+    }
+}
+
+/**
+ * Scales a band of rows vertically. The result is the same as if each byte
+ * column of the band was scaled with scaleLine(), but the rows are processed
+ * in memory order.
+ *
+ * @param stride  Bytes per row (in and out).
+ * @param len     Width of the band in bytes.
+ */
+static void scaleRows(const uint8_t* in, uint8_t* out, int stride, int len,
+    int outLen, int inLen)
+{
+    float inToOutScale = outLen / (float) inLen;
+    int i, c;
+
+    if(inToOutScale > 1)
+    {
+        // Magnification is done using linear interpolation.
+        fixed_t inPosDelta = (FRACUNIT * (inLen - 1)) / (outLen - 1);
+        fixed_t inPos = inPosDelta;
+
+        // The first row.
+        memcpy(out, in, len);
+        out += stride;
+
+        // Step at each out row between the first and last ones.
+        for(i = 1; i < outLen - 1; ++i, out += stride, inPos += inPosDelta)
+        {
+            const uint8_t* row1 = in + (inPos >> FRACBITS) * stride;
+            const uint8_t* row2 = row1 + stride;
+            int weight = inPos & 0xffff;
+            int invWeight = 0x10000 - weight;
+
+            if(!weight)
+            {
+                memcpy(out, row1, len);
+                continue;
+            }
+
+            for(c = 0; c < len; ++c)
+                out[c] = (uint8_t)((row1[c] * invWeight + row2[c] * weight) >> 16);
+        }
+
+        // The last row.
+        memcpy(out, in + (inLen - 1) * stride, len);
+        return;
+    }
+
+    if(inToOutScale < 1)
+    {
+        // Minification needs to calculate the average of each of
+        // the rows contained by the out row.
+        uint* cumul = (uint*) M_Calloc(sizeof(*cumul) * len);
+        uint count = 0;
+        int outpos = 0;
+
+        for(i = 0; i < inLen; ++i, in += stride)
+        {
+            if((int) (i * inToOutScale) != outpos)
+            {
+                outpos = (int) (i * inToOutScale);
+
+                for(c = 0; c < len; ++c)
+                {
+                    out[c] = (uint8_t)(cumul[c] / count);
+                    cumul[c] = 0;
+                }
+                count = 0;
+                out += stride;
+            }
+            for(c = 0; c < len; ++c)
+                cumul[c] += in[c];
+            count++;
+        }
+        // Fill in the last row, too.
+        if(count)
+            for(c = 0; c < len; ++c)
+                out[c] = (uint8_t)(cumul[c] / count);
+
+        M_Free(cumul);
+        return;
+    }
+
+    // No need for scaling.
+    for(i = outLen; i > 0; i--, out += stride, in += stride)
+    {
+        memcpy(out, in, len);
+    }
+}
+
+/// Scales the rows of an image horizontally (a range of rows at a time).
+struct ScaleHorizontalWork : public de::TaskPool::IRangeWork
+{
+    const uint8_t* in;
+    uint8_t* out;
+    int width, outWidth, comps;
+
+    void processRange(int begin, int end)
+    {
+        for(int i = begin; i < end; ++i)
+        {
+            scaleLine(in + i * width * comps, comps, out + i * outWidth * comps, comps,
+                      outWidth, width, comps);
+        }
+    }
+};
+
+/// Scales the columns of an image vertically (a range of bytes of each row at a time).
+struct ScaleVerticalWork : public de::TaskPool::IRangeWork
+{
+    const uint8_t* in;
+    uint8_t* out;
+    int stride, height, outHeight;
+
+    void processRange(int begin, int end)
+    {
+        scaleRows(in + begin, out + begin, stride, end - begin, outHeight, height);
+    }
+};
+
+uint8_t* GL_ScaleBuffer(const uint8_t* in, int width, int height, int comps,
+    int outWidth, int outHeight)
+{
+    DENG_ASSERT(in);
+    {
+    uint8_t* buffer, *out;
+
+    if(width <= 0 || height <= 0)
+        return (uint8_t*)in;
+
+    out = (uint8_t*) M_Malloc(comps * outWidth * outHeight);
+
+    buffer = (uint8_t*) M_Malloc(comps * outWidth * height);
+
+    // First scale horizontally, to outWidth, into the temporary buffer.
+    ScaleHorizontalWork horizontal;
+    horizontal.in       = in;
+    horizontal.out      = buffer;
+    horizontal.width    = width;
+    horizontal.outWidth = outWidth;
+    horizontal.comps    = comps;
+    de::TaskPool::parallelFor(horizontal, height,
+                              de::max(1, MIN_PIXELS_PER_BAND / outWidth));
+
+    // Then scale vertically, to outHeight, into the out buffer.
+    ScaleVerticalWork vertical;
+    vertical.in        = buffer;
+    vertical.out       = out;
+    vertical.stride    = outWidth * comps;
+    vertical.height    = height;
+    vertical.outHeight = outHeight;
+    de::TaskPool::parallelFor(vertical, outWidth * comps,
+                              de::max(64, comps * MIN_PIXELS_PER_BAND / outHeight));
+
+    M_Free(buffer);
+    return out;
+    }
+}
+
+/**
+ * Scales rows of an image of unsigned bytes. Magnification uses a weighted
+ * sample of 4 pixels, shrinking an unweighted box filter. The samples are
+ * converted to floating point as they are read; each result is rounded to
+ * float before it is truncated to a byte.
+ */
+struct ScaleImageWork : public de::TaskPool::IRangeWork
+{
+    struct Column {
+        int j0, j1;
+        float beta;
+    };
+
+    const uint8_t* dataIn;
+    uint8_t* dataOut;
+    int rowStrideIn, rowStrideOut;
+    int heightIn, widthOut, bpp;
+    float sy;
+    bool magnify;
+    const Column* cols;
+
+    void processRange(int begin, int end)
+    {
+        if(magnify)
+            magnifyRows(begin, end);
+        else
+            shrinkRows(begin, end);
+    }
+
+    void magnifyRows(int begin, int end)
+    {
+        int i, j, k, i0, i1;
+        float alpha, s1, s2;
+        const uint8_t* src00, *src01, *src10, *src11;
+        uint8_t* dst;
+
+        for(i = begin; i < end; ++i)
+        {
+            i0 = i * sy;
+            i1 = i0 + 1;
+            if(i1 >= heightIn)
+                i1 = heightIn - 1;
+            alpha = i * sy - i0;
+
+            const uint8_t* row0 = dataIn + i0 * rowStrideIn;
+            const uint8_t* row1 = dataIn + i1 * rowStrideIn;
+            dst = dataOut + i * rowStrideOut;
+
+            for(j = 0; j < widthOut; ++j)
+            {
+                const Column& col = cols[j];
+                const float beta = col.beta;
+
+                // Compute weighted average of pixels in rect (i0,j0)-(i1,j1)
+                src00 = row0 + col.j0 * bpp;
+                src01 = row0 + col.j1 * bpp;
+                src10 = row1 + col.j0 * bpp;
+                src11 = row1 + col.j1 * bpp;
+
+                for(k = 0; k < bpp; ++k)
+                {
+                    s1 = (float) *src00++ * (1.0 - beta) + (float) *src01++ * beta;
+                    s2 = (float) *src10++ * (1.0 - beta) + (float) *src11++ * beta;
+                    *dst++ = (uint8_t) (float) (s1 * (1.0 - alpha) + s2 * alpha);
+                }
+            }
+        }
+    }
+
+    void shrinkRows(int begin, int end)
+    {
+        int i, j, k, i0, i1, ii, jj;
+        float sum;
+        uint8_t* dst;
+
+        for(i = begin; i < end; ++i)
+        {
+            i0 = i * sy;
+            i1 = i0 + 1;
+            if(i1 >= heightIn)
+                i1 = heightIn - 1;
+
+            dst = dataOut + i * rowStrideOut;
+
+            for(j = 0; j < widthOut; ++j)
+            {
+                const Column& col = cols[j];
+                const int area = (col.j1 - col.j0 + 1) * (i1 - i0 + 1);
+
+                // Compute average of pixels in the rectangle (i0,j0)-(i1,j1)
+                for(k = 0; k < bpp; ++k)
+                {
+                    sum = 0.0;
+                    for(ii = i0; ii <= i1; ++ii)
+                    {
+                        const uint8_t* src = dataIn + ii * rowStrideIn + col.j0 * bpp + k;
+                        for(jj = col.j0; jj <= col.j1; ++jj, src += bpp)
+                        {
+                            sum += (float) *src;
+                        }
+                    }
+                    sum /= area;
+                    *dst++ = (uint8_t) sum;
+                }
+            }
+        }
+    }
+};
+
+/**
+ * Determines the number of bytes between the starts of rows of a pixel
+ * store (of unsigned bytes).
+ */
+static int rowStrideForStore(int bpp, int width, int rowLength, int alignment)
+{
+    const int rowLen = (rowLength > 0? rowLength : width);
+
+    if((int) sizeof(uint8_t) >= alignment)
+        return bpp * rowLen;
+
+    return alignment / sizeof(uint8_t) * CEILING(bpp * rowLen * (int) sizeof(uint8_t), alignment);
+}
+
+/**
+ * Originally from the Mesa 3-D graphics library version 3.4
+ * @note License: GNU Library General Public License (or later)
+ * Copyright (C) 1995-2000  Brian Paul.
+ *
+ * Both the input and the output are GL_UNSIGNED_BYTE, so the pixels are read
+ * and written directly rather than via intermediate floating point images.
+ */
+void* GL_ScaleBufferEx(const void* dataIn, int widthIn, int heightIn, int bpp,
+    /*GLint typeIn,*/ int unpackRowLength, int unpackAlignment, int unpackSkipRows,
+    int unpackSkipPixels, int widthOut, int heightOut, /*GLint typeOut, */
+    int packRowLength, int packAlignment, int packSkipRows, int packSkipPixels)
+{
+    const int rowStrideIn  = rowStrideForStore(bpp, widthIn,  unpackRowLength, unpackAlignment);
+    const int rowStrideOut = rowStrideForStore(bpp, widthOut, packRowLength,   packAlignment);
+    float sx, sy;
+    void* dataOut;
+    int j;
+
+    dataOut = M_Malloc(bpp * widthOut * heightOut);
+
+    /**
+     * Scale the image!
+     */
+
+    if(widthOut > 1)
+        sx = (float) (widthIn - 1) / (float) (widthOut - 1);
+    else
+        sx = (float) (widthIn - 1);
+    if(heightOut > 1)
+        sy = (float) (heightIn - 1) / (float) (heightOut - 1);
+    else
+        sy = (float) (heightIn - 1);
+
+    ScaleImageWork work;
+    work.dataIn       = (const uint8_t*) dataIn
+                      + unpackSkipRows * rowStrideIn + unpackSkipPixels * bpp;
+    work.dataOut      = (uint8_t*) dataOut
+                      + packSkipRows * rowStrideOut + packSkipPixels * bpp;
+    work.rowStrideIn  = rowStrideIn;
+    work.rowStrideOut = rowStrideOut;
+    work.heightIn     = heightIn;
+    work.widthOut     = widthOut;
+    work.bpp          = bpp;
+    work.sy           = sy;
+    work.magnify      = (sx < 1.0 && sy < 1.0);
+
+    // The source columns of each output column are the same on every row.
+    ScaleImageWork::Column* cols = (ScaleImageWork::Column*) M_Malloc(sizeof(*cols) * widthOut);
+    for(j = 0; j < widthOut; ++j)
+    {
+        ScaleImageWork::Column& col = cols[j];
+        col.j0 = j * sx;
+        col.j1 = col.j0 + 1;
+        if(col.j1 >= widthIn)
+            col.j1 = widthIn - 1;
+        col.beta = j * sx - col.j0;
+    }
+    work.cols = cols;
+
+    de::TaskPool::parallelFor(work, heightOut, de::max(1, MIN_PIXELS_PER_BAND / widthOut));
+
+    M_Free(cols);
+    return dataOut;
+}
+
+uint8_t* GL_ScaleBufferNearest(const uint8_t* in, int width, int height, int comps,
+    int outWidth, int outHeight)
+{
+    DENG_ASSERT(in);
+    {
+    int ratioX, ratioY, shearY;
+    uint8_t* out, *outP;
+
+    if(width <= 0 || height <= 0)
+        return (uint8_t*)in;
+
+    ratioX = (int)(width  << 16) / outWidth  + 1;
+    ratioY = (int)(height << 16) / outHeight + 1;
+
+    out = (uint8_t *) M_Malloc(comps * outWidth * outHeight);
+
+    outP = out;
+    shearY = 0;
+    { int i;
+    for(i = 0; i < outHeight; ++i, shearY += ratioY)
+    {
+        int shearX = 0;
+        int shearY2 = (shearY >> 16) * width;
+        { int j;
+        for(j = 0; j < outWidth; ++j, outP += comps, shearX += ratioX)
+        {
+            int c, n = (shearY2 + (shearX >> 16)) * comps;
+            for(c = 0; c < comps; ++c, n++)
+                outP[c] = in[n];
+        }}
+    }}
+    return out;
+    }
+}
+
+/**
+ * Averages the components of two/four ABGR8888 pixels. The components are
+ * processed two at a time, each in a 16-bit lane of a 32-bit integer.
+ */
+static inline uint32_t average2(uint32_t a, uint32_t b)
+{
+    uint32_t const rb = ((a & 0x00FF00FF) + (b & 0x00FF00FF)) >> 1;
+    uint32_t const ag = (((a >> 8) & 0x00FF00FF) + ((b >> 8) & 0x00FF00FF)) >> 1;
+    return (rb & 0x00FF00FF) | ((ag & 0x00FF00FF) << 8);
+}
+
+static inline uint32_t average4(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+{
+    uint32_t const rb = ((a & 0x00FF00FF) + (b & 0x00FF00FF) +
+                         (c & 0x00FF00FF) + (d & 0x00FF00FF)) >> 2;
+    uint32_t const ag = (((a >> 8) & 0x00FF00FF) + ((b >> 8) & 0x00FF00FF) +
+                         ((c >> 8) & 0x00FF00FF) + ((d >> 8) & 0x00FF00FF)) >> 2;
+    return (rb & 0x00FF00FF) | ((ag & 0x00FF00FF) << 8);
+}
+
+void GL_DownMipmap32(uint8_t* in, int width, int height, int comps)
+{
+    DENG_ASSERT(in);
+    {
+    int x, y, c, outW = width >> 1, outH = height >> 1;
+    uint8_t* out;
+
+    if(width <= 0 || height <= 0 || comps <= 0)
+        return;
+
+    if(width == 1 && height == 1)
+    {
+        DENG_ASSERT(!"GL_DownMipmap32: Can't be called for a 1x1 image");
+        return;
+    }
+
+    if(comps == 4)
+    {
+        // Whole pixels at a time. Each output pixel is written after its
+        // inputs have been read, so working in place is fine.
+        uint32_t* pixIn = (uint32_t*) in, *pixOut = (uint32_t*) in;
+
+        if(!outW || !outH)
+        {
+            int outDim = (width > 1 ? outW : outH);
+            for(x = 0; x < outDim; ++x, pixIn += 2)
+                *pixOut++ = average2(pixIn[0], pixIn[1]);
+            return;
+        }
+
+        for(y = 0; y < outH; ++y, pixIn += width)
+            for(x = 0; x < outW; ++x, pixIn += 2)
+                *pixOut++ = average4(pixIn[0], pixIn[1], pixIn[width], pixIn[width + 1]);
+        return;
+    }
+
+    // Limited, 1x2|2x1 -> 1x1 reduction?
+    if(!outW || !outH)
+    {
+        int outDim = (width > 1 ? outW : outH);
+
+        out = in;
+        for(x = 0; x < outDim; ++x, in += comps * 2)
+            for(c = 0; c < comps; ++c, out++)
+                *out = (uint8_t)((in[c] + in[comps + c]) >> 1);
+        return;
+    }
+
+    // Unconstrained, 2x2 -> 1x1 reduction?
+    out = in;
+    for(y = 0; y < outH; ++y, in += width * comps)
+        for(x = 0; x < outW; ++x, in += comps * 2)
+            for(c = 0; c < comps; ++c, out++)
+                *out = (uint8_t)((in[c] + in[comps + c] + in[comps * width + c] +
+                              in[comps * (width + 1) + c]) >> 2);
+    }
+}
+
+void GL_DownMipmap8(uint8_t* in, uint8_t* fadedOut, int width, int height, float fade)
+{
+    int x, y, outW = width / 2, outH = height / 2;
+    float invFade;
+    byte* out = in;
+    byte fadeTable[256];
+
+    if(fade > 1)
+        fade = 1;
+    invFade = 1 - fade;
+
+    // The faded value only depends on the averaged one.
+    for(x = 0; x < 256; ++x)
+        fadeTable[x] = (byte) (x * invFade + 0x80 * fade);
+
+    if(width == 1 && height == 1)
+    {
+        DENG_ASSERT(!"GL_DownMipmap8: Can't be called for a 1x1 image");
+        return;
+    }
+
+    if(!outW || !outH)
+    {   // Limited, 1x2|2x1 -> 1x1 reduction?
+        int outDim = (width > 1 ? outW : outH);
+
+        for(x = 0; x < outDim; x++, in += 2)
+        {
+            *out = (in[0] + in[1]) / 2;
+            *fadedOut++ = fadeTable[*out];
+            out++;
+        }
+    }
+    else
+    {   // Unconstrained, 2x2 -> 1x1 reduction?
+        for(y = 0; y < outH; y++, in += width)
+            for(x = 0; x < outW; x++, in += 2)
+            {
+                *out = (in[0] + in[1] + in[width] + in[width + 1]) / 4;
+                *fadedOut++ = fadeTable[*out];
+                out++;
+            }
+    }
+}
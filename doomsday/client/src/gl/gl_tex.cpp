@@ -33,726 +33,6 @@
 
 #include "gl/gl_tex.h"
 
-static uint8_t* scratchBuffer = NULL;
-static size_t scratchBufferSize = 0;
-
-/**
- * Provides a persistent scratch buffer for use by texture manipulation
- * routines e.g. scaleLine().
- */
-static uint8_t* GetScratchBuffer(size_t size)
-{
-    // Need to enlarge?
-    if(size > scratchBufferSize)
-    {
-        scratchBuffer = (uint8_t *) Z_Realloc(scratchBuffer, size, PU_APPSTATIC);
-        scratchBufferSize = size;
-    }
-    return scratchBuffer;
-}
-
-/**
- * Len is measured in out units. Comps is the number of components per
- * pixel, or rather the number of bytes per pixel (3 or 4). The strides must
- * be byte-aligned anyway, though; not in pixels.
- *
- * @todo Probably could be optimized.
- */
-static void scaleLine(const uint8_t* in, int inStride, uint8_t* out, int outStride,
-    int outLen, int inLen, int comps)
-{
-    float inToOutScale = outLen / (float) inLen;
-    int i, c;
-
-    if(inToOutScale > 1)
-    {
-        // Magnification is done using linear interpolation.
-        fixed_t inPosDelta = (FRACUNIT * (inLen - 1)) / (outLen - 1);
-        fixed_t inPos = inPosDelta;
-        const uint8_t* col1, *col2;
-        int weight, invWeight;
-
-        // The first pixel.
-        memcpy(out, in, comps);
-        out += outStride;
-
-        // Step at each out pixel between the first and last ones.
-        for(i = 1; i < outLen - 1; ++i, out += outStride, inPos += inPosDelta)
-        {
-            col1 = in + (inPos >> FRACBITS) * inStride;
-            col2 = col1 + inStride;
-            weight = inPos & 0xffff;
-            invWeight = 0x10000 - weight;
-
-            for(c = 0; c < comps; ++c)
-                out[c] = (uint8_t)((col1[c] * invWeight + col2[c] * weight) >> 16);
-        }
-
-        // The last pixel.
-        memcpy(out, in + (inLen - 1) * inStride, comps);
-        return;
-    }
-
-    if(inToOutScale < 1)
-    {
-        // Minification needs to calculate the average of each of
-        // the pixels contained by the out pixel.
-        uint cumul[4] = { 0, 0, 0, 0 }, count = 0;
-        int outpos = 0;
-
-        for(i = 0; i < inLen; ++i, in += inStride)
-        {
-            if((int) (i * inToOutScale) != outpos)
-            {
-                outpos = (int) (i * inToOutScale);
-
-                for(c = 0; c < comps; ++c)
-                {
-                    out[c] = (uint8_t)(cumul[c] / count);
-                    cumul[c] = 0;
-                }
-                count = 0;
-                out += outStride;
-            }
-            for(c = 0; c < comps; ++c)
-                cumul[c] += in[c];
-            count++;
-        }
-        // Fill in the last pixel, too.
-        if(count)
-            for(c = 0; c < comps; ++c)
-                out[c] = (uint8_t)(cumul[c] / count);
-        return;
-    }
-
-    // No need for scaling.
-    for(i = outLen; i > 0; i--, out += outStride, in += inStride)
-    {
-        for(c = 0; c < comps; ++c)
-            out[c] = in[c];
-    }
-}
-
-/// \todo Avoid use of a secondary buffer by scaling directly to output.
-uint8_t* GL_ScaleBuffer(const uint8_t* in, int width, int height, int comps,
-    int outWidth, int outHeight)
-{
-    assert(in);
-    {
-    uint inOffsetSize, outOffsetSize;
-    uint8_t* outOff, *buffer;
-    const uint8_t* inOff;
-    uint8_t* out;
-    int stride;
-
-    if(width <= 0 || height <= 0)
-        return (uint8_t*)in;
-
-    buffer = GetScratchBuffer(comps * outWidth * height);
-
-    if(0 == (out = (uint8_t*) malloc(comps * outWidth * outHeight)))
-        Con_Error("GL_ScaleBuffer: Failed on allocation of %lu bytes for "
-            "output buffer.", (unsigned long) (comps * outWidth * outHeight));
-
-    // First scale horizontally, to outWidth, into the temporary buffer.
-    inOff = in;
-    outOff = buffer;
-    inOffsetSize = width * comps;
-    outOffsetSize = outWidth * comps;
-    { int i;
-    for(i = 0; i < height; ++i, inOff += inOffsetSize, outOff += outOffsetSize)
-    {
-        scaleLine(inOff, comps, outOff, comps, outWidth, width, comps);
-    }}
-
-    // Then scale vertically, to outHeight, into the out buffer.
-    inOff = buffer;
-    outOff = out;
-    stride = outWidth * comps;
-    inOffsetSize = comps;
-    outOffsetSize = comps;
-    { int i;
-    for(i = 0; i < outWidth; ++i, inOff += inOffsetSize, outOff += outOffsetSize)
-    {
-        scaleLine(inOff, stride, outOff, stride, outHeight, height, comps);
-    }}
-    return out;
-    }
-}
-
-static void* packImage(int components, const float* tempOut, GLint typeOut,
-    int widthOut, int heightOut, int sizeOut, int bpp, int packRowLength,
-    int packAlignment, int packSkipRows, int packSkipPixels)
-{
-    int rowStride, rowLen;
-    void* dataOut;
-
-    if(NULL == (dataOut = malloc(bpp * widthOut * heightOut)))
-        Con_Error("scaleImage: Failed on allocation of %lu bytes for output "
-                  "buffer.", (unsigned long) (bpp * widthOut * heightOut));
-
-    if(packRowLength > 0)
-    {
-        rowLen = packRowLength;
-    }
-    else
-    {
-        rowLen = widthOut;
-    }
-    if(sizeOut >= packAlignment)
-    {
-        rowStride = components * rowLen;
-    }
-    else
-    {
-        rowStride = packAlignment / sizeOut
-            * CEILING(components * rowLen * sizeOut, packAlignment);
-    }
-
-    switch(typeOut)
-    {
-    case GL_UNSIGNED_BYTE: {
-        int i, j, k = 0;
-        for(i = 0; i < heightOut; ++i)
-        {
-            GLubyte* ubptr = (GLubyte*) dataOut
-                + i * rowStride
-                + packSkipRows * rowStride + packSkipPixels * components;
-            for(j = 0; j < widthOut * components; ++j)
-            {
-                *ubptr++ = (GLubyte) tempOut[k++];
-            }
-        }
-        break;
-      }
-    case GL_BYTE: {
-        int i, j, k = 0;
-        for(i = 0; i < heightOut; i++)
-        {
-            GLbyte* bptr = (GLbyte*) dataOut
-                + i * rowStride
-                + packSkipRows * rowStride + packSkipPixels * components;
-            for(j = 0; j < widthOut * components; ++j)
-            {
-                *bptr++ = (GLbyte) tempOut[k++];
-            }
-        }
-        break;
-      }
-    case GL_UNSIGNED_SHORT: {
-        int i, j, k = 0;
-        for(i = 0; i < heightOut; ++i)
-        {
-            GLushort* usptr = (GLushort*) dataOut
-                + i * rowStride
-                + packSkipRows * rowStride + packSkipPixels * components;
-            for(j = 0; j < widthOut * components; ++j)
-            {
-                *usptr++ = (GLushort) tempOut[k++];
-            }
-        }
-        break;
-      }
-    case GL_SHORT: {
-        int i, j, k = 0;
-        for(i = 0; i < heightOut; ++i)
-        {
-            GLshort* sptr = (GLshort*) dataOut
-                + i * rowStride
-                + packSkipRows * rowStride + packSkipPixels * components;
-            for(j = 0; j < widthOut * components; ++j)
-            {
-                *sptr++ = (GLshort) tempOut[k++];
-            }
-        }
-        break;
-      }
-    case GL_UNSIGNED_INT: {
-        int i, j, k = 0;
-        for(i = 0; i < heightOut; ++i)
-        {
-            GLuint* uiptr = (GLuint*) dataOut
-                + i * rowStride
-                + packSkipRows * rowStride + packSkipPixels * components;
-            for(j = 0; j < widthOut * components; ++j)
-            {
-                *uiptr++ = (GLuint) tempOut[k++];
-            }
-        }
-        break;
-      }
-    case GL_INT: {
-        int i, j, k = 0;
-        for(i = 0; i < heightOut; ++i)
-        {
-            GLint* iptr = (GLint*) dataOut
-                + i * rowStride
-                + packSkipRows * rowStride + packSkipPixels * components;
-            for(j = 0; j < widthOut * components; ++j)
-            {
-                *iptr++ = (GLint) tempOut[k++];
-            }
-        }
-        break;
-      }
-    case GL_FLOAT: {
-        int i, j, k = 0;
-        for(i = 0; i < heightOut; ++i)
-        {
-            GLfloat* fptr = (GLfloat*) dataOut
-                + i * rowStride
-                + packSkipRows * rowStride + packSkipPixels * components;
-            for (j = 0; j < widthOut * components; ++j)
-            {
-                *fptr++ = tempOut[k++];
-            }
-        }
-        break;
-      }
-    default:
-        return 0;
-    }
-
-    return dataOut;
-}
-
-/**
- * Originally from the Mesa 3-D graphics library version 3.4
- * @note License: GNU Library General Public License (or later)
- * Copyright (C) 1995-2000  Brian Paul.
- */
-void* GL_ScaleBufferEx(const void* dataIn, int widthIn, int heightIn, int bpp,
-    /*GLint typeIn,*/ int unpackRowLength, int unpackAlignment, int unpackSkipRows,
-    int unpackSkipPixels, int widthOut, int heightOut, /*GLint typeOut, */
-    int packRowLength, int packAlignment, int packSkipRows, int packSkipPixels)
-{
-    const GLint typeIn = GL_UNSIGNED_BYTE, typeOut = GL_UNSIGNED_BYTE;
-    int i, j, k, sizeIn, sizeOut, rowStride, rowLen;
-    float* tempIn, *tempOut;
-    float sx, sy;
-    void* dataOut;
-
-    // Determine bytes per input datum.
-    switch(typeIn)
-    {
-    case GL_UNSIGNED_BYTE:
-        sizeIn = sizeof(GLubyte);
-        break;
-    case GL_BYTE:
-        sizeIn = sizeof(GLbyte);
-        break;
-    case GL_UNSIGNED_SHORT:
-        sizeIn = sizeof(GLushort);
-        break;
-    case GL_SHORT:
-        sizeIn = sizeof(GLshort);
-        break;
-    case GL_UNSIGNED_INT:
-        sizeIn = sizeof(GLuint);
-        break;
-    case GL_INT:
-        sizeIn = sizeof(GLint);
-        break;
-    case GL_FLOAT:
-        sizeIn = sizeof(GLfloat);
-        break;
-    case GL_BITMAP:
-        // Not implemented yet.
-    default:
-        return NULL;
-    }
-
-    // Determine bytes per output datum.
-    switch(typeOut)
-    {
-    case GL_UNSIGNED_BYTE:
-        sizeOut = sizeof(GLubyte);
-        break;
-    case GL_BYTE:
-        sizeOut = sizeof(GLbyte);
-        break;
-    case GL_UNSIGNED_SHORT:
-        sizeOut = sizeof(GLushort);
-        break;
-    case GL_SHORT:
-        sizeOut = sizeof(GLshort);
-        break;
-    case GL_UNSIGNED_INT:
-        sizeOut = sizeof(GLuint);
-        break;
-    case GL_INT:
-        sizeOut = sizeof(GLint);
-        break;
-    case GL_FLOAT:
-        sizeOut = sizeof(GLfloat);
-        break;
-    case GL_BITMAP:
-        // Not implemented yet.
-    default:
-        return NULL;
-    }
-
-    // Allocate storage for intermediate images.
-    if(NULL == (tempIn = (float*) malloc(widthIn * heightIn * bpp * sizeof(float))))
-        Con_Error("scaleImage: Failed on allocation of %lu bytes for in buffer.",
-                  (unsigned long) (widthIn * heightIn * bpp * sizeof(float)));
-
-    if(NULL == (tempOut = (float*) malloc(widthOut * heightOut * bpp * sizeof(float))))
-    {
-        free(tempIn);
-        Con_Error("scaleImage: Failed on allocation of %lu bytes for out buffer.",
-                  (unsigned long) (widthOut * heightOut * bpp * sizeof(float)));
-    }
-
-    /**
-     * Unpack the pixel data and convert to floating point
-     */
-
-    if(unpackRowLength > 0)
-    {
-        rowLen = unpackRowLength;
-    }
-    else
-    {
-        rowLen = widthIn;
-    }
-
-    if(sizeIn >= unpackAlignment)
-    {
-        rowStride = bpp * rowLen;
-    }
-    else
-    {
-        rowStride = unpackAlignment / sizeIn
-            * CEILING(bpp * rowLen * sizeIn, unpackAlignment);
-    }
-
-    switch(typeIn)
-    {
-    case GL_UNSIGNED_BYTE:
-        k = 0;
-        for(i = 0; i < heightIn; ++i)
-        {
-            GLubyte* ubptr = (GLubyte*) dataIn
-                + i * rowStride
-                + unpackSkipRows * rowStride + unpackSkipPixels * bpp;
-            for(j = 0; j < widthIn * bpp; ++j)
-            {
-                tempIn[k++] = (float) *ubptr++;
-            }
-        }
-        break;
-    case GL_BYTE:
-        k = 0;
-        for(i = 0; i < heightIn; ++i)
-        {
-            GLbyte* bptr = (GLbyte*) dataIn
-                + i * rowStride
-                + unpackSkipRows * rowStride + unpackSkipPixels * bpp;
-            for(j = 0; j < widthIn * bpp; ++j)
-            {
-                tempIn[k++] = (float) *bptr++;
-            }
-        }
-        break;
-    case GL_UNSIGNED_SHORT:
-        k = 0;
-        for(i = 0; i < heightIn; ++i)
-        {
-            GLushort* usptr = (GLushort*) dataIn
-                + i * rowStride
-                + unpackSkipRows * rowStride + unpackSkipPixels * bpp;
-            for(j = 0; j < widthIn * bpp; ++j)
-            {
-                tempIn[k++] = (float) *usptr++;
-            }
-        }
-        break;
-    case GL_SHORT:
-        k = 0;
-        for(i = 0; i < heightIn; ++i)
-        {
-            GLshort* sptr = (GLshort*) dataIn
-                + i * rowStride
-                + unpackSkipRows * rowStride + unpackSkipPixels * bpp;
-            for(j = 0; j < widthIn * bpp; ++j)
-            {
-                tempIn[k++] = (float) *sptr++;
-            }
-        }
-        break;
-    case GL_UNSIGNED_INT:
-        k = 0;
-        for(i = 0; i < heightIn; ++i)
-        {
-            GLuint* uiptr = (GLuint*) dataIn
-                + i * rowStride
-                + unpackSkipRows * rowStride + unpackSkipPixels * bpp;
-            for(j = 0; j < widthIn * bpp; ++j)
-            {
-                tempIn[k++] = (float) *uiptr++;
-            }
-        }
-        break;
-    case GL_INT:
-        k = 0;
-        for(i = 0; i < heightIn; ++i)
-        {
-            GLint* iptr = (GLint*) dataIn
-                + i * rowStride
-                + unpackSkipRows * rowStride + unpackSkipPixels * bpp;
-            for(j = 0; j < widthIn * bpp; ++j)
-            {
-                tempIn[k++] = (float) *iptr++;
-            }
-        }
-        break;
-    case GL_FLOAT:
-        k = 0;
-        for(i = 0; i < heightIn; ++i)
-        {
-            GLfloat* fptr = (GLfloat*) dataIn
-                + i * rowStride
-                + unpackSkipRows * rowStride + unpackSkipPixels * bpp;
-            for(j = 0; j < widthIn * bpp; ++j)
-            {
-                tempIn[k++] = *fptr++;
-            }
-        }
-        break;
-    default:
-        return 0;
-    }
-
-    /**
-     * Scale the image!
-     */
-
-    if(widthOut > 1)
-        sx = (float) (widthIn - 1) / (float) (widthOut - 1);
-    else
-        sx = (float) (widthIn - 1);
-    if(heightOut > 1)
-        sy = (float) (heightIn - 1) / (float) (heightOut - 1);
-    else
-        sy = (float) (heightIn - 1);
-
-    if(sx < 1.0 && sy < 1.0)
-    {
-        // Magnify both width and height: use weighted sample of 4 pixels.
-        int i0, i1, j0, j1;
-        float alpha, beta;
-        float* src00, *src01, *src10, *src11;
-        float s1, s2;
-        float* dst;
-
-        for(i = 0; i < heightOut; ++i)
-        {
-            i0 = i * sy;
-            i1 = i0 + 1;
-            if(i1 >= heightIn)
-                i1 = heightIn - 1;
-            alpha = i * sy - i0;
-            for(j = 0; j < widthOut; ++j)
-            {
-                j0 = j * sx;
-                j1 = j0 + 1;
-                if(j1 >= widthIn)
-                    j1 = widthIn - 1;
-                beta = j * sx - j0;
-
-                // Compute weighted average of pixels in rect (i0,j0)-(i1,j1)
-                src00 = tempIn + (i0 * widthIn + j0) * bpp;
-                src01 = tempIn + (i0 * widthIn + j1) * bpp;
-                src10 = tempIn + (i1 * widthIn + j0) * bpp;
-                src11 = tempIn + (i1 * widthIn + j1) * bpp;
-
-                dst = tempOut + (i * widthOut + j) * bpp;
-
-                for (k = 0; k < bpp; ++k)
-                {
-                    s1 = *src00++ * (1.0 - beta) + *src01++ * beta;
-                    s2 = *src10++ * (1.0 - beta) + *src11++ * beta;
-                    *dst++ = s1 * (1.0 - alpha) + s2 * alpha;
-                }
-            }
-        }
-    }
-    else
-    {
-        // Shrink width and/or height:  use an unweighted box filter.
-        int i0, i1;
-        int j0, j1;
-        int ii, jj;
-        float sum, *dst;
-
-        for(i = 0; i < heightOut; ++i)
-        {
-            i0 = i * sy;
-            i1 = i0 + 1;
-            if(i1 >= heightIn)
-                i1 = heightIn - 1;
-
-            for(j = 0; j < widthOut; ++j)
-            {
-                j0 = j * sx;
-                j1 = j0 + 1;
-                if(j1 >= widthIn)
-                    j1 = widthIn - 1;
-
-                dst = tempOut + (i * widthOut + j) * bpp;
-
-                // Compute average of pixels in the rectangle (i0,j0)-(i1,j1)
-                for(k = 0; k < bpp; ++k)
-                {
-                    sum = 0.0;
-                    for(ii = i0; ii <= i1; ++ii)
-                    {
-                        for(jj = j0; jj <= j1; ++jj)
-                        {
-                            sum += *(tempIn + (ii * widthIn + jj) * bpp + k);
-                        }
-                    }
-                    sum /= (j1 - j0 + 1) * (i1 - i0 + 1);
-                    *dst++ = sum;
-                }
-            }
-        }
-    }
-
-    // Free temporary image storage.
-    free(tempIn);
-
-    /**
-     * Return output image.
-     */
-    dataOut = packImage(bpp, tempOut, typeOut, widthOut, heightOut, sizeOut, bpp,
-        packRowLength, packAlignment, packSkipRows, packSkipPixels);
-
-    // Free temporary image storage.
-    free(tempOut);
-
-    return dataOut;
-}
-
-uint8_t* GL_ScaleBufferNearest(const uint8_t* in, int width, int height, int comps,
-    int outWidth, int outHeight)
-{
-    assert(in);
-    {
-    int ratioX, ratioY, shearY;
-    uint8_t* out, *outP;
-
-    if(width <= 0 || height <= 0)
-        return (uint8_t*)in;
-
-    ratioX = (int)(width  << 16) / outWidth  + 1;
-    ratioY = (int)(height << 16) / outHeight + 1;
-
-    if(NULL == (out = (uint8_t *) M_Malloc(comps * outWidth * outHeight)))
-        Con_Error("GL_ScaleBufferNearest: Failed on allocation of %lu bytes for "
-                  "output buffer.", (unsigned long) (comps * outWidth * outHeight));
-
-    outP = out;
-    shearY = 0;
-    { int i;
-    for(i = 0; i < outHeight; ++i, shearY += ratioY)
-    {
-        int shearX = 0;
-        int shearY2 = (shearY >> 16) * width;
-        { int j;
-        for(j = 0; j < outWidth; ++j, outP += comps, shearX += ratioX)
-        {
-            int c, n = (shearY2 + (shearX >> 16)) * comps;
-            for(c = 0; c < comps; ++c, n++)
-                outP[c] = in[n];
-        }}
-    }}
-    return out;
-    }
-}
-
-void GL_DownMipmap32(uint8_t* in, int width, int height, int comps)
-{
-    assert(in);
-    {
-    int x, y, c, outW = width >> 1, outH = height >> 1;
-    uint8_t* out;
-
-    if(width <= 0 || height <= 0 || comps <= 0)
-        return;
-
-    if(width == 1 && height == 1)
-    {
-#if _DEBUG
-        Con_Error("GL_DownMipmap32: Can't be called for a 1x1 image.\n");
-#endif
-        return;
-    }
-
-    // Limited, 1x2|2x1 -> 1x1 reduction?
-    if(!outW || !outH)
-    {
-        int outDim = (width > 1 ? outW : outH);
-
-        out = in;
-        for(x = 0; x < outDim; ++x, in += comps * 2)
-            for(c = 0; c < comps; ++c, out++)
-                *out = (uint8_t)((in[c] + in[comps + c]) >> 1);
-        return;
-    }
-
-    // Unconstrained, 2x2 -> 1x1 reduction?
-    out = in;
-    for(y = 0; y < outH; ++y, in += width * comps)
-        for(x = 0; x < outW; ++x, in += comps * 2)
-            for(c = 0; c < comps; ++c, out++)
-                *out = (uint8_t)((in[c] + in[comps + c] + in[comps * width + c] +
-                              in[comps * (width + 1) + c]) >> 2);
-    }
-}
-
-void GL_DownMipmap8(uint8_t* in, uint8_t* fadedOut, int width, int height, float fade)
-{
-    int x, y, outW = width / 2, outH = height / 2;
-    float invFade;
-    byte* out = in;
-
-    if(fade > 1)
-        fade = 1;
-    invFade = 1 - fade;
-
-    if(width == 1 && height == 1)
-    {
-#if _DEBUG
-        Con_Error("GL_DownMipmap8: Can't be called for a 1x1 image.\n");
-#endif
-        return;
-    }
-
-    if(!outW || !outH)
-    {   // Limited, 1x2|2x1 -> 1x1 reduction?
-        int outDim = (width > 1 ? outW : outH);
-
-        for(x = 0; x < outDim; x++, in += 2)
-        {
-            *out = (in[0] + in[1]) / 2;
-            *fadedOut++ = (byte) (*out * invFade + 0x80 * fade);
-            out++;
-        }
-    }
-    else
-    {   // Unconstrained, 2x2 -> 1x1 reduction?
-        for(y = 0; y < outH; y++, in += width)
-            for(x = 0; x < outW; x++, in += 2)
-            {
-                *out = (in[0] + in[1] + in[width] + in[width + 1]) / 4;
-                *fadedOut++ = (byte) (*out * invFade + 0x80 * fade);
-                out++;
-            }
-    }
-}
-
 boolean GL_PalettizeImage(uint8_t *out, int outformat, colorpalette_t const *palette,
     boolean applyTexGamma, uint8_t const *in, int informat, int width, int height)
 {
@@ -0,0 +1,310 @@
+/**
+ * @file gl_texcache.cpp
+ * Persistent cache of processed texture content. @ingroup gl
+ *
+ * @authors Copyright © 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "de_base.h"
+#include "de_filesys.h"
+#include "gl/gl_main.h"
+#include "gl/gl_tex.h"
+#include "gl/gl_texmanager.h"
+#include "resource/colorpalettes.h"
+
+#include "gl/gl_texcache.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QTemporaryFile>
+#include <de/Block>
+#include <de/ByteRefArray>
+#include <de/Guard>
+#include <de/Lockable>
+#include <de/Log>
+#include <de/Reader>
+#include <de/Writer>
+#include <de/memory.h>
+
+using namespace de;
+
+/// Identifies the cache entry files.
+#define TEXCACHE_MAGIC          0x31435444 // "DTC1"
+
+/**
+ * Version of the processing algorithms. Increment when a change to the
+ * preparation or processing of texture content changes the results, so that
+ * the existing entries are no longer found.
+ */
+#define TEXCACHE_VERSION        1
+
+/// Directory of the cache entries (relative to the runtime directory).
+#define TEXCACHE_DIR            "texcache/"
+
+/// Size of the header of an entry file, in bytes.
+#define TEXCACHE_HEADER_SIZE    44
+
+/// File name extension of the entries.
+#define TEXCACHE_ENTRY_SUFFIX   ".dtc"
+
+byte texCacheMode = 0;
+
+namespace internal {
+
+struct CacheState : public Lockable
+{
+    bool pathCreated;
+    int hits;
+    int misses;
+
+    CacheState() : pathCreated(false), hits(0), misses(0) {}
+};
+
+} // namespace internal
+
+using namespace internal;
+
+static CacheState &cacheState()
+{
+    static CacheState state;
+    return state;
+}
+
+static String entryPath(String const &key)
+{
+    return TEXCACHE_DIR + key + TEXCACHE_ENTRY_SUFFIX;
+}
+
+/**
+ * Returns the size of a pixel of processed content, in bytes, or zero if the
+ * format is not one that processing produces (processed content is never
+ * paletted).
+ */
+static int processedPixelSize(dgltexformat_t format)
+{
+    switch(format)
+    {
+    case DGL_LUMINANCE:         return 1;
+    case DGL_LUMINANCE_PLUS_A8: return 2;
+    case DGL_RGB:               return 3;
+    case DGL_RGBA:              return 4;
+
+    default:                    return 0;
+    }
+}
+
+static void countLookup(bool hit)
+{
+    CacheState &st = cacheState();
+    DENG2_GUARD(st);
+    if(hit) st.hits++;
+    else    st.misses++;
+}
+
+String GL_TexCacheKey(image_t const &image, texturevariantspecification_t const &spec)
+{
+    // Detail textures are small and cheap to prepare.
+    if(!texCacheMode || spec.type != TST_GENERAL || !image.pixels)
+        return String();
+
+    variantspecification_t const &vspec = TS_GENERAL(spec);
+
+    Block params;
+    Writer writer(params);
+
+    writer << duint32(TEXCACHE_VERSION);
+
+    // The source image.
+    writer << dint32(image.size.width) << dint32(image.size.height)
+           << dint32(image.pixelSize) << dint32(image.flags);
+    if(image.paletteId)
+    {
+        colorpalette_t *palette = R_ToColorPalette(image.paletteId);
+        for(int i = 0; i < ColorPalette_Size(palette); ++i)
+        {
+            uint8_t rgb[3];
+            ColorPalette_Color(palette, i, rgb);
+            writer << rgb[0] << rgb[1] << rgb[2];
+        }
+    }
+
+    // The parts of the specification that affect the pixels.
+    writer << dint32(vspec.flags & ~TSF_INTERNAL_MASK) << duchar(vspec.border)
+           << duchar(vspec.mipmapped) << duchar(vspec.gammaCorrection)
+           << duchar(vspec.noStretch) << duchar(vspec.toAlpha);
+
+    // Settings and hardware limitations used in the preparation.
+    writer << duchar(fillOutlines) << dint32(useSmartFilter) << dint32(texQuality)
+           << dfloat(vspec.gammaCorrection? texGamma : 0)
+           << dint32(GL_state.maxTexSize) << duchar(GL_state.features.texNonPowTwo)
+           << dint32(ratioLimit);
+
+    // Masked paletted images have an alpha plane after the color indices.
+    int planes = 1;
+    if(image.pixelSize == 1 && image.paletteId && (image.flags & IMGF_IS_MASKED))
+        planes = 2;
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(params);
+    hash.addData((char const *) image.pixels, image.size.width * image.size.height * image.pixelSize * planes);
+    return QString(hash.result().toHex());
+}
+
+bool GL_TexCacheFind(String const &key, texturecontent_t &content, image_t &image)
+{
+    DENG_ASSERT(!key.isEmpty());
+
+    QFile file(entryPath(key));
+    if(!file.open(QFile::ReadOnly) || file.size() < TEXCACHE_HEADER_SIZE)
+    {
+        countLookup(false);
+        return false;
+    }
+
+    // Entries are mapped rather than read to avoid an extra copy of the data.
+    dsize const fileSize = file.size();
+    uchar const *mapped = file.map(0, fileSize);
+    if(!mapped)
+    {
+        countLookup(false);
+        return false;
+    }
+
+    uint8_t *pixels = 0;
+    try
+    {
+        duint32 magic, format, flags, compressed, dataSize;
+        dint32 width, height, imageWidth, imageHeight, imageFlags;
+
+        ByteRefArray const headerBytes(mapped, TEXCACHE_HEADER_SIZE);
+        Reader reader(headerBytes);
+        reader >> magic >> format >> width >> height >> flags
+               >> imageWidth >> imageHeight >> imageFlags
+               >> compressed >> dataSize;
+
+        dsize const pixelsSize = dsize(processedPixelSize(dgltexformat_t(format))) * width * height;
+
+        if(magic != TEXCACHE_MAGIC || width <= 0 || height <= 0 || !pixelsSize ||
+           TEXCACHE_HEADER_SIZE + dataSize != fileSize)
+        {
+            throw Error("GL_TexCacheFind", "Invalid entry");
+        }
+
+        uchar const *data = mapped + TEXCACHE_HEADER_SIZE;
+        if(compressed)
+        {
+            QByteArray const inflated = qUncompress(data, dataSize);
+            if(dsize(inflated.size()) != pixelsSize)
+                throw Error("GL_TexCacheFind", "Invalid compressed data");
+
+            pixels = (uint8_t *) M_MemDup(inflated.constData(), pixelsSize);
+        }
+        else
+        {
+            if(dataSize != pixelsSize)
+                throw Error("GL_TexCacheFind", "Invalid data size");
+
+            pixels = (uint8_t *) M_MemDup(data, pixelsSize);
+        }
+
+        content.format = dgltexformat_t(format);
+        content.width  = width;
+        content.height = height;
+        content.flags  = flags;
+        content.pixels = pixels;
+
+        image.size.width  = imageWidth;
+        image.size.height = imageHeight;
+        image.flags       = imageFlags;
+    }
+    catch(Error const &er)
+    {
+        LOG_DEBUG("Ignoring texture cache entry %s: %s") << key << er.asText();
+        M_Free(pixels);
+        pixels = 0;
+    }
+
+    file.unmap(const_cast<uchar *>(mapped));
+    countLookup(pixels != 0);
+    return pixels != 0;
+}
+
+void GL_TexCacheInsert(String const &key, texturecontent_t const &content, image_t const &image)
+{
+    DENG_ASSERT(!key.isEmpty());
+    DENG_ASSERT(content.flags & TXCF_PROCESSED);
+
+    int const pixelSize = processedPixelSize(content.format);
+    if(!pixelSize) return;
+
+    {
+        CacheState &st = cacheState();
+        DENG2_GUARD(st);
+        if(!st.pathCreated)
+        {
+            F_MakePath(TEXCACHE_DIR);
+            st.pathCreated = true;
+        }
+    }
+
+    QByteArray data = QByteArray::fromRawData((char const *) content.pixels,
+        pixelSize * content.width * content.height);
+
+    bool const compressed = (texCacheMode == 2);
+    if(compressed)
+    {
+        data = qCompress(data, 1 /* fast */);
+    }
+
+    Block header;
+    Writer writer(header);
+    writer << duint32(TEXCACHE_MAGIC) << duint32(content.format)
+           << dint32(content.width) << dint32(content.height) << duint32(content.flags)
+           << dint32(image.size.width) << dint32(image.size.height) << dint32(image.flags)
+           << duint32(compressed) << duint32(data.size())
+           << duint32(0); // Reserved.
+    DENG_ASSERT(header.size() == TEXCACHE_HEADER_SIZE);
+
+    // Write to a uniquely named temporary file first so that incomplete
+    // entries are never found (the entry may also be written concurrently by
+    // another thread or process).
+    String const path = entryPath(key);
+
+    QTemporaryFile file(path + ".XXXXXX");
+    if(!file.open())
+    {
+        LOG_DEBUG("Failed to write texture cache entry %s.") << path;
+        return;
+    }
+    bool const ok = file.write(header) == header.size() && file.write(data) == data.size();
+    file.close();
+
+    if(ok && file.rename(path))
+    {
+        file.setAutoRemove(false);
+    }
+    // Otherwise failed, or the entry exists already: the temporary file is
+    // removed automatically.
+}
+
+void GL_TexCacheStats(int &hits, int &misses)
+{
+    CacheState &st = cacheState();
+    DENG2_GUARD(st);
+    hits   = st.hits;
+    misses = st.misses;
+}
@@ -42,10 +42,13 @@
 #include "clientapp.h"
 
 #include "def_main.h"
+#include "gl/gl_texcache.h"
 #include "resource/hq2x.h"
 
 #include <QSize>
 #include <de/ByteRefArray>
+#include <de/TaskPool>
+#include <de/Time>
 #include <de/mathutil.h>
 #include <de/memory.h>
 #include <de/memoryzone.h>
@@ -66,6 +69,7 @@ typedef texturevariantspecificationlist_node_t variantspecificationlist_t;
 
 D_CMD(LowRes);
 D_CMD(MipMap);
+D_CMD(TexBench);
 D_CMD(TexReset);
 
 void GL_DoResetDetailTextures();
@@ -75,6 +79,8 @@ void GL_DoUpdateTexParams();
 
 static int hashDetailVariantSpecification(detailvariantspecification_t const &spec);
 
+static void configureTextureContentSampling(texturecontent_t &c, variantspecification_t const &vspec);
+
 static TexSource loadExternalTexture(image_t &image, String searchPath, String optionalSuffix = "");
 
 static TexSource loadFlat(image_t &image, de::FileHandle &file);
@@ -96,6 +102,7 @@ boolean noHighResTex = false;
 boolean noHighResPatches = false;
 boolean highResWithPWAD = false;
 byte loadExtAlways = false; // Always check for extres (cvar)
+byte prepareTexturesAsync = true; // Prepare variants in the background (cvar)
 
 float texGamma = 0;
 
@@ -127,6 +134,8 @@ static variantspecificationlist_t *detailVariantSpecs[DETAILVARIANT_CONTRAST_HAS
 void GL_TexRegister()
 {
     C_VAR_INT   ("rend-tex",                    &renderTextures,     CVF_NO_ARCHIVE, 0, 2);
+    C_VAR_BYTE  ("rend-tex-async",              &prepareTexturesAsync, 0, 0, 1);
+    C_VAR_BYTE  ("rend-tex-cache",              &texCacheMode,       0, 0, 2);
     C_VAR_INT   ("rend-tex-detail",             &r_detail,           0, 0, 1);
     C_VAR_INT   ("rend-tex-detail-multitex",    &useMultiTexDetails, 0, 0, 1);
     C_VAR_FLOAT ("rend-tex-detail-scale",       &detailScale,        CVF_NO_MIN | CVF_NO_MAX, 0, 0);
@@ -143,6 +152,7 @@ void GL_TexRegister()
 
     C_CMD_FLAGS ("lowres",      "",     LowRes, CMDF_NO_DEDICATED);
     C_CMD_FLAGS ("mipmap",      "i",    MipMap, CMDF_NO_DEDICATED);
+    C_CMD_FLAGS ("texbench",    "",     TexBench, CMDF_NO_DEDICATED);
     C_CMD_FLAGS ("texreset",    "",     TexReset, CMDF_NO_DEDICATED);
 }
 
@@ -1492,27 +1502,30 @@ boolean GL_UploadTexture(int glFormat, int loadFormat, const uint8_t* pixels,
     return true;
 }
 
-/// @note Texture parameters will NOT be set here!
-void GL_UploadTextureContent(texturecontent_t const &content, GLUploadMethod method)
+/**
+ * Performs the CPU-side processing of texture content for uploading. Does not
+ * use GL, so this can be done in any thread.
+ *
+ * @param content     Texture content to process.
+ * @param loadWidth   Width of the processed image is written here.
+ * @param loadHeight  Height of the processed image is written here.
+ * @param dglFormat   Format of the processed image is written here.
+ *
+ * @return  Processed pixels. If no changes were needed, this is @c content.pixels;
+ * otherwise a new buffer that the caller must free with M_Free().
+ */
+static uint8_t const *processTextureContent(texturecontent_t const &content,
+    int &loadWidth, int &loadHeight, dgltexformat_t &dglFormat)
 {
-    if(method == Deferred)
-    {
-        GL_DeferTextureUpload(&content);
-        return;
-    }
-
-    if(novideo) return;
-
-    // Do this right away. No need to take a copy.
     bool generateMipmaps = (content.flags & (TXCF_MIPMAP|TXCF_GRAY_MIPMAP)) != 0;
     bool applyTexGamma   = (content.flags & TXCF_APPLY_GAMMACORRECTION)     != 0;
-    bool noCompression   = (content.flags & TXCF_NO_COMPRESSION)            != 0;
     bool noSmartFilter   = (content.flags & TXCF_UPLOAD_ARG_NOSMARTFILTER)  != 0;
     bool noStretch       = (content.flags & TXCF_UPLOAD_ARG_NOSTRETCH)      != 0;
 
-    int loadWidth = content.width, loadHeight = content.height;
     uint8_t const *loadPixels = content.pixels;
-    dgltexformat_t dglFormat = content.format;
+    loadWidth  = content.width;
+    loadHeight = content.height;
+    dglFormat  = content.format;
 
     if(DGL_COLOR_INDEX_8 == dglFormat || DGL_COLOR_INDEX_8_PLUS_A8 == dglFormat)
     {
@@ -1687,6 +1700,87 @@ void GL_UploadTextureContent(texturecontent_t const &content, GLUploadMethod met
         }
     }
 
+    return loadPixels;
+}
+
+texturecontent_t *GL_ConstructProcessedTextureContent(texturecontent_t const &content)
+{
+    DENG_ASSERT(!(content.flags & TXCF_PROCESSED));
+
+    texturecontent_t *c = (texturecontent_t *) M_Malloc(sizeof(*c));
+    std::memcpy(c, &content, sizeof(*c));
+
+    uint8_t const *pixels = processTextureContent(content, c->width, c->height, c->format);
+    if(pixels == content.pixels)
+    {
+        // Nothing needed changing; the new content needs a copy of its own.
+        pixels = (uint8_t *) M_MemDup(content.pixels, BytesPerPixelFmt(c->format) * c->width * c->height);
+    }
+    c->pixels = pixels;
+    c->flags |= TXCF_PROCESSED;
+    return c;
+}
+
+texturecontent_t *GL_ConstructPreparedTextureContent(DGLuint glTexName, image_t &image,
+    texturevariantspecification_t const &spec, TextureManifest const &textureManifest)
+{
+    String const cacheKey = GL_TexCacheKey(image, spec);
+    if(!cacheKey.isEmpty())
+    {
+        texturecontent_t *c = (texturecontent_t *) M_Malloc(sizeof(*c));
+        GL_InitTextureContent(c);
+        if(GL_TexCacheFind(cacheKey, *c, image))
+        {
+            c->name = glTexName;
+            configureTextureContentSampling(*c, TS_GENERAL(spec));
+            return c;
+        }
+        M_Free(c);
+    }
+
+    texturecontent_t content;
+    GL_PrepareTextureContent(content, glTexName, image, spec, textureManifest);
+    texturecontent_t *processed = GL_ConstructProcessedTextureContent(content);
+
+    if(!cacheKey.isEmpty())
+    {
+        GL_TexCacheInsert(cacheKey, *processed, image);
+    }
+    return processed;
+}
+
+/// @note Texture parameters will NOT be set here!
+void GL_UploadTextureContent(texturecontent_t const &content, GLUploadMethod method)
+{
+    if(novideo) return;
+
+    if(method == Deferred)
+    {
+        if(content.flags & TXCF_PROCESSED)
+        {
+            GL_DeferTextureUpload(&content);
+        }
+        else
+        {
+            // Process the content in this thread; only the upload is deferred.
+            GL_DeferTextureContentUpload(GL_ConstructProcessedTextureContent(content));
+        }
+        return;
+    }
+
+    // Do this right away. No need to take a copy.
+    bool generateMipmaps = (content.flags & (TXCF_MIPMAP|TXCF_GRAY_MIPMAP)) != 0;
+    bool noCompression   = (content.flags & TXCF_NO_COMPRESSION)            != 0;
+
+    int loadWidth = content.width, loadHeight = content.height;
+    uint8_t const *loadPixels = content.pixels;
+    dgltexformat_t dglFormat = content.format;
+
+    if(!(content.flags & TXCF_PROCESSED))
+    {
+        loadPixels = processTextureContent(content, loadWidth, loadHeight, dglFormat);
+    }
+
     DENG_ASSERT_IN_MAIN_THREAD();
     DENG_ASSERT_GL_CONTEXT_ACTIVE();
 
@@ -2447,11 +2541,23 @@ void GL_SetAllTexturesMinFilter(int /*minFilter*/)
     ///       filter should not modify the uploaded texture content.
 }
 
+/**
+ * Configures the GL texture parameters of the content in accordance with the
+ * specification.
+ */
+static void configureTextureContentSampling(texturecontent_t &c, variantspecification_t const &vspec)
+{
+    c.magFilter   = GL_MagFilterForVariantSpec(vspec);
+    c.minFilter   = GL_MinFilterForVariantSpec(vspec);
+    c.anisoFilter = GL_LogicalAnisoLevelForVariantSpec(vspec);
+    c.wrap[0]     = vspec.wrapS;
+    c.wrap[1]     = vspec.wrapT;
+}
+
 void GL_PrepareTextureContent(texturecontent_t &c, DGLuint glTexName,
     image_t &image, texturevariantspecification_t const &spec,
     TextureManifest const &textureManifest)
 {
-    DENG_ASSERT(glTexName != 0);
     DENG_ASSERT(image.pixels != 0);
 
     // Initialize and assign a GL name to the content.
@@ -2484,11 +2590,7 @@ void GL_PrepareTextureContent(texturecontent_t &c, DGLuint glTexName,
         if(vspec.mipmapped)       c.flags |= TXCF_MIPMAP;
         if(noSmartFilter)         c.flags |= TXCF_UPLOAD_ARG_NOSMARTFILTER;
 
-        c.magFilter   = GL_MagFilterForVariantSpec(vspec);
-        c.minFilter   = GL_MinFilterForVariantSpec(vspec);
-        c.anisoFilter = GL_LogicalAnisoLevelForVariantSpec(vspec);
-        c.wrap[0]     = vspec.wrapS;
-        c.wrap[1]     = vspec.wrapT;
+        configureTextureContentSampling(c, vspec);
         break; }
 
     case TST_DETAIL: {
@@ -2705,6 +2807,114 @@ D_CMD(TexReset)
     return true;
 }
 
+/**
+ * Prepares the content of textures in parallel in the same manner as the
+ * background preparation of texture variants, but without uploading anything.
+ */
+struct TextureBenchmarkWork : public TaskPool::IRangeWork
+{
+    texturevariantspecification_t const &spec;
+    QList<Texture *> const &textures;
+    image_t *images;
+
+    TextureBenchmarkWork(texturevariantspecification_t const &spec,
+                         QList<Texture *> const &textures, image_t *images)
+        : spec(spec), textures(textures), images(images) {}
+
+    void processRange(int begin, int end)
+    {
+        for(int i = begin; i < end; ++i)
+        {
+            image_t &image = images[i];
+            if(!image.pixels) continue;
+
+            GL_DestroyTextureContent(GL_ConstructPreparedTextureContent(0, image, spec,
+                                                                        textures[i]->manifest()));
+            Image_Destroy(&image);
+        }
+    }
+};
+
+D_CMD(TexBench)
+{
+    DENG2_UNUSED3(src, argc, argv);
+
+    /// Number of images loaded before they are prepared.
+    int const BATCH_SIZE = 64;
+
+    // The smart filter's lookup table is needed even without GL.
+    if(!initedOk) GL_InitSmartFilterHQ2x();
+
+    texturevariantspecification_t spec;
+    std::memset(&spec, 0, sizeof(spec));
+    spec.type = TST_GENERAL;
+    variantspecification_t &vspec = TS_GENERAL(spec);
+    vspec.context         = TC_MAPSURFACE_DIFFUSE;
+    vspec.wrapS           = GL_REPEAT;
+    vspec.wrapT           = GL_REPEAT;
+    vspec.minFilter       = -1;
+    vspec.magFilter       = -1;
+    vspec.anisoFilter     = -1;
+    vspec.mipmapped       = true;
+    vspec.gammaCorrection = true;
+
+    QList<Texture *> textures;
+    foreach(Texture *tex, App_Textures().all())
+    {
+        // Details are prepared differently.
+        if(!tex->manifest().schemeName().compareWithoutCase("Details")) continue;
+        textures.append(tex);
+    }
+
+    int cacheHits, cacheMisses;
+    GL_TexCacheStats(cacheHits, cacheMisses);
+
+    image_t images[BATCH_SIZE];
+    TimeDelta loadTime = 0, prepareTime = 0;
+    int count = 0;
+    duint64 pixelCount = 0;
+
+    for(int first = 0; first < textures.size(); first += BATCH_SIZE)
+    {
+        int const num = de::min(BATCH_SIZE, textures.size() - first);
+        QList<Texture *> const batch = textures.mid(first, num);
+
+        // Images are loaded in this thread as the file system is not thread-safe.
+        Time startedAt;
+        for(int i = 0; i < num; ++i)
+        {
+            image_t &image = images[i];
+            if(GL_LoadSourceImage(image, *batch[i], spec) == TEXS_NONE)
+            {
+                image.pixels = 0;
+                continue;
+            }
+            count++;
+            pixelCount += image.size.width * image.size.height;
+        }
+        loadTime += startedAt.since();
+
+        startedAt = Time();
+        TextureBenchmarkWork work(spec, batch, images);
+        TaskPool::parallelFor(work, num);
+        prepareTime += startedAt.since();
+    }
+
+    TimeDelta const total = loadTime + prepareTime;
+    Con_Message("Prepared %i textures (%.1f MPix) in %.2f seconds (loading: %.2f, preparing: %.2f).",
+                count, pixelCount / 1.0e6, double(total), double(loadTime), double(prepareTime));
+    if(total > 0)
+    {
+        Con_Message("  %.1f textures/s, %.2f MPix/s.",
+                    count / double(total), pixelCount / 1.0e6 / double(total));
+    }
+
+    int hits, misses;
+    GL_TexCacheStats(hits, misses);
+    Con_Message("  Texture cache: %i hits, %i misses.", hits - cacheHits, misses - cacheMisses);
+    return true;
+}
+
 D_CMD(MipMap)
 {
     DENG2_UNUSED2(src, argc);
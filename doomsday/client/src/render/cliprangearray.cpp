@@ -0,0 +1,109 @@
+/** @file cliprangearray.cpp Sorted array of clipped angle ranges.
+ *
+ * @authors Copyright © 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <algorithm>
+
+#include "render/cliprangearray.h"
+
+typedef ClipRangeArray::Range Range;
+typedef ClipRangeArray::Ranges Ranges;
+
+static inline bool rangeEndsBefore(Range const &range, binangle_t angle)
+{
+    return range.end < angle;
+}
+
+static inline bool angleBeforeRangeStart(binangle_t angle, Range const &range)
+{
+    return angle < range.start;
+}
+
+static inline bool rangeStartsBefore(Range const &range, binangle_t angle)
+{
+    return range.start < angle;
+}
+
+ClipRangeArray::ClipRangeArray()
+{}
+
+void ClipRangeArray::clear()
+{
+    _ranges.clear();
+}
+
+void ClipRangeArray::add(binangle_t startAngle, binangle_t endAngle)
+{
+    // The first range which could overlap or touch the new range.
+    Ranges::iterator first = std::lower_bound(_ranges.begin(), _ranges.end(),
+                                              startAngle, rangeEndsBefore);
+
+    // Find the end of the overlapped ranges.
+    Ranges::iterator last = first;
+    while(last != _ranges.end() && last->start <= endAngle)
+    {
+        ++last;
+    }
+
+    if(first == last)
+    {
+        // Disconnected from the others.
+        _ranges.insert(first, Range(startAngle, endAngle));
+        return;
+    }
+
+    // Merge the new range and all the overlapped ones into the first.
+    first->start = std::min(first->start, startAngle);
+    first->end   = std::max((last - 1)->end, endAngle);
+    _ranges.erase(first + 1, last);
+}
+
+Range const *ClipRangeArray::rangeBefore(binangle_t angle, bool inclusive) const
+{
+    Ranges::const_iterator found =
+        inclusive? std::upper_bound(_ranges.begin(), _ranges.end(),
+                                    angle, angleBeforeRangeStart)
+                 : std::lower_bound(_ranges.begin(), _ranges.end(),
+                                    angle, rangeStartsBefore);
+    if(found == _ranges.begin()) return 0;
+    return &*(found - 1);
+}
+
+bool ClipRangeArray::isRangeVisible(binangle_t startAngle, binangle_t endAngle) const
+{
+    // Only the range beginning nearest before the start can contain it.
+    Range const *range = rangeBefore(startAngle, true /*inclusive*/);
+    return !(range && endAngle <= range->end);
+}
+
+bool ClipRangeArray::isAngleVisible(binangle_t angle) const
+{
+    Range const *range = rangeBefore(angle, false /*exclusive*/);
+    return !(range && angle < range->end);
+}
+
+bool ClipRangeArray::isFull() const
+{
+    return _ranges.size() == 1 && _ranges.front().start == 0 &&
+           _ranges.front().end == BANG_MAX;
+}
+
+ClipRangeArray::Ranges const &ClipRangeArray::ranges() const
+{
+    return _ranges;
+}
@@ -23,6 +23,7 @@
 
 #ifdef __CLIENT__
 #include <QBitArray>
+#include <QSet>
 #endif
 
 #include "de_base.h"
@@ -1585,6 +1586,39 @@ DENG_EXTERN_C void Rend_CacheForMobjType(int num)
     }
 }
 
+/**
+ * Collects the numbers of the lumps that the images of @a material are loaded
+ * from, so that they can be prefetched.
+ */
+static void collectMaterialLumps(Material &material, QSet<lumpnum_t> &lumps)
+{
+    foreach(Material::Layer *layer, material.layers())
+    foreach(Material::Layer::Stage *stage, layer->stages())
+    {
+        if(!stage->texture) continue;
+        Texture &tex = *stage->texture;
+
+        if(tex.manifest().hasResourceUri())
+        {
+            de::Uri resourceUri = tex.manifest().resourceUri();
+            if(!resourceUri.scheme().compareWithoutCase("LumpIndex"))
+            {
+                lumps.insert(resourceUri.path().toString().toInt());
+            }
+        }
+
+        // Composite textures are drawn from patches.
+        if(!tex.manifest().schemeName().compareWithoutCase("Textures") && tex.userDataPointer())
+        {
+            CompositeTexture const &texDef = *reinterpret_cast<CompositeTexture *>(tex.userDataPointer());
+            DENG2_FOR_EACH_CONST(CompositeTexture::Components, i, texDef.components())
+            {
+                if(i->lumpNum() >= 0) lumps.insert(i->lumpNum());
+            }
+        }
+    }
+}
+
 void Rend_CacheForMap()
 {
     // Don't precache when playing a demo (why not? -ds).
@@ -1600,6 +1634,7 @@ void Rend_CacheForMap()
     {
         MaterialVariantSpec const &spec = Rend_MapSurfaceMaterialSpec();
 
+        QSet<Material *> materials;
         foreach(Line *line, map.lines())
         for(int i = 0; i < 2; ++i)
         {
@@ -1607,13 +1642,13 @@ void Rend_CacheForMap()
             if(!side.hasSections()) continue;
 
             if(side.middle().hasMaterial())
-                App_Materials().cache(side.middle().material(), spec);
+                materials.insert(&side.middle().material());
 
             if(side.top().hasMaterial())
-                App_Materials().cache(side.top().material(), spec);
+                materials.insert(&side.top().material());
 
             if(side.bottom().hasMaterial())
-                App_Materials().cache(side.bottom().material(), spec);
+                materials.insert(&side.bottom().material());
         }
 
         foreach(Sector *sector, map.sectors())
@@ -1624,9 +1659,23 @@ void Rend_CacheForMap()
             foreach(Plane *plane, sector->planes())
             {
                 if(plane->surface().hasMaterial())
-                    App_Materials().cache(plane->surface().material(), spec);
+                    materials.insert(&plane->surface().material());
             }
         }
+
+        // Start decompressing the images stored in packages in the background
+        // while the materials are being cached.
+        QSet<lumpnum_t> lumps;
+        foreach(Material *material, materials)
+        {
+            collectMaterialLumps(*material, lumps);
+        }
+        App_FileSystem().prefetchLumps(lumps.toList());
+
+        foreach(Material *material, materials)
+        {
+            App_Materials().cache(*material, spec);
+        }
     }
 
     if(precacheSprites)
@@ -26,6 +26,7 @@
 #include "de_console.h"
 #include "de_render.h"
 
+#include "render/cliprangearray.h"
 #include "render/rend_clip.h"
 
 using namespace de;
@@ -87,6 +88,7 @@ static void C_OcclusionLister(void);
 #endif
 
 int devNoCulling = 0; ///< cvar. Set to 1 to fully disable angle based culling.
+byte devClipRangeArray = 0; ///< cvar. Set to 1 to use the flat clip range array.
 
 /// The list of clipnodes.
 static Rover clipNodes;
@@ -94,6 +96,9 @@ static Rover clipNodes;
 /// Head of the clipped regions list.
 static ClipNode *clipHead; // The head node.
 
+/// Clipped regions, when using the flat array.
+static ClipRangeArray clipRanges;
+
 /// The list of occlusion nodes.
 static Rover occNodes;
 
@@ -226,6 +231,12 @@ static void C_AddRange(binangle_t startAngle, binangle_t endAngle)
     // corresponding occlusion range.
     C_CutOcclusionRange(startAngle, endAngle);
 
+    if(devClipRangeArray)
+    {
+        clipRanges.add(startAngle, endAngle);
+        return;
+    }
+
     // If there is no head, this will be the first range.
     //LOG_AS("Clipper");
     if(!clipHead)
@@ -734,6 +745,7 @@ void C_Init()
 void C_ClearRanges()
 {
     clipHead = 0;
+    clipRanges.clear();
 
     // Rewind the rover.
     C_RoverRewind(&clipNodes);
@@ -878,6 +890,11 @@ int C_IsPointVisible(Vector3d const &point)
  */
 static int C_IsRangeVisible(binangle_t startAngle, binangle_t endAngle)
 {
+    if(devClipRangeArray)
+    {
+        return clipRanges.isRangeVisible(startAngle, endAngle);
+    }
+
     for(ClipNode *ci = clipHead; ci; ci = ci->next)
     {
         if(startAngle >= ci->start && endAngle <= ci->end)
@@ -914,6 +931,11 @@ int C_IsAngleVisible(binangle_t bang)
 {
     if(devNoCulling) return true;
 
+    if(devClipRangeArray)
+    {
+        return clipRanges.isAngleVisible(bang);
+    }
+
     for(ClipNode *ci = clipHead; ci; ci = ci->next)
     {
         if(bang > ci->start && bang < ci->end)
@@ -986,6 +1008,11 @@ int C_IsFull()
 {
     if(devNoCulling) return false;
 
+    if(devClipRangeArray)
+    {
+        return clipRanges.isFull();
+    }
+
     return clipHead && clipHead->start == 0 && clipHead->end == BANG_MAX;
 }
 
@@ -559,6 +559,18 @@ static void textFragmentDrawer(const char* fragment, int x, int y, int alignFlag
         glScalef(1.f / BitmapFont_TextureWidth(font),
                  1.f / BitmapFont_TextureHeight(font), 1.f);
     }
+    else if(Font_Type(font) == FT_BITMAPCOMPOSITE && 0 != BitmapCompositeFont_GLTextureName(font))
+    {
+        // All the glyphs are in the same atlas.
+        GL_BindTextureUnmanaged(BitmapCompositeFont_GLTextureName(font), gl::ClampToEdge,
+                                gl::ClampToEdge, filterUI? gl::Linear : gl::Nearest);
+
+        glMatrixMode(GL_TEXTURE);
+        glPushMatrix();
+        glLoadIdentity();
+        glScalef(1.f / BitmapCompositeFont_TextureWidth(font),
+                 1.f / BitmapCompositeFont_TextureHeight(font), 1.f);
+    }
 
     { int pass;
     for(pass = (noShadow? 1 : 0); pass < (noCharacter && noGlitter? 1 : 2); ++pass)
@@ -701,7 +713,8 @@ static void textFragmentDrawer(const char* fragment, int x, int y, int alignFlag
     }}
 
     // Restore previous GL-state.
-    if(Font_Type(font) == FT_BITMAP && 0 != BitmapFont_GLTextureName(font))
+    if((Font_Type(font) == FT_BITMAP && 0 != BitmapFont_GLTextureName(font)) ||
+       (Font_Type(font) == FT_BITMAPCOMPOSITE && 0 != BitmapCompositeFont_GLTextureName(font)))
     {
         glMatrixMode(GL_TEXTURE);
         glPopMatrix();
@@ -750,7 +763,15 @@ static void drawChar(unsigned char ch, int posX, int posY, font_t* font,
     case FT_BITMAPCOMPOSITE: {
         uint8_t const border = BitmapCompositeFont_CharBorder(font, ch);
 
-        GL_BindTexture(BitmapCompositeFont_CharTexture(font, ch));
+        if(DGLuint atlasName = BitmapCompositeFont_GLTextureName(font))
+        {
+            GL_BindTextureUnmanaged(atlasName, gl::ClampToEdge, gl::ClampToEdge,
+                                    filterUI? gl::Linear : gl::Nearest);
+        }
+        else
+        {
+            GL_BindTexture(BitmapCompositeFont_CharTexture(font, ch));
+        }
 
         std::memcpy(&geometry, BitmapCompositeFont_CharGeometry(font, ch), sizeof(geometry));
         if(border)
@@ -781,7 +802,7 @@ static void drawChar(unsigned char ch, int posX, int posY, font_t* font,
 
     GL_DrawRectWithCoords(&geometry, coords);
 
-    if(Font_Type(font) == FT_BITMAPCOMPOSITE)
+    if(Font_Type(font) == FT_BITMAPCOMPOSITE && !BitmapCompositeFont_GLTextureName(font))
     {
         GL_SetNoTexture();
     }
@@ -812,6 +833,11 @@ static void drawFlash(Point2Raw const *origin, Size2Raw const *size, bool bright
                                 bright? gl::One : gl::OneMinusSrcAlpha)
                   .apply();
 
+    // The texture matrix may be scaled for the font's texel coordinates.
+    glMatrixMode(GL_TEXTURE);
+    glPushMatrix();
+    glLoadIdentity();
+
     glBegin(GL_QUADS);
         glTexCoord2f(0, 0);
         glVertex2f(x, y);
@@ -823,6 +849,9 @@ static void drawFlash(Point2Raw const *origin, Size2Raw const *size, bool bright
         glVertex2f(x, y + h);
     glEnd();
 
+    glMatrixMode(GL_TEXTURE);
+    glPopMatrix();
+
     GLState::top().setBlendFunc(gl::SrcAlpha, gl::OneMinusSrcAlpha)
                   .apply();
 }
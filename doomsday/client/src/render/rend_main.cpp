@@ -29,6 +29,7 @@
 #include <de/vector1.h>
 
 #include <de/libdeng2.h>
+#include <de/Time>
 
 #include "de_base.h"
 #include "de_console.h"
@@ -212,6 +213,8 @@ byte devNoTexFix;       ///< @c 1= Draw "missing" rather than fix materials.
 byte devSectorIndices;  ///< @c 1= Draw sector indicies.
 byte devThinkerIds;     ///< @c 1= Draw (mobj) thinker indicies.
 
+byte rendInfoBsp;       ///< @c 1= Print BSP traversal statistics to the console.
+byte rendInfoLists;     ///< @c 1= Print draw list statistics to the console.
 byte rendInfoLums;      ///< @c 1= Print lumobj debug info to the console.
 byte devDrawLums;       ///< @c 1= Draw lumobjs origins.
 
@@ -232,6 +235,19 @@ static Vector3f currentSectorLightColor;
 static float currentSectorLightLevel;
 static bool firstBspLeaf; // No range checking for the first one.
 
+/// BSP traversal statistics for the current frame (see rendInfoBsp).
+static struct bsptraversalstats_s {
+    int nodesVisited;
+    int leafsVisited;
+    int leafsDrawn;
+} bspStats;
+
+/// Draw list statistics for the current frame (see rendInfoLists).
+static struct drawliststats_s {
+    int listsDrawn;
+    int textureChanges; ///< Primary texture differs from that of the previous list.
+} listStats;
+
 static void markLightGridForFullUpdate()
 {
     if(App_World().hasMap())
@@ -280,6 +296,8 @@ void Rend_Register()
     C_VAR_FLOAT ("rend-glow-scale",                 &glowHeightFactor,              0, 0.1f, 10);
     C_VAR_INT   ("rend-glow-wall",                  &useGlowOnWalls,                0, 0, 1);
 
+    C_VAR_BYTE  ("rend-info-bsp",                   &rendInfoBsp,                   0, 0, 1);
+    C_VAR_BYTE  ("rend-info-lists",                 &rendInfoLists,                 0, 0, 1);
     C_VAR_BYTE  ("rend-info-lums",                  &rendInfoLums,                  0, 0, 1);
 
     C_VAR_INT2  ("rend-light",                      &useDynLights,                  0, 0, 1, unlinkMobjLumobjs);
@@ -309,6 +327,7 @@ void Rend_Register()
 
     C_VAR_BYTE  ("rend-dev-blockmap-debug",         &bmapShowDebug,                 CVF_NO_ARCHIVE, 0, 4);
     C_VAR_FLOAT ("rend-dev-blockmap-debug-size",    &bmapDebugSize,                 CVF_NO_ARCHIVE, .1f, 100);
+    C_VAR_BYTE  ("rend-dev-clip-array",             &devClipRangeArray,             CVF_NO_ARCHIVE, 0, 1);
     C_VAR_INT   ("rend-dev-cull-leafs",             &devNoCulling,                  CVF_NO_ARCHIVE, 0, 1);
     C_VAR_BYTE  ("rend-dev-freeze",                 &freezeRLs,                     CVF_NO_ARCHIVE, 0, 1);
     C_VAR_BYTE  ("rend-dev-generator-show-indices", &devDrawGenerators,             CVF_NO_ARCHIVE, 0, 1);
@@ -2893,6 +2912,7 @@ static void traverseBspAndDrawLeafs(MapElement *bspElement)
     {
         // Descend deeper into the nodes.
         BspNode const &bspNode = bspElement->as<BspNode>();
+        bspStats.nodesVisited++;
 
         // Decide which side the view point is on.
         int eyeSide = bspNode.partition().pointOnSide(eyeOrigin) < 0;
@@ -2912,6 +2932,7 @@ static void traverseBspAndDrawLeafs(MapElement *bspElement)
 
     // We've arrived at a leaf.
     BspLeaf &bspLeaf = bspElement->as<BspLeaf>();
+    bspStats.leafsVisited++;
 
     // Skip null leafs (those with zero volume). Neighbors handle adding the
     // angle clipper ranges.
@@ -2926,6 +2947,7 @@ static void traverseBspAndDrawLeafs(MapElement *bspElement)
     makeCurrent(bspLeaf);
 
     drawCurrentLeaf();
+    bspStats.leafsDrawn++;
 
     // This is no longer the first leaf.
     firstBspLeaf = false;
@@ -3385,10 +3407,20 @@ static void drawLists(DrawLists::FoundLists const &lists, DrawMode mode)
     pushGLStateForPass(mode, texUnitMap);
 
     // Draw each given list.
+    GLuint prevTexture = 0;
     for(int i = 0; i < lists.count(); ++i)
     {
-        lists.at(i)->draw(mode, texUnitMap);
+        DrawList const *list = lists.at(i);
+        list->draw(mode, texUnitMap);
+
+        GLuint const texture = list->spec().unit(TU_PRIMARY).getTextureGLName();
+        if(i == 0 || texture != prevTexture)
+        {
+            listStats.textureChanges++;
+        }
+        prevTexture = texture;
     }
+    listStats.listsDrawn += lists.count();
 
     popGLStateForPass(mode);
 }
@@ -3714,10 +3746,27 @@ void Rend_RenderMap(Map &map)
         currentBspLeaf = 0;
 
         // Draw the world!
+        Time begunAt;
+        zap(bspStats);
+
         traverseBspAndDrawLeafs(&map.bspRoot());
+
+        if(rendInfoBsp)
+        {
+            LOG_INFO("BSP: %i nodes, %i leafs visited, %i leafs drawn in %.2f ms")
+                << bspStats.nodesVisited << bspStats.leafsVisited
+                << bspStats.leafsDrawn << (begunAt.since() * 1000);
+        }
     }
+    zap(listStats);
     drawAllLists();
 
+    if(rendInfoLists)
+    {
+        LOG_INFO("Draw lists: %i drawn, %i texture changes")
+            << listStats.listsDrawn << listStats.textureChanges;
+    }
+
     // Draw various debugging displays:
     drawAllSurfaceTangentVectors(map);
     drawLumobjs(map);
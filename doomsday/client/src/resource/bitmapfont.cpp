@@ -27,6 +27,9 @@
 
 #include <de/mathutil.h> // M_CeilPow2()
 #include <de/memory.h>
+#include <de/AtlasTexture>
+#include <QScopedPointer>
+#include <QVector>
 
 using namespace de;
 
@@ -467,6 +470,7 @@ font_t *BitmapCompositeFont_New(fontid_t bindId)
     if(!cf) Con_Error("BitmapCompositeFont::Construct: Failed on allocation of %lu bytes.", (unsigned long) sizeof(*cf));
 
     cf->_def = 0;
+    cf->_atlas = 0;
     memset(cf->_chars, 0, sizeof(cf->_chars));
 
     Font_Init(font, FT_BITMAPCOMPOSITE, bindId);
@@ -512,6 +516,130 @@ static inline texturevariantspecification_t &BitmapCompositeFont_CharSpec()
                                  0, -3, 0, false, false, false, false);
 }
 
+/**
+ * Converts processed glyph content to an image that can be placed in an atlas.
+ *
+ * @return  The image, or a null image if the content format is not supported.
+ */
+static QImage glyphImage(texturecontent_t const &content)
+{
+    int pixelSize;
+    switch(content.format)
+    {
+    case DGL_LUMINANCE:         pixelSize = 1; break;
+    case DGL_LUMINANCE_PLUS_A8: pixelSize = 2; break;
+    case DGL_RGB:               pixelSize = 3; break;
+    case DGL_RGBA:              pixelSize = 4; break;
+
+    default: return QImage();
+    }
+
+    QImage img(content.width, content.height, QImage::Format_ARGB32);
+    uint8_t const *src = content.pixels;
+    for(int y = 0; y < content.height; ++y)
+    {
+        QRgb *out = reinterpret_cast<QRgb *>(img.scanLine(y));
+        for(int x = 0; x < content.width; ++x, src += pixelSize)
+        {
+            switch(pixelSize)
+            {
+            case 1:  out[x] = qRgba(src[0], src[0], src[0], 255);    break;
+            case 2:  out[x] = qRgba(src[0], src[0], src[0], src[1]); break;
+            case 3:  out[x] = qRgba(src[0], src[1], src[2], 255);    break;
+            default: out[x] = qRgba(src[0], src[1], src[2], src[3]); break;
+            }
+        }
+    }
+    return img;
+}
+
+/**
+ * Prepares all the glyphs of the font into a single texture atlas, so that
+ * text can be drawn without changing the bound texture for each character.
+ *
+ * @return  @c true if successful. Otherwise each glyph needs its own texture.
+ */
+static bool prepareGlyphAtlas(bitmapcompositefont_t *cf)
+{
+    texturevariantspecification_t &spec = BitmapCompositeFont_CharSpec();
+
+    QVector<QImage> images(MAX_CHARS);
+    int area = 0;
+    for(int i = 0; i < MAX_CHARS; ++i)
+    {
+        bitmapcompositefont_char_t *ch = &cf->_chars[i];
+        if(0 == ch->patch) continue;
+
+        de::Texture &tex = App_Textures().scheme("Patches").findByUniqueId(ch->patch).texture();
+
+        image_t image;
+        TexSource source = GL_LoadSourceImage(image, tex, spec);
+        if(source == TEXS_NONE) return false;
+
+        texturecontent_t *content = GL_ConstructPreparedTextureContent(0, image, spec, tex.manifest());
+        images[i] = glyphImage(*content);
+        GL_DestroyTextureContent(content);
+        Image_Destroy(&image);
+
+        if(images[i].isNull()) return false;
+
+        if(source == TEXS_ORIGINAL)
+        {
+            // Upscale & Sharpen will have been applied.
+            ch->border = 1;
+        }
+
+        // Include the margin between the allocations.
+        area += (images[i].width() + 2) * (images[i].height() + 2);
+    }
+    if(!area) return false;
+
+    // Begin with a square atlas with some room to spare, and double the size
+    // if the glyphs do not fit.
+    int size = 64;
+    while(size * size < area + area / 4) size *= 2;
+
+    for(; size <= GL_state.maxTexSize; size *= 2)
+    {
+        QScopedPointer<AtlasTexture> atlas(AtlasTexture::newWithRowAllocator(
+                                               Atlas::BackingStore, Atlas::Size(size, size)));
+        bool allocated = true;
+        for(int i = 0; i < MAX_CHARS; ++i)
+        {
+            if(images[i].isNull()) continue;
+
+            Id const id = atlas->alloc(images[i]);
+            if(id.isNone())
+            {
+                allocated = false;
+                break;
+            }
+
+            Rectanglei const rect = atlas->imageRect(id);
+            bitmapcompositefont_char_t *ch = &cf->_chars[i];
+            ch->atlasRect.origin.x    = rect.topLeft.x;
+            ch->atlasRect.origin.y    = rect.topLeft.y;
+            ch->atlasRect.size.width  = rect.width();
+            ch->atlasRect.size.height = rect.height();
+        }
+        if(!allocated) continue;
+
+        // Same sampling as the separate glyph textures would have.
+        atlas->setWrap(gl::ClampToEdge, gl::ClampToEdge);
+        atlas->setMinFilter(gl::Nearest, gl::MipNone);
+
+        // Upload the content now.
+        atlas->glBindToUnit(0);
+        GL_SetNoTexture();
+
+        cf->_atlas = atlas.take();
+        return true;
+    }
+
+    LOG_DEBUG("Font glyphs do not fit in a %ix%i atlas") << GL_state.maxTexSize << GL_state.maxTexSize;
+    return false;
+}
+
 void BitmapCompositeFont_Prepare(font_t *font)
 {
     DENG_ASSERT(font && font->_type == FT_BITMAPCOMPOSITE);
@@ -535,6 +663,7 @@ void BitmapCompositeFont_Prepare(font_t *font)
         patchid_t patch = ch->patch;
         patchinfo_t info;
 
+        ch->border = 0;
         if(0 == patch) continue;
 
         R_GetPatchInfo(patch, &info);
@@ -544,21 +673,31 @@ void BitmapCompositeFont_Prepare(font_t *font)
         ch->geometry.origin.y -= font->_marginHeight;
         ch->geometry.size.width  += font->_marginWidth  * 2;
         ch->geometry.size.height += font->_marginHeight * 2;
-        ch->border = 0;
-
-        ch->tex = App_Textures().scheme("Patches").findByUniqueId(patch)
-                      .texture().prepareVariant(BitmapCompositeFont_CharSpec());
-        if(ch->tex && ch->tex->source() == TEXS_ORIGINAL)
-        {
-            // Upscale & Sharpen will have been applied.
-            ch->border = 1;
-        }
 
         avgSize.width  += ch->geometry.size.width;
         avgSize.height += ch->geometry.size.height;
         ++numPatches;
     }
 
+    if(!prepareGlyphAtlas(cf))
+    {
+        // Fall back to separate textures for each glyph.
+        for(i = 0; i < MAX_CHARS; ++i)
+        {
+            bitmapcompositefont_char_t *ch = &cf->_chars[i];
+            ch->border = 0;
+            if(0 == ch->patch) continue;
+
+            ch->tex = App_Textures().scheme("Patches").findByUniqueId(ch->patch)
+                          .texture().prepareVariant(BitmapCompositeFont_CharSpec());
+            if(ch->tex && ch->tex->source() == TEXS_ORIGINAL)
+            {
+                // Upscale & Sharpen will have been applied.
+                ch->border = 1;
+            }
+        }
+    }
+
     if(numPatches)
     {
         avgSize.width  /= numPatches;
@@ -582,6 +721,9 @@ void BitmapCompositeFont_ReleaseTextures(font_t *font)
     if(BusyMode_Active()) return;
 
     bitmapcompositefont_t *cf = (bitmapcompositefont_t *)font;
+    delete cf->_atlas;
+    cf->_atlas = 0;
+
     for(int i = 0; i < 256; ++i)
     {
         bitmapcompositefont_char_t *ch = &cf->_chars[i];
@@ -605,6 +747,30 @@ void BitmapCompositeFont_SetDefinition(font_t *font, struct ded_compositefont_s
     cf->_def = def;
 }
 
+DGLuint BitmapCompositeFont_GLTextureName(font_t *font)
+{
+    DENG_ASSERT(font && font->_type == FT_BITMAPCOMPOSITE);
+    bitmapcompositefont_t *cf = (bitmapcompositefont_t *)font;
+    BitmapCompositeFont_Prepare(font);
+    return cf->_atlas? cf->_atlas->glName() : 0;
+}
+
+int BitmapCompositeFont_TextureWidth(font_t *font)
+{
+    DENG_ASSERT(font && font->_type == FT_BITMAPCOMPOSITE);
+    bitmapcompositefont_t *cf = (bitmapcompositefont_t *)font;
+    BitmapCompositeFont_Prepare(font);
+    return cf->_atlas? cf->_atlas->totalSize().x : 0;
+}
+
+int BitmapCompositeFont_TextureHeight(font_t *font)
+{
+    DENG_ASSERT(font && font->_type == FT_BITMAPCOMPOSITE);
+    bitmapcompositefont_t *cf = (bitmapcompositefont_t *)font;
+    BitmapCompositeFont_Prepare(font);
+    return cf->_atlas? cf->_atlas->totalSize().y : 0;
+}
+
 Texture::Variant *BitmapCompositeFont_CharTexture(font_t *font, unsigned char ch)
 {
     DENG_ASSERT(font->_type == FT_BITMAPCOMPOSITE);
@@ -639,13 +805,28 @@ uint8_t BitmapCompositeFont_CharBorder(font_t *font, unsigned char chr)
     return ch->border;
 }
 
-void BitmapCompositeFont_CharCoords(font_t *font, unsigned char /*chr*/, Point2Raw coords[4])
+void BitmapCompositeFont_CharCoords(font_t *font, unsigned char chr, Point2Raw coords[4])
 {
-    DENG_ASSERT(font);
+    DENG_ASSERT(font && font->_type == FT_BITMAPCOMPOSITE);
+    bitmapcompositefont_t *cf = (bitmapcompositefont_t *)font;
     if(!coords) return;
 
     BitmapCompositeFont_Prepare(font);
 
+    if(cf->_atlas)
+    {
+        RectRaw const &rect = cf->_chars[chr].atlasRect;
+        coords[0].x = rect.origin.x;
+        coords[0].y = rect.origin.y;
+        coords[2].x = rect.origin.x + rect.size.width;
+        coords[2].y = rect.origin.y + rect.size.height;
+        coords[1].x = coords[2].x;
+        coords[1].y = coords[0].y;
+        coords[3].x = coords[0].x;
+        coords[3].y = coords[2].y;
+        return;
+    }
+
     // Top left.
     coords[0].x = 0;
     coords[0].y = 0;
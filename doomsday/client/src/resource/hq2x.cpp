@@ -20,7 +20,15 @@
  */
 
 #include <stdlib.h>
+#include <QAtomicInt>
 #include <de/memory.h>
+#include <de/math.h>
+#include <de/TaskPool>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define HQ2X_USE_SSE2
+#  include <emmintrin.h>
+#endif
 
 #include "de_platform.h"
 #include "dd_types.h"
@@ -102,6 +110,9 @@
 #define trU                 (7)
 #define trV                 (6)
 
+/// Minimum number of source pixels processed by one thread.
+#define MIN_PIXELS_PER_BAND (16384)
+
 #define PIXEL00_0         Transl(pOut,       w[5]);
 #define PIXEL00_10       Interp1(pOut,       w[5], w[1]);
 #define PIXEL00_11       Interp1(pOut,       w[5], w[4]);
@@ -152,53 +163,82 @@
 #define PIXEL11_100     Interp10(pOut+BpL+4, w[5], w[6], w[8]);
 
 static uint32_t lutBGR888toYUV888[32*64*32-1];
-static uint32_t YUV1, YUV2;
 
-void LerpColor(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t f1,
-    uint32_t f2, uint32_t f3)
+/**
+ * Blends three colors. The weights must add up to (1 << @a shift). The color
+ * components are processed two at a time, each in a 16-bit lane of a 32-bit
+ * integer; the weighted sum of a component never exceeds 16 bits.
+ */
+static __inline void LerpColor(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t f1,
+    uint32_t f2, uint32_t f3, int shift)
 {
-    uint32_t out[4] = { 0, 0, 0, 0 }, total = f1 + f2 + f3;
-    if(0 != f1)
-    {
-        out[0] += f1 * ABGR8888_COMP(0, c1);
-        out[1] += f1 * ABGR8888_COMP(1, c1);
-        out[2] += f1 * ABGR8888_COMP(2, c1);
-        out[3] += f1 * ABGR8888_COMP(3, c1);
-    }
-    if(0 != f2)
-    {
-        out[0] += f2 * ABGR8888_COMP(0, c2);
-        out[1] += f2 * ABGR8888_COMP(1, c2);
-        out[2] += f2 * ABGR8888_COMP(2, c2);
-        out[3] += f2 * ABGR8888_COMP(3, c2);
-    }
-    if(0 != f3)
-    {
-        out[0] += f3 * ABGR8888_COMP(0, c3);
-        out[1] += f3 * ABGR8888_COMP(1, c3);
-        out[2] += f3 * ABGR8888_COMP(2, c3);
-        out[3] += f3 * ABGR8888_COMP(3, c3);
-    }
-    if(0 != total)
-    {
-        out[0] /= total;
-        out[1] /= total;
-        out[2] /= total;
-        out[3] /= total;
-    }
-    *((uint32_t*)pc) = ABGR8888_PACK(out[3], out[2], out[1], out[0]);
+    uint32_t const rb = ((c1 & 0x00FF00FF) * f1 + (c2 & 0x00FF00FF) * f2 +
+                         (c3 & 0x00FF00FF) * f3) >> shift;
+    uint32_t const ag = (((c1 >> 8) & 0x00FF00FF) * f1 + ((c2 >> 8) & 0x00FF00FF) * f2 +
+                         ((c3 >> 8) & 0x00FF00FF) * f3) >> shift;
+    *((uint32_t*)pc) = (rb & 0x00FF00FF) | ((ag & 0x00FF00FF) << 8);
 }
 
 static __inline int Diff(uint32_t c1, uint32_t c2)
 {
-    YUV1 = ABGR8888toYUV888(c1);
-    YUV2 = ABGR8888toYUV888(c2);
+    uint32_t const YUV1 = ABGR8888toYUV888(c1);
+    uint32_t const YUV2 = ABGR8888toYUV888(c2);
     return ( ((ABGR8888_COMP(3, c1) != 0) != ((ABGR8888_COMP(3, c2) != 0))) ||
              (abs(int(YUV1 & YUV888_Ymask) - int(YUV2 & YUV888_Ymask)) > ((trY & (int)0xFF) << 16)) ||
              (abs(int(YUV1 & YUV888_Umask) - int(YUV2 & YUV888_Umask)) > ((trU & (int)0xFF) << 8)) ||
              (abs(int(YUV1 & YUV888_Vmask) - int(YUV2 & YUV888_Vmask)) > ((trV & (int)0xFF)) ));
 }
 
+/**
+ * Determines the key of a color used when comparing it with its neighbors:
+ * the YUV components, plus 0xFF in the alpha byte if the color is not fully
+ * transparent. Two colors are different (see Diff()) if any of the bytes of
+ * their keys differ more than the threshold of the component.
+ */
+static __inline uint32_t PatternKey(uint32_t c)
+{
+    return ABGR8888toYUV888(c) | (ABGR8888_COMP(3, c) != 0? (uint32_t)ABGR8888_Amask : 0);
+}
+
+/**
+ * Compares the key of the center pixel with the keys of its eight neighbors
+ * (w1, w2, w3, w4, w6, w7, w8, w9).
+ *
+ * @return  Pattern where bit N is set if neighbor N is different.
+ */
+static __inline int NeighborPattern(uint32_t center, uint32_t const *n)
+{
+#ifdef HQ2X_USE_SSE2
+    __m128i const thresholds = _mm_set1_epi32(AYUV8888_PACK(trY, trU, trV, 0));
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const c  = _mm_set1_epi32(center);
+    __m128i const lo = _mm_loadu_si128((__m128i const *) n);
+    __m128i const hi = _mm_loadu_si128((__m128i const *) (n + 4));
+
+    // Absolute differences of the components, less the thresholds (saturated).
+    __m128i const overLo = _mm_subs_epu8(_mm_or_si128(_mm_subs_epu8(lo, c), _mm_subs_epu8(c, lo)), thresholds);
+    __m128i const overHi = _mm_subs_epu8(_mm_or_si128(_mm_subs_epu8(hi, c), _mm_subs_epu8(c, hi)), thresholds);
+
+    int const similar = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(overLo, zero))) |
+                       (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(overHi, zero))) << 4);
+    return ~similar & 0xFF;
+#else
+    int pattern = 0;
+    for(int k = 0; k < 8; ++k)
+    {
+        uint32_t const other = n[k];
+        if(other == center) continue;
+
+        if(((center ^ other) & AYUV8888_Amask) ||
+           (abs(int(center & YUV888_Ymask) - int(other & YUV888_Ymask)) > ((trY & (int)0xFF) << 16)) ||
+           (abs(int(center & YUV888_Umask) - int(other & YUV888_Umask)) > ((trU & (int)0xFF) << 8)) ||
+           (abs(int(center & YUV888_Vmask) - int(other & YUV888_Vmask)) > ((trV & (int)0xFF) )) )
+            pattern |= 1 << k;
+    }
+    return pattern;
+#endif
+}
+
 static __inline void Transl(uint8_t* pc, uint32_t c)
 {
     pc[0] = ABGR8888_COMP(0, c);
@@ -214,32 +254,32 @@ static __inline void Interp1(uint8_t* pc, uint32_t c1, uint32_t c2)
         Transl(pc, c1);
         return;
     }
-    LerpColor(pc, c1, c2, 0, 3, 1, 0);
+    LerpColor(pc, c1, c2, 0, 3, 1, 0, 2);
 }
 
 static __inline void Interp2(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-    LerpColor(pc, c1, c2, c3, 2, 1, 1);
+    LerpColor(pc, c1, c2, c3, 2, 1, 1, 2);
 }
 
 static __inline void Interp6(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-    LerpColor(pc, c1, c2, c3, 5, 2, 1);
+    LerpColor(pc, c1, c2, c3, 5, 2, 1, 3);
 }
 
 static __inline void Interp7(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-    LerpColor(pc, c1, c2, c3, 6, 1, 1);
+    LerpColor(pc, c1, c2, c3, 6, 1, 1, 3);
 }
 
 static __inline void Interp9(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-    LerpColor(pc, c1, c2, c3, 2, 3, 3);
+    LerpColor(pc, c1, c2, c3, 2, 3, 3, 3);
 }
 
 static __inline void Interp10(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
 {
-    LerpColor(pc, c1, c2, c3, 14, 1, 1);
+    LerpColor(pc, c1, c2, c3, 14, 1, 1, 4);
 }
 
 void GL_InitSmartFilterHQ2x(void)
@@ -261,21 +301,36 @@ void GL_InitSmartFilterHQ2x(void)
             }
 }
 
-uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags)
-{
 #define BPP             (4) // Bytes Per Pixel.
-#define OFFSET(x, y)    (BPP*(y)*width + BPP*(x))
 
-    assert(src);
-    {
-    boolean wrapH = (flags & ICF_UPSCALE_SAMPLE_WRAPH) != 0;
-    boolean wrapV = (flags & ICF_UPSCALE_SAMPLE_WRAPV) != 0;
-    int pattern, flag, BpL, xA, xB, yA, yB;
-    uint8_t* pOut, *dst;
-    uint32_t w[10];
+/**
+ * Upscaling of one image. Each row of the output depends only on the source
+ * image, so bands of rows are processed concurrently.
+ */
+struct Hq2xWork : public de::TaskPool::IRangeWork
+{
+    uint32_t const *pixels; ///< Source image.
+    uint32_t const *keys;   ///< PatternKey() of each source pixel.
+    uint8_t *dst;
+    int width;
+    int height;
+    bool wrapH;
+    bool wrapV;
 
-    if(width <= 0 || height <= 0)
-        return 0;
+    /// First invalid pattern encountered, or -1. The error is raised by the
+    /// calling thread once all the bands are done.
+    QAtomicInt invalidPattern;
+
+    Hq2xWork() : invalidPattern(-1) {}
+
+    void processRange(int begin, int end);
+};
+
+void Hq2xWork::processRange(int yBegin, int yEnd)
+{
+    int const BpL = BPP * 2 * width; // (Out) Bytes per Line.
+    uint32_t w[10];
+    uint32_t n[8];
 
     // +----+----+----+
     // | w1 | w2 | w3 |
@@ -285,90 +340,33 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
     // | w7 | w8 | w9 |
     // +----+----+----+
 
-    if(0 == (dst = (uint8_t *) M_Malloc(BPP * 2 * width * height * 2)))
-        Con_Error("GL_SmartFilterHQ2x: Failed on allocation of %lu bytes for "
-                  "output buffer.", (unsigned long) (BPP * 2 * width * height * 2));
-
-    pOut = dst;
-    BpL = BPP * 2 * width; // (Out) Bytes per Line.
-    { int y;
-    for(y = 0; y < height; ++y)
+    for(int y = yBegin; y < yEnd; ++y)
     {
-        { int x;
-        for(x = 0; x < width; ++x)
-        {
-            w[5] = ULONG( *( (uint32_t*)(src + OFFSET(x, y)) ) );
-
-            // Horizontal neighbors.
-            if(wrapH)
-            {
-                w[4] = ULONG( *( (uint32_t*)(src + OFFSET(x == 0? width-1 : x-1, y)) ) );
-                w[6] = ULONG( *( (uint32_t*)(src + OFFSET(x == width-1? 0 : x+1, y)) ) );
-            }
-            else
-            {
-                if(x != 0)
-                    w[4] = ULONG( *( (uint32_t*)(src + OFFSET(x-1, y)) ) );
-                else
-                    w[4] = w[5];
-
-                if(x != width-1)
-                    w[6] = ULONG( *( (uint32_t*)(src + OFFSET(x+1, y)) ) );
-                else
-                    w[6] = w[5];
-            }
-
-            // Vertical neighbors.
-            if(wrapV)
-            {
-                w[2] = ULONG( *( (uint32_t*)(src + OFFSET(x, y == 0? height-1 : y-1)) ) );
-                w[8] = ULONG( *( (uint32_t*)(src + OFFSET(x, y == height-1? 0 : y+1)) ) );
-            }
-            else
-            {
-                if(y != 0)
-                    w[2] = ULONG( *( (uint32_t*)(src + OFFSET(x, y-1)) ) );
-                else
-                    w[2] = w[5];
+        uint8_t *pOut = dst + 2 * BpL * y;
 
-                if(y != height-1)
-                    w[8] = ULONG( *( (uint32_t*)(src + OFFSET(x, y+1)) ) );
-                else
-                    w[8] = w[5];
-            }
+        // Rows of the neighbors (w1..w3 and w7..w9).
+        int const yA =        y == 0? ( wrapV? height-1 : 0) : y-1;
+        int const yB = y == height-1? (!wrapV? height-1 : 0) : y+1;
 
-            // Corners.
-            xA =        x == 0? ( wrapH?  width-1 : 0) : x-1;
-            xB =  x == width-1? (!wrapH?  width-1 : 0) : x+1;
-            yA =        y == 0? ( wrapV? height-1 : 0) : y-1;
-            yB = y == height-1? (!wrapV? height-1 : 0) : y+1;
+        uint32_t const *rowA = pixels + width * yA, *keyA = keys + width * yA;
+        uint32_t const *row  = pixels + width * y,  *key  = keys + width * y;
+        uint32_t const *rowB = pixels + width * yB, *keyB = keys + width * yB;
 
-            w[1] = ULONG( *( (uint32_t*)(src + OFFSET(xA, yA)) ) );
-            w[7] = ULONG( *( (uint32_t*)(src + OFFSET(xA, yB)) ) );
-            w[3] = ULONG( *( (uint32_t*)(src + OFFSET(xB, yA)) ) );
-            w[9] = ULONG( *( (uint32_t*)(src + OFFSET(xB, yB)) ) );
+        for(int x = 0; x < width; ++x)
+        {
+            // Columns of the neighbors (w1, w4, w7 and w3, w6, w9).
+            int const xA =       x == 0? ( wrapH? width-1 : 0) : x-1;
+            int const xB = x == width-1? (!wrapH? width-1 : 0) : x+1;
 
-            pattern = 0;
-            flag = 1;
-            YUV1 = ABGR8888toYUV888(w[5]);
+            w[1] = ULONG(rowA[xA]); w[2] = ULONG(rowA[x]); w[3] = ULONG(rowA[xB]);
+            w[4] = ULONG(row [xA]); w[5] = ULONG(row [x]); w[6] = ULONG(row [xB]);
+            w[7] = ULONG(rowB[xA]); w[8] = ULONG(rowB[x]); w[9] = ULONG(rowB[xB]);
 
-            { int k;
-            for(k = 1; k <= 9; ++k)
-            {
-                if(k == 5)
-                    continue;
+            n[0] = keyA[xA]; n[1] = keyA[x]; n[2] = keyA[xB];
+            n[3] = key [xA];                 n[4] = key [xB];
+            n[5] = keyB[xA]; n[6] = keyB[x]; n[7] = keyB[xB];
 
-                if(w[k] != w[5])
-                {
-                    YUV2 = ABGR8888toYUV888(w[k]);
-                    if(((ABGR8888_COMP(3, w[5]) != 0) != (ABGR8888_COMP(3, w[k]) != 0)) ||
-                       (abs(int(YUV1 & YUV888_Ymask) - int(YUV2 & YUV888_Ymask)) > ((trY & (int)0xFF) << 16)) ||
-                       (abs(int(YUV1 & YUV888_Umask) - int(YUV2 & YUV888_Umask)) > ((trU & (int)0xFF) << 8)) ||
-                       (abs(int(YUV1 & YUV888_Vmask) - int(YUV2 & YUV888_Vmask)) > ((trV & (int)0xFF) )) )
-                        pattern |= flag;
-                }
-                flag <<= 1;
-            }}
+            int const pattern = NeighborPattern(key[x], n);
 
             switch(pattern)
             {
@@ -1983,17 +1981,55 @@ uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags
                     break;
               }
             default:
-                Con_Error("GL_SmartFilterHQ2x: Invalid pattern %i.", pattern);
-                break;
+                invalidPattern.testAndSetOrdered(-1, pattern);
+                return;
             }
             pOut += 2 * BPP;
-        }}
-        pOut += BpL;
-    }}
+        }
+    }
+}
 
-    return dst;
+uint8_t* GL_SmartFilterHQ2x(const uint8_t* src, int width, int height, int flags)
+{
+    assert(src);
+
+    if(width <= 0 || height <= 0)
+        return 0;
+
+    uint8_t *dst;
+    if(0 == (dst = (uint8_t *) M_Malloc(BPP * 2 * width * height * 2)))
+        Con_Error("GL_SmartFilterHQ2x: Failed on allocation of %lu bytes for "
+                  "output buffer.", (unsigned long) (BPP * 2 * width * height * 2));
+
+    // The pattern keys are needed nine times per pixel; determine them once.
+    uint32_t const *pixels = (uint32_t const *) src;
+    uint32_t *keys = (uint32_t *) M_Malloc(sizeof(*keys) * width * height);
+    for(int i = 0; i < width * height; ++i)
+    {
+        keys[i] = PatternKey(ULONG(pixels[i]));
     }
 
-#undef OFFSET
-#undef BPP
+    Hq2xWork work;
+    work.pixels = pixels;
+    work.keys   = keys;
+    work.dst    = dst;
+    work.width  = width;
+    work.height = height;
+    work.wrapH  = (flags & ICF_UPSCALE_SAMPLE_WRAPH) != 0;
+    work.wrapV  = (flags & ICF_UPSCALE_SAMPLE_WRAPV) != 0;
+
+    // Small images are not worth the overhead of additional threads.
+    de::TaskPool::parallelFor(work, height, de::max(1, MIN_PIXELS_PER_BAND / width));
+
+    M_Free(keys);
+
+    int const invalidPattern = work.invalidPattern.fetchAndAddOrdered(0);
+    if(invalidPattern >= 0)
+    {
+        M_Free(dst);
+        Con_Error("GL_SmartFilterHQ2x: Invalid pattern %i.", invalidPattern);
+    }
+    return dst;
 }
+
+#undef BPP
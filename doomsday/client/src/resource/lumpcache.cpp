@@ -0,0 +1,121 @@
+/** @file lumpcache.cpp  Data cache tailored to storing lumps (i.e., files).
+ *
+ * @authors Copyright &copy; 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "de_base.h"
+
+#include "resource/lumpcache.h"
+
+int lumpCacheBudget = 0;
+
+LumpCache::CacheRecord* LumpCache::lruHead;
+LumpCache::CacheRecord* LumpCache::lruTail;
+LumpCache::Stats LumpCache::stats_;
+
+void LumpCache::CacheRecord::touch()
+{
+    if(linked)
+    {
+        if(!lruNext) return; // Already the most recently used.
+
+        // Detach from the current position.
+        if(lruPrev) lruPrev->lruNext = lruNext;
+        else        lruHead = lruNext;
+        lruNext->lruPrev = lruPrev;
+    }
+    else
+    {
+        linked = true;
+        stats_.bytes += size_;
+        stats_.peakBytes = MAX_OF(stats_.peakBytes, stats_.bytes);
+    }
+
+    // Append to the most recently used end.
+    lruPrev = lruTail;
+    lruNext = 0;
+    if(lruTail) lruTail->lruNext = this;
+    else        lruHead = this;
+    lruTail = this;
+}
+
+void LumpCache::CacheRecord::unlink()
+{
+    if(!linked) return;
+
+    if(lruPrev) lruPrev->lruNext = lruNext;
+    else        lruHead = lruNext;
+    if(lruNext) lruNext->lruPrev = lruPrev;
+    else        lruTail = lruPrev;
+
+    lruPrev = lruNext = 0;
+    linked = false;
+    stats_.bytes -= size_;
+}
+
+bool LumpCache::CacheRecord::evict()
+{
+    if(data_)
+    {
+        // Locked data is in use.
+        if(Z_GetTag(data_) != PU_PURGELEVEL) return false;
+
+        Z_Free(data_);
+        data_ = 0;
+
+        stats_.evictions++;
+        stats_.evictedBytes += size_;
+    }
+    // Otherwise the data was already purged by the Zone.
+
+    unlink();
+    return true;
+}
+
+void LumpCache::enforceBudget()
+{
+    if(lumpCacheBudget <= 0) return;
+
+    size_t const budget = size_t(lumpCacheBudget) * 1024 * 1024;
+
+    CacheRecord* record = lruHead;
+    while(record && stats_.bytes > budget)
+    {
+        CacheRecord* next = record->lruNext;
+        record->evict();
+        record = next;
+    }
+}
+
+LumpCache::Stats const& LumpCache::stats()
+{
+    // Forget the data that has been purged by the Zone.
+    CacheRecord* record = lruHead;
+    while(record)
+    {
+        CacheRecord* next = record->lruNext;
+        if(!record->data_) record->unlink();
+        record = next;
+    }
+    return stats_;
+}
+
+void LumpCache::countLookup(bool hit)
+{
+    if(hit) stats_.hits++;
+    else    stats_.misses++;
+}
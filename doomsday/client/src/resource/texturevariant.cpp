@@ -18,7 +18,12 @@
  * 02110-1301 USA</small>
  */
 
+#include <de/Guard>
+#include <de/Lockable>
 #include <de/Log>
+#include <de/Task>
+#include <de/TaskPool>
+#include <de/Waitable>
 #include <de/mathutil.h> // M_CeilPow
 #include "de_base.h"
 #include "r_util.h"
@@ -83,6 +88,118 @@ int TextureVariantSpec_Compare(texturevariantspecification_t const *a,
     throw Error("TextureVariantSpec_Compare", QString("Invalid type %1").arg(a->type));
 }
 
+/**
+ * Preparation of a texture variant in a background thread. The source image is
+ * loaded in the main thread beforehand, as the file system is not thread-safe.
+ * A worker then prepares the image in accordance with the specification and
+ * processes the content for uploading. Finally, the main thread uploads the
+ * content to GL.
+ *
+ * A preparation that is cancelled before its task has started is deleted by
+ * the task, so that cancelling does not need to wait for other preparations.
+ * Otherwise the task posts the preparation as its last access to it, and the
+ * main thread must wait() for that before deleting the preparation.
+ */
+struct BackgroundPreparation : public Lockable, public Waitable
+{
+    enum State { Queued, Running, Done, Cancelled };
+
+    texturevariantspecification_t const &spec;
+    TextureManifest const &manifest;
+    DGLuint glTexName;
+    image_t image;
+    texturecontent_t *processed; ///< Ready for uploading (owned).
+    State state;
+
+    BackgroundPreparation(texturevariantspecification_t const &spec, TextureManifest const &manifest,
+                          DGLuint glTexName, image_t const &image)
+        : spec(spec), manifest(manifest), glTexName(glTexName), image(image),
+          processed(0), state(Queued)
+    {}
+
+    ~BackgroundPreparation()
+    {
+        if(processed) GL_DestroyTextureContent(processed);
+        Image_Destroy(&image);
+    }
+
+    bool isDone()
+    {
+        DENG2_GUARD(this);
+        return state == Done;
+    }
+
+    /**
+     * Deletes a started preparation once its task has finished with it.
+     * Afterwards the preparation must not be accessed by the caller.
+     */
+    void release()
+    {
+        wait(); // Until posted by the task.
+        delete this;
+    }
+
+    /**
+     * Gives up the preparation. Only waits if the preparation has been
+     * started. Afterwards the preparation must not be accessed by the caller.
+     */
+    void cancel()
+    {
+        {
+            DENG2_GUARD(this);
+            if(state == Queued)
+            {
+                // The task deletes the preparation.
+                state = Cancelled;
+                return;
+            }
+        }
+        release();
+    }
+};
+
+class BackgroundPreparationTask : public Task
+{
+public:
+    BackgroundPreparationTask(BackgroundPreparation &prep) : _prep(prep) {}
+
+    void runTask()
+    {
+        bool cancelled;
+        {
+            DENG2_GUARD(_prep);
+            cancelled = (_prep.state == BackgroundPreparation::Cancelled);
+            if(!cancelled) _prep.state = BackgroundPreparation::Running;
+        }
+        if(cancelled)
+        {
+            delete &_prep;
+            return;
+        }
+
+        texturecontent_t *processed =
+                GL_ConstructPreparedTextureContent(_prep.glTexName, _prep.image,
+                                                   _prep.spec, _prep.manifest);
+        {
+            DENG2_GUARD(_prep);
+            _prep.processed = processed;
+            _prep.state = BackgroundPreparation::Done;
+        }
+        // The preparation may be deleted as soon as it has been posted.
+        _prep.post();
+    }
+
+private:
+    BackgroundPreparation &_prep;
+};
+
+/// Workers for the background preparations of all variants.
+static TaskPool &backgroundPreparations()
+{
+    static TaskPool pool;
+    return pool;
+}
+
 DENG2_PIMPL(Texture::Variant)
 {
     /// Superior Texture of which this is a derivative.
@@ -103,6 +220,9 @@ DENG2_PIMPL(Texture::Variant)
     /// Prepared coordinates for the bottom right of the texture minus border.
     float s, t;
 
+    /// Preparation underway in the background (if any).
+    BackgroundPreparation *preparing;
+
     Instance(Public *i, Texture &generalCase,
              texturevariantspecification_t const &spec) : Base(i),
       texture(generalCase),
@@ -111,8 +231,108 @@ DENG2_PIMPL(Texture::Variant)
       texSource(TEXS_NONE),
       glTexName(0),
       s(0),
-      t(0)
+      t(0),
+      preparing(0)
     {}
+
+    ~Instance()
+    {
+        cancelBackgroundPreparation();
+    }
+
+    /**
+     * Determines whether the variant can be prepared in the background. Until
+     * the preparation is finished, the variant has no GL texture. The variants
+     * of map surface materials qualify because the materials are prepared
+     * again each frame (see MaterialSnapshot).
+     */
+    bool canPrepareInBackground() const
+    {
+        if(!prepareTexturesAsync || novideo || BusyMode_Active())
+            return false;
+
+        if(spec.type != TST_GENERAL || TS_GENERAL(spec).context != TC_MAPSURFACE_DIFFUSE)
+            return false;
+
+        // The logical dimensions are needed before the image is ready.
+        return texture.width() != 0 && texture.height() != 0;
+    }
+
+    void startBackgroundPreparation(image_t const &image)
+    {
+        DENG2_ASSERT(!preparing);
+
+        preparing = new BackgroundPreparation(spec, texture.manifest(),
+                                              GL_GetReservedTextureName(), image);
+        backgroundPreparations().start(new BackgroundPreparationTask(*preparing));
+    }
+
+    /// @return  GL name of the uploaded texture.
+    uint finishBackgroundPreparation()
+    {
+        DENG2_ASSERT(preparing && preparing->isDone());
+
+        glTexName = preparing->glTexName;
+        applyPreparedContent(*preparing->processed, preparing->image);
+        GL_UploadTextureContent(*preparing->processed, Immediate);
+
+        preparing->release();
+        preparing = 0;
+        return glTexName;
+    }
+
+    void cancelBackgroundPreparation()
+    {
+        if(!preparing) return;
+
+        preparing->cancel();
+        preparing = 0;
+    }
+
+    /**
+     * Updates the properties of the variant that depend on the prepared
+     * texture content.
+     *
+     * @param c      Prepared texture content.
+     * @param image  Prepared image.
+     */
+    void applyPreparedContent(texturecontent_t const &c, image_t const &image)
+    {
+        /**
+         * Calculate GL texture coordinates based on the image dimensions. The
+         * coordinates are calculated as width / CeilPow2(width), or 1 if larger
+         * than the maximum texture size.
+         *
+         * @todo fixme: Image dimensions may not be the same as the uploaded
+         * texture - defer this logic until all processing has been completed.
+         */
+        if((c.flags & TXCF_UPLOAD_ARG_NOSTRETCH) &&
+           (!GL_state.features.texNonPowTwo || (c.flags & TXCF_MIPMAP)))
+        {
+            s =  image.size.width / float( M_CeilPow2(image.size.width) );
+            t = image.size.height / float( M_CeilPow2(image.size.height) );
+        }
+        else
+        {
+            s = 1;
+            t = 1;
+        }
+
+        if(image.flags & IMGF_IS_MASKED)
+            flags |= TextureVariant::Masked;
+
+        // Are we setting the logical dimensions to the pixel dimensions
+        // of the source image?
+        if(texture.width() == 0 && texture.height() == 0)
+        {
+            Vector2i dimensions = Image_Dimensions(&image);
+
+            LOG_DEBUG("World dimensions for \"%s\" taken from image pixels %s.")
+                << texture.manifest().composeUri() << dimensions.asText();
+
+            texture.setDimensions(dimensions);
+        }
+    }
 };
 
 Texture::Variant::Variant(Texture &generalCase, texturevariantspecification_t const &spec)
@@ -325,6 +545,15 @@ uint Texture::Variant::prepare()
     if(isPrepared())
         return d->glTexName;
 
+    // Is the preparation underway in the background?
+    if(d->preparing)
+    {
+        if(!d->preparing->isDone())
+            return 0;
+
+        return d->finishBackgroundPreparation();
+    }
+
     // Load the source image data.
     image_t image;
     TexSource source = GL_LoadSourceImage(image, d->texture, d->spec);
@@ -338,47 +567,38 @@ uint Texture::Variant::prepare()
                              d->texture, true /*force update*/);
     }
 
-    // Are we preparing a new GL texture?
-    if(d->glTexName == 0)
-    {
-        // Acquire a new GL texture name.
-        d->glTexName = GL_GetReservedTextureName();
+    // Record the source of the image.
+    d->texSource = source;
 
-        // Record the source of the image.
-        d->texSource = source;
+    if(d->canPrepareInBackground())
+    {
+        // Ownership of the image is given to the preparation.
+        d->startBackgroundPreparation(image);
+        return 0;
     }
 
+    // Acquire a new GL texture name.
+    d->glTexName = GL_GetReservedTextureName();
+
     // Prepare texture content for uploading.
-    texturecontent_t c;
-    GL_PrepareTextureContent(c, d->glTexName, image, d->spec, d->texture.manifest());
+    texturecontent_t *c = GL_ConstructPreparedTextureContent(d->glTexName, image, d->spec,
+                                                             d->texture.manifest());
 
-    /**
-     * Calculate GL texture coordinates based on the image dimensions. The
-     * coordinates are calculated as width / CeilPow2(width), or 1 if larger
-     * than the maximum texture size.
-     *
-     * @todo fixme: Image dimensions may not be the same as the uploaded
-     * texture - defer this logic until all processing has been completed.
-     */
-    if((c.flags & TXCF_UPLOAD_ARG_NOSTRETCH) &&
-       (!GL_state.features.texNonPowTwo || (c.flags & TXCF_MIPMAP)))
+    d->applyPreparedContent(*c, image);
+
+    // Submit the content for uploading (possibly deferred).
+    GLUploadMethod uploadMethod = GL_ChooseUploadMethod(*c);
+    if(uploadMethod == Deferred)
     {
-        d->s =  image.size.width / float( M_CeilPow2(image.size.width) );
-        d->t = image.size.height / float( M_CeilPow2(image.size.height) );
+        // Ownership of the content is given to the deferred task.
+        GL_DeferTextureContentUpload(c);
     }
     else
     {
-        d->s = 1;
-        d->t = 1;
+        GL_UploadTextureContent(*c, uploadMethod);
+        GL_DestroyTextureContent(c);
     }
 
-    if(image.flags & IMGF_IS_MASKED)
-        d->flags |= TextureVariant::Masked;
-
-    // Submit the content for uploading (possibly deferred).
-    GLUploadMethod uploadMethod = GL_ChooseUploadMethod(c);
-    GL_UploadTextureContent(c, uploadMethod);
-
 #ifdef DENG_DEBUG
     LOG_DEBUG("Prepared \"%s\" variant (glName:%u)%s")
         << d->texture.manifest().composeUri() << uint(d->glTexName)
@@ -387,18 +607,6 @@ uint Texture::Variant::prepare()
     LOG_TRACE("  Specification [%p]: %s") << de::dintptr(&d->spec) << d->spec.asText();
 #endif
 
-    // Are we setting the logical dimensions to the pixel dimensions
-    // of the source image?
-    if(d->texture.width() == 0 && d->texture.height() == 0)
-    {
-        Vector2i dimensions = Image_Dimensions(&image);
-
-        LOG_DEBUG("World dimensions for \"%s\" taken from image pixels %s.")
-            << d->texture.manifest().composeUri() << dimensions.asText();
-
-        d->texture.setDimensions(dimensions);
-    }
-
     // We're done with the image data.
     Image_Destroy(&image);
 
@@ -407,6 +615,14 @@ uint Texture::Variant::prepare()
 
 void Texture::Variant::release()
 {
+    if(d->preparing)
+    {
+        // A name was reserved for the preparation.
+        DGLuint const name = d->preparing->glTexName;
+        d->cancelBackgroundPreparation();
+        glDeleteTextures(1, (GLuint const *) &name);
+    }
+
     if(!isPrepared()) return;
 
     glDeleteTextures(1, (GLuint const *) &d->glTexName);
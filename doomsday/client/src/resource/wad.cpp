@@ -466,11 +466,21 @@ uint8_t const *Wad::cacheLump(int lumpIdx)
     uint8_t const *data = d->lumpCache->data(lumpIdx);
     if(data) return data;
 
+    // The lump can be used directly in the mapped file. The view stays valid
+    // while the file is open, so locking it is unnecessary.
+    if(fileMapLumps)
+    {
+        if(uint8_t const *mapped = handle_->map(file.info().baseOffset, file.info().size))
+        {
+            return mapped;
+        }
+    }
+
     uint8_t * region = (uint8_t *) Z_Malloc(file.info().size, PU_APPSTATIC, 0);
     if(!region) throw Error("Wad::cacheLump", QString("Failed on allocation of %1 bytes for cache copy of lump #%2").arg(file.info().size).arg(lumpIdx));
 
     readLump(lumpIdx, region, false);
-    d->lumpCache->insert(lumpIdx, region);
+    d->lumpCache->insert(lumpIdx, region, file.info().size);
 
     return region;
 }
@@ -522,7 +532,7 @@ size_t Wad::readLump(int lumpIdx, uint8_t *buffer, size_t startOffset,
     // Try to avoid a file system read by checking for a cached copy.
     if(tryCache)
     {
-        uint8_t const *data = d->lumpCache? d->lumpCache->data(lumpIdx) : 0;
+        uint8_t const *data = d->lumpCache? d->lumpCache->peek(lumpIdx) : 0;
         LOG_TRACE("Cache %s on #%i") << (data? "hit" : "miss") << lumpIdx;
         if(data)
         {
@@ -532,6 +542,15 @@ size_t Wad::readLump(int lumpIdx, uint8_t *buffer, size_t startOffset,
         }
     }
 
+    if(fileMapLumps)
+    {
+        if(uint8_t const *mapped = handle_->map(file.info().baseOffset + startOffset, length))
+        {
+            std::memcpy(buffer, mapped, length);
+            return length;
+        }
+    }
+
     handle_->seek(file.info().baseOffset + startOffset, SeekSet);
     size_t readBytes = handle_->read(buffer, length);
 
@@ -34,6 +34,8 @@
 #include <de/PathTree>
 #include <de/NativePath>
 #include <de/Log>
+#include <de/Task>
+#include <de/TaskPool>
 #include <de/memory.h>
 #include <de/memoryzone.h>
 
@@ -236,12 +238,47 @@ struct Zip::Instance
     /// Lump data cache.
     LumpCache* lumpCache;
 
+    /// A lump being decompressed in the background (see Zip::prefetchLumps()).
+    struct PrefetchedLump
+    {
+        int lumpIdx;
+        uint8_t* compressedData;
+        size_t compressedSize;
+        bool ownsCompressedData; ///< Otherwise points to the mapped file.
+        uint8_t* data;
+        size_t size;
+        bool ok;
+    };
+    typedef QList<PrefetchedLump*> PrefetchedLumps;
+
+    class InflateTask : public Task
+    {
+    public:
+        InflateTask(PrefetchedLump& lump) : _lump(lump) {}
+
+        void runTask()
+        {
+            _lump.ok = uncompressRaw(_lump.compressedData, _lump.compressedSize, _lump.data, _lump.size);
+        }
+
+    private:
+        PrefetchedLump& _lump;
+    };
+
+    /// Decompression tasks of this package. The tasks are run by the threads
+    /// shared by all TaskPools; a pool per package lets finishPrefetch() wait
+    /// for this package's tasks only.
+    TaskPool prefetchTasks;
+    PrefetchedLumps prefetched;
+
     Instance(Zip* d)
         : self(d), lumpDirectory(0), lumpNodeLut(0), lumpCache(0)
     {}
 
     ~Instance()
     {
+        finishPrefetch();
+
         if(lumpDirectory)
         {
             lumpDirectory->traverse(PathTree::NoBranch, NULL, PathTree::no_hash, clearZipFileWorker);
@@ -501,6 +538,54 @@ struct Zip::Instance
         lumpDirectory->traverse(PathTree::NoBranch, NULL, PathTree::no_hash, buildLumpNodeLutWorker, (void*)this);
     }
 
+    bool isPrefetching(int lumpIdx) const
+    {
+        DENG2_FOR_EACH_CONST(PrefetchedLumps, i, prefetched)
+        {
+            if((*i)->lumpIdx == lumpIdx) return true;
+        }
+        return false;
+    }
+
+    /**
+     * Insert the lumps decompressed in the background into the cache. If
+     * @a lumpIdx is still being decompressed, or is @c -1, first waits for all
+     * the decompression to finish; otherwise unfinished work is left running.
+     */
+    void finishPrefetch(int lumpIdx = -1)
+    {
+        if(prefetched.isEmpty()) return;
+
+        if(!prefetchTasks.isDone())
+        {
+            if(lumpIdx >= 0 && !isPrefetching(lumpIdx)) return;
+            prefetchTasks.waitForDone();
+        }
+
+        DENG2_FOR_EACH(PrefetchedLumps, i, prefetched)
+        {
+            PrefetchedLump* lump = *i;
+            if(lump->ok)
+            {
+                if(!lumpCache)
+                {
+                    lumpCache = new LumpCache(self->lumpCount());
+                }
+                // Nobody is using the data yet.
+                lumpCache->insert(lump->lumpIdx, lump->data, lump->size);
+                lumpCache->unlock(lump->lumpIdx);
+            }
+            else
+            {
+                Z_Free(lump->data);
+            }
+
+            if(lump->ownsCompressedData) M_Free(lump->compressedData);
+            delete lump;
+        }
+        prefetched.clear();
+    }
+
     /**
      * @param lump      Lump/file to be buffered.
      * @param buffer    Must be large enough to hold the entire uncompressed data lump.
@@ -511,6 +596,26 @@ struct Zip::Instance
         LOG_AS("Zip");
 
         FileInfo const& lumpInfo = lump.info();
+
+        if(fileMapLumps)
+        {
+            // Decompress or copy straight from the mapped file.
+            size_t const storedSize = lumpInfo.isCompressed()? lumpInfo.compressedSize : lumpInfo.size;
+            if(uint8_t const* mapped = self->handle_->map(lumpInfo.baseOffset, storedSize))
+            {
+                if(lumpInfo.isCompressed())
+                {
+                    if(!uncompressRaw(const_cast<uint8_t*>(mapped), storedSize, buffer, lumpInfo.size))
+                        return 0; // Inflate failed.
+                }
+                else
+                {
+                    memcpy(buffer, mapped, lumpInfo.size);
+                }
+                return lumpInfo.size;
+            }
+        }
+
         self->handle_->seek(lumpInfo.baseOffset, SeekSet);
 
         if(lumpInfo.isCompressed())
@@ -593,6 +698,8 @@ void Zip::clearCachedLump(int lumpIdx, bool* retCleared)
 
     if(isValidIndex(lumpIdx))
     {
+        d->finishPrefetch(lumpIdx);
+
         if(d->lumpCache)
         {
             d->lumpCache->remove(lumpIdx, retCleared);
@@ -612,6 +719,7 @@ void Zip::clearCachedLump(int lumpIdx, bool* retCleared)
 void Zip::clearLumpCache()
 {
     LOG_AS("Zip::clearLumpCache");
+    d->finishPrefetch();
     if(d->lumpCache) d->lumpCache->clear();
 }
 
@@ -621,6 +729,8 @@ uint8_t const* Zip::cacheLump(int lumpIdx)
 
     if(!isValidIndex(lumpIdx)) throw NotFoundError("Zip::cacheLump", invalidIndexMessage(lumpIdx, lastIndex()));
 
+    d->finishPrefetch(lumpIdx);
+
     ZipFile& file = reinterpret_cast<ZipFile&>(lump(lumpIdx));
     LOG_TRACE("\"%s:%s\" (%u bytes%s)")
         << de::NativePath(composePath()).pretty()
@@ -637,15 +747,82 @@ uint8_t const* Zip::cacheLump(int lumpIdx)
     uint8_t const* data = d->lumpCache->data(lumpIdx);
     if(data) return data;
 
+    // Stored (uncompressed) lumps can be used directly in the mapped file. The
+    // view stays valid while the file is open, so locking it is unnecessary.
+    // Deflated lumps must still be inflated into the cache.
+    if(fileMapLumps && !file.info().isCompressed())
+    {
+        if(uint8_t const* mapped = handle_->map(file.info().baseOffset, file.info().size))
+        {
+            return mapped;
+        }
+    }
+
     uint8_t* region = (uint8_t*) Z_Malloc(file.info().size, PU_APPSTATIC, 0);
     if(!region) throw Error("Zip::cacheLump", QString("Failed on allocation of %1 bytes for cache copy of lump #%2").arg(file.info().size).arg(lumpIdx));
 
     readLump(lumpIdx, region, false);
-    d->lumpCache->insert(lumpIdx, region);
+    d->lumpCache->insert(lumpIdx, region, file.info().size);
 
     return region;
 }
 
+void Zip::prefetchLumps(QList<int> const& lumpIdxs)
+{
+    LOG_AS("Zip::prefetchLumps");
+
+    DENG2_FOR_EACH_CONST(QList<int>, i, lumpIdxs)
+    {
+        int const lumpIdx = *i;
+        if(!isValidIndex(lumpIdx)) continue;
+
+        ZipFile const& file = reinterpret_cast<ZipFile&>(lump(lumpIdx));
+        FileInfo const& info = file.info();
+
+        // Stored lumps need no decompression.
+        if(!info.isCompressed()) continue;
+        if(d->isPrefetching(lumpIdx)) continue;
+        if(d->lumpCache && d->lumpCache->contains(lumpIdx)) continue;
+
+        // The file is read in this thread; only the decompression is done
+        // in the background.
+        uint8_t* compressedData = 0;
+        bool ownsCompressedData = false;
+        if(fileMapLumps)
+        {
+            compressedData = const_cast<uint8_t*>(handle_->map(info.baseOffset, info.compressedSize));
+        }
+        if(!compressedData)
+        {
+            compressedData = (uint8_t*) M_Malloc(info.compressedSize);
+            if(!compressedData) throw Error("Zip::prefetchLumps", QString("Failed on allocation of %1 bytes for decompression buffer").arg(info.compressedSize));
+            ownsCompressedData = true;
+
+            handle_->seek(info.baseOffset, SeekSet);
+            if(handle_->read(compressedData, info.compressedSize) < info.compressedSize)
+            {
+                M_Free(compressedData);
+                continue;
+            }
+        }
+
+        uint8_t* region = (uint8_t*) Z_Malloc(info.size, PU_APPSTATIC, 0);
+        if(!region) throw Error("Zip::prefetchLumps", QString("Failed on allocation of %1 bytes for cache copy of lump #%2").arg(info.size).arg(lumpIdx));
+
+        Instance::PrefetchedLump* prefetch = new Instance::PrefetchedLump;
+        prefetch->lumpIdx            = lumpIdx;
+        prefetch->compressedData     = compressedData;
+        prefetch->compressedSize     = info.compressedSize;
+        prefetch->ownsCompressedData = ownsCompressedData;
+        prefetch->data               = region;
+        prefetch->size               = info.size;
+        prefetch->ok                 = false;
+        d->prefetched.append(prefetch);
+
+        d->prefetchTasks.start(new Instance::InflateTask(*prefetch));
+    }
+}
+
 void Zip::unlockLump(int lumpIdx)
 {
     LOG_AS("Zip::unlockLump");
@@ -682,6 +859,8 @@ size_t Zip::readLump(int lumpIdx, uint8_t* buffer, size_t startOffset,
     LOG_AS("Zip::readLump");
     ZipFile const& file = reinterpret_cast<ZipFile&>(lump(lumpIdx));
 
+    if(tryCache) d->finishPrefetch(lumpIdx);
+
     LOG_TRACE("\"%s:%s\" (%u bytes%s) [%u +%u]")
         << de::NativePath(composePath()).pretty()
         << de::NativePath(file.composePath()).pretty()
@@ -693,7 +872,7 @@ size_t Zip::readLump(int lumpIdx, uint8_t* buffer, size_t startOffset,
     // Try to avoid a file system read by checking for a cached copy.
     if(tryCache)
     {
-        uint8_t const* data = d->lumpCache? d->lumpCache->data(lumpIdx) : 0;
+        uint8_t const* data = d->lumpCache? d->lumpCache->peek(lumpIdx) : 0;
         LOG_TRACE("Cache %s on #%i") << (data? "hit" : "miss") << lumpIdx;
         if(data)
         {
@@ -704,7 +883,19 @@ size_t Zip::readLump(int lumpIdx, uint8_t* buffer, size_t startOffset,
     }
 
     size_t readBytes;
-    if(!startOffset && length == file.size())
+    uint8_t const* mapped = 0;
+    if(fileMapLumps && !file.isCompressed() && startOffset <= file.size())
+    {
+        mapped = handle_->map(file.info().baseOffset + startOffset, MIN_OF(file.size() - startOffset, length));
+    }
+
+    if(mapped)
+    {
+        // Copy only the requested section from the mapped file.
+        readBytes = MIN_OF(file.size() - startOffset, length);
+        memcpy(buffer, mapped, readBytes);
+    }
+    else if(!startOffset && length == file.size())
     {
         // Read it straight to the caller's data buffer.
         readBytes = d->bufferLump(file, buffer);
@@ -20,8 +20,11 @@
  */
 
 #include <cmath>
+#include <new>
 
-#include <de/memoryzone.h>
+#include <QVector>
+
+#include <de/memoryarena.h>
 #include <de/vector1.h>
 
 #include <de/Vector>
@@ -65,21 +68,21 @@ struct CellData
         }
     }
 
-    bool link(void *elem)
+    bool link(void *elem, memoryarena_t *arena)
     {
-        addElement(newNode(), elem);
+        addElement(newNode(arena), elem);
         return true;
     }
 
 private:
-    RingNode &newNode()
+    RingNode &newNode(memoryarena_t *arena)
     {
         RingNode *node = 0;
 
         if(!ringNodes)
         {
             // Create a new root node.
-            node = (RingNode *) Z_Malloc(sizeof(*node), PU_MAP, 0);
+            node = (RingNode *) MemoryArena_Allocate(arena, sizeof(*node));
             node->next = 0;
             node->prev = 0;
             node->elem = 0;
@@ -98,7 +101,7 @@ private:
         }
 
         // Add a new node to the ring.
-        node->next = (RingNode *) Z_Malloc(sizeof(*node), PU_MAP, 0);
+        node->next = (RingNode *) MemoryArena_Allocate(arena, sizeof(*node));
         node->next->next = 0;
         node->next->prev = node;
         node->next->elem = 0;
@@ -132,6 +135,9 @@ private:
     }
 };
 
+/// Size of the memory blocks from which the blockmap's data is allocated.
+static size_t const ARENA_BLOCK_SIZE = 32 * 1024;
+
 template <typename Type>
 Type ceilPow2(Type unit)
 {
@@ -174,14 +180,6 @@ DENG2_PIMPL(Blockmap)
             zap(children);
         }
 
-        ~Node()
-        {
-            if(isLeaf())
-            {
-                Z_Free(leafData);
-            }
-        }
-
         /**
          * Returns @c true iff the cell is a leaf (i.e., equal to a unit in the
          * gridmap coordinate space).
@@ -204,23 +202,32 @@ DENG2_PIMPL(Blockmap)
             }
         }
     };
-    typedef QList<Node> Nodes;
-
     AABoxd bounds;    ///< Map space units.
     uint cellSize;    ///< Map space units.
     Cell dimensions;  ///< Dimensions of the indexed space, in cells.
 
-    Nodes nodes;      ///< Quadtree nodes. The first being the root.
+    /// Quadtree nodes, cell data and element rings are allocated from here.
+    /// None of them are freed before the blockmap itself is destroyed.
+    memoryarena_t *arena;
+
+    Node *root;       ///< Root of the quadtree.
+    QVector<Node *> dataLeafs; ///< Leaf nodes with cell data.
 
     Instance(Public *i, AABoxd const &bounds, uint cellSize)
         : Base(i),
           bounds(bounds),
           cellSize(cellSize),
           dimensions(Vector2ui(de::ceil((bounds.maxX - bounds.minX) / cellSize),
-                               de::ceil((bounds.maxY - bounds.minY) / cellSize)))
+                               de::ceil((bounds.maxY - bounds.minY) / cellSize))),
+          arena(MemoryArena_New(ARENA_BLOCK_SIZE))
     {
         // Quadtree must subdivide the space equally into 1x1 unit cells.
-        newNode(Cell(0, 0), ceilPow2(de::max(dimensions.x, dimensions.y)));
+        root = newNode(Cell(0, 0), ceilPow2(de::max(dimensions.x, dimensions.y)));
+    }
+
+    ~Instance()
+    {
+        MemoryArena_Delete(arena);
     }
 
     inline int toCellIndex(uint cellX, uint cellY)
@@ -312,8 +319,7 @@ DENG2_PIMPL(Blockmap)
 
     Node *newNode(Cell const &at, uint size)
     {
-        nodes.append(Node(at, size));
-        return &nodes.last();
+        return new (MemoryArena_Allocate(arena, sizeof(Node))) Node(at, size);
     }
 
     Node *findLeaf(Node *node, Cell const &at, bool canSubdivide)
@@ -355,7 +361,7 @@ DENG2_PIMPL(Blockmap)
 
     inline Node *findLeaf(Cell const &at, bool canCreate = false)
     {
-        return findLeaf(&nodes.first(), at, canCreate);
+        return findLeaf(root, at, canCreate);
     }
 
     /**
@@ -386,7 +392,8 @@ DENG2_PIMPL(Blockmap)
                 // Can we allocate new user data?
                 if(canCreate)
                 {
-                    node->leafData = (CellData *)Z_Calloc(sizeof(CellData), PU_MAPSTATIC, 0);
+                    node->leafData = (CellData *) MemoryArena_Calloc(arena, sizeof(CellData));
+                    dataLeafs.append(node);
                 }
             }
             return node->leafData;
@@ -450,7 +457,7 @@ bool Blockmap::link(Cell const &cell, void *elem)
 
     if(CellData *cellData = d->cellData(cell, true /*can create*/))
     {
-        return cellData->link(elem);
+        return cellData->link(elem, d->arena);
     }
     return false; // Outside the blockmap?
 }
@@ -470,7 +477,7 @@ bool Blockmap::link(AABoxd const &region, void *elem)
     {
         if(CellData *cellData = d->cellData(cell, true))
         {
-            if(cellData->link(elem))
+            if(cellData->link(elem, d->arena))
             {
                 didLink = true;
             }
@@ -518,15 +525,9 @@ bool Blockmap::unlink(AABoxd const &region, void *elem)
 
 void Blockmap::unlinkAll()
 {
-    foreach(Instance::Node const &node, d->nodes)
+    foreach(Instance::Node *node, d->dataLeafs)
     {
-        // Only leafs with user data.
-        if(!node.isLeaf()) continue;
-
-        if(CellData *cellData = node.leafData)
-        {
-            cellData->unlinkAll();
-        }
+        node->leafData->unlinkAll();
     }
 }
 
@@ -747,14 +748,10 @@ void Blockmap::drawDebugVisual() const
     /*
      * Draw the Quadtree.
      */
-    glColor4f(1.f, 1.f, 1.f, 1.f / d->nodes.first().size);
-    foreach(Instance::Node const &node, d->nodes)
+    glColor4f(1.f, 1.f, 1.f, 1.f / d->root->size);
+    foreach(Instance::Node const *node, d->dataLeafs)
     {
-        // Only leafs with user data.
-        if(!node.isLeaf()) continue;
-        if(!node.leafData) continue;
-
-        Vector2f const topLeft     = node.cell * UNIT_SIZE;
+        Vector2f const topLeft     = node->cell * UNIT_SIZE;
         Vector2f const bottomRight = topLeft + Vector2f(UNIT_SIZE, UNIT_SIZE);
 
         glBegin(GL_LINE_LOOP);
@@ -0,0 +1,771 @@
+/** @file bspcache.cpp Persistent cache of built map BSPs.
+ *
+ * @authors Copyright © 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QHash>
+#include <QTemporaryFile>
+#include <QVector>
+#include <QtAlgorithms>
+
+#include <de/aabox.h>
+
+#include <de/Block>
+#include <de/Log>
+#include <de/Reader>
+#include <de/Writer>
+
+#include "de_base.h"
+#include "de_filesys.h" // F_MakePath
+
+#include "BspLeaf"
+#include "BspNode"
+#include "Face"
+#include "HEdge"
+#include "Line"
+#include "Sector"
+#include "Vertex"
+
+#include "world/bsp/bspcache.h"
+
+/// Identifies the cache entry files.
+#define BSPCACHE_MAGIC          0x31434244 // "DBC1"
+
+/**
+ * Version of the partitioner output. Increment when a change to the
+ * Partitioner (or to the format of the entries) changes the results, so that
+ * the existing entries are no longer found.
+ */
+#define BSPCACHE_VERSION        1
+
+/// Directory of the cache entries (relative to the runtime directory).
+#define BSPCACHE_DIR            "bspcache/"
+
+/// File name extension of the entries.
+#define BSPCACHE_ENTRY_SUFFIX   ".dbc"
+
+namespace de {
+namespace bsp {
+
+namespace internal {
+
+struct HEdgeRecord
+{
+    dint32 vertex; ///< Index of the vertex in the map mesh.
+    dint32 twin;   ///< Index of the twin half-edge in the entry (or -1).
+};
+
+/**
+ * Mesh of an entry. The first mesh is the map mesh (only the elements added
+ * by the build are included); the rest are extra meshes of BSP leafs.
+ */
+struct MeshRecord
+{
+    QVector<HEdgeRecord> hedges;
+    QVector<QVector<dint32> > faces; ///< Half-edge rings (indices in the mesh).
+};
+
+struct SegmentRecord
+{
+    dint32 line;   ///< Index of the line in the map.
+    dint32 side;
+    dint32 hedge;  ///< Index of the half-edge in the entry.
+};
+
+struct ElementRecord
+{
+    bool isLeaf;
+
+    // BSP node:
+    Partition partition;
+    AABoxd aaBox[2];
+    dint32 child[2];   ///< Indices of the child elements in the entry (or -1).
+
+    // BSP leaf:
+    dint32 sector;     ///< Index of the sector in the map (or -1).
+    dint32 poly;       ///< Index of the face in the map mesh record (or -1).
+    QVector<dint32> extraMeshes; ///< Indices of the mesh records.
+
+    ElementRecord() : isLeaf(false), sector(-1), poly(-1)
+    {
+        child[0] = child[1] = -1;
+    }
+};
+
+struct UnclosedRecord
+{
+    dint32 sector;
+    Vector2d nearPoint;
+};
+
+/// The contents of an entry.
+struct Entry
+{
+    QVector<Vector2d> vertexOrigins;
+    QVector<MeshRecord> meshes;
+    QVector<SegmentRecord> segments;
+    QVector<ElementRecord> elements;
+    QVector<UnclosedRecord> unclosed;
+};
+
+/// An invalid entry. @ingroup errors
+DENG2_ERROR(InvalidEntryError);
+
+static void checkEntry(bool valid, char const *what)
+{
+    if(!valid) throw InvalidEntryError("BspCache", what);
+}
+
+/**
+ * Reads the number of records to follow. Every record takes at least one
+ * byte, which bounds the number (and the memory allocated for the records)
+ * of a corrupt entry.
+ */
+static dint32 readCount(Reader &reader)
+{
+    dint32 count;
+    reader >> count;
+    checkEntry(count >= 0 && dsize(count) <= reader.source()->size() - reader.offset(),
+               "Invalid record count");
+    return count;
+}
+
+static bool lineIndexLessThan(Line const *a, Line const *b)
+{
+     return a->indexInMap() < b->indexInMap();
+}
+
+} // namespace internal
+
+using namespace internal;
+
+DENG2_PIMPL_NOREF(BspCache)
+{
+    QList<Line *> lines; ///< Sorted by index.
+    QHash<dint32, Line *> linesByIndex;
+    QList<Sector *> sectors;
+    Mesh *mesh;
+
+    /// Size of the mesh before the build.
+    int baseVertexCount;
+    int baseHEdgeCount;
+    int baseFaceCount;
+
+    String key;
+    UnclosedSectors unclosed;
+
+    Instance(Partitioner::LineSet const &lineSet, QList<Sector *> const &sectors,
+             Mesh &mesh)
+        : lines          (lineSet.toList()),
+          sectors        (sectors),
+          mesh           (&mesh),
+          baseVertexCount(mesh.vertexCount()),
+          baseHEdgeCount (mesh.hedgeCount()),
+          baseFaceCount  (mesh.faceCount())
+    {
+        qSort(lines.begin(), lines.end(), lineIndexLessThan);
+        foreach(Line *line, lines)
+        {
+            linesByIndex.insert(line->indexInMap(), line);
+        }
+    }
+
+    String entryPath() const
+    {
+        return BSPCACHE_DIR + key + BSPCACHE_ENTRY_SUFFIX;
+    }
+
+    QHash<Vertex const *, dint32> vertexIndices() const
+    {
+        QHash<Vertex const *, dint32> indices;
+        indices.reserve(mesh->vertexCount());
+        for(int i = 0; i < mesh->vertexCount(); ++i)
+        {
+            indices.insert(mesh->vertexes().at(i), i);
+        }
+        return indices;
+    }
+
+    static dint32 sectorIndex(Sector const *sector)
+    {
+        return sector? sector->indexInMap() : -1;
+    }
+
+    void composeKey(int splitCostFactor)
+    {
+        QHash<Vertex const *, dint32> const vertexIndex = vertexIndices();
+
+        Block params;
+        Writer writer(params);
+
+        writer << duint32(BSPCACHE_VERSION) << dint32(splitCostFactor)
+               << dint32(sectors.count()) << dint32(baseVertexCount);
+
+        foreach(Vertex *vertex, mesh->vertexes())
+        {
+            writer << vertex->origin().x << vertex->origin().y;
+        }
+
+        writer << dint32(lines.count());
+        foreach(Line *line, lines)
+        {
+            writer << dint32(line->indexInMap())
+                   << vertexIndex[&line->from()] << vertexIndex[&line->to()]
+                   << sectorIndex(line->frontSectorPtr())
+                   << sectorIndex(line->backSectorPtr())
+                   << sectorIndex(line->_bspWindowSector);
+        }
+
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        hash.addData(params);
+        key = QString(hash.result().toHex());
+    }
+
+    void serialize(MapElement const &root, Block &data) const
+    {
+        QHash<Vertex const *, dint32> const vertexIndex = vertexIndices();
+
+        // Collect the tree elements in pre-order, right child first.
+        QList<MapElement const *> elements;
+        QHash<MapElement const *, dint32> elementIndex;
+        QList<MapElement const *> stack;
+        stack << &root;
+        while(!stack.isEmpty())
+        {
+            MapElement const *elm = stack.takeLast();
+            elementIndex.insert(elm, elements.count());
+            elements << elm;
+
+            if(elm->type() == DMU_BSPNODE)
+            {
+                BspNode const &node = elm->as<BspNode>();
+                if(node.hasLeft())  stack << &node.child(BspNode::Left);
+                if(node.hasRight()) stack << &node.child(BspNode::Right);
+            }
+        }
+
+        // The meshes: first the new part of the map mesh, then the extra meshes.
+        QList<Mesh const *> meshes;
+        meshes << mesh;
+        foreach(MapElement const *elm, elements)
+        {
+            if(elm->type() != DMU_BSPLEAF) continue;
+            foreach(Mesh *extraMesh, elm->as<BspLeaf>().extraMeshes())
+            {
+                meshes << extraMesh;
+            }
+        }
+
+        QHash<HEdge const *, dint32> hedgeIndex;
+        QHash<Face const *, dint32> faceIndex;
+        QHash<Mesh const *, dint32> meshIndex;
+        for(int m = 0; m < meshes.count(); ++m)
+        {
+            Mesh const *meshIt = meshes[m];
+            meshIndex.insert(meshIt, m);
+
+            for(int i = (m? 0 : baseHEdgeCount); i < meshIt->hedgeCount(); ++i)
+            {
+                hedgeIndex.insert(meshIt->hedges().at(i), hedgeIndex.count());
+            }
+            if(!m)
+            {
+                for(int i = baseFaceCount; i < meshIt->faceCount(); ++i)
+                {
+                    faceIndex.insert(meshIt->faces().at(i), i - baseFaceCount);
+                }
+            }
+        }
+
+        Writer writer(data);
+        writer << duint32(BSPCACHE_MAGIC) << duint32(BSPCACHE_VERSION) << key
+               << dint32(baseVertexCount) << dint32(baseHEdgeCount)
+               << dint32(baseFaceCount);
+
+        // New vertexes.
+        writer << dint32(mesh->vertexCount() - baseVertexCount);
+        for(int i = baseVertexCount; i < mesh->vertexCount(); ++i)
+        {
+            Vector2d const &origin = mesh->vertexes().at(i)->origin();
+            writer << origin.x << origin.y;
+        }
+
+        // Half-edge geometry.
+        writer << dint32(meshes.count());
+        for(int m = 0; m < meshes.count(); ++m)
+        {
+            Mesh const *meshIt = meshes[m];
+
+            int const firstHEdge = (m? 0 : baseHEdgeCount);
+            writer << dint32(meshIt->hedgeCount() - firstHEdge);
+            for(int i = firstHEdge; i < meshIt->hedgeCount(); ++i)
+            {
+                HEdge const *hedge = meshIt->hedges().at(i);
+                writer << vertexIndex[&hedge->vertex()]
+                       << (hedge->hasTwin()? hedgeIndex[&hedge->twin()] : dint32(-1));
+            }
+
+            int const firstFace = (m? 0 : baseFaceCount);
+            writer << dint32(meshIt->faceCount() - firstFace);
+            for(int i = firstFace; i < meshIt->faceCount(); ++i)
+            {
+                QList<dint32> ring;
+                if(HEdge const *base = meshIt->faces().at(i)->hedge())
+                {
+                    HEdge const *hedge = base;
+                    do
+                    {
+                        ring << hedgeIndex[hedge];
+                    } while((hedge = &hedge->next()) != base);
+                }
+                writer << dint32(ring.count());
+                foreach(dint32 k, ring)
+                {
+                    writer << k;
+                }
+            }
+        }
+
+        // Line side segments, in the (sorted) order of each side.
+        QList<LineSideSegment const *> segments;
+        foreach(Line *line, lines)
+        for(int i = 0; i < 2; ++i)
+        {
+            foreach(LineSideSegment *seg, line->side(i).segments())
+            {
+                segments << seg;
+            }
+        }
+        writer << dint32(segments.count());
+        foreach(LineSideSegment const *seg, segments)
+        {
+            writer << dint32(seg->line().indexInMap()) << dint32(seg->lineSide().sideId())
+                   << hedgeIndex[&seg->hedge()];
+        }
+
+        // The BSP tree.
+        writer << dint32(elements.count());
+        foreach(MapElement const *elm, elements)
+        {
+            if(elm->type() == DMU_BSPLEAF)
+            {
+                BspLeaf const &leaf = elm->as<BspLeaf>();
+                writer << duchar(1)
+                       << sectorIndex(leaf.sectorPtr())
+                       << (leaf.hasPoly()? faceIndex[&leaf.poly()] : dint32(-1))
+                       << dint32(leaf.extraMeshes().count());
+                foreach(Mesh *extraMesh, leaf.extraMeshes())
+                {
+                    writer << meshIndex[extraMesh];
+                }
+            }
+            else
+            {
+                BspNode const &node = elm->as<BspNode>();
+                writer << duchar(0)
+                       << node.partition().direction.x << node.partition().direction.y
+                       << node.partition().origin.x    << node.partition().origin.y;
+                for(int i = 0; i < 2; ++i)
+                {
+                    AABoxd const &box = node.childAABox(i);
+                    writer << box.minX << box.minY << box.maxX << box.maxY
+                           << (node.hasChild(i)? elementIndex[&node.child(i)] : dint32(-1));
+                }
+            }
+        }
+
+        writer << dint32(unclosed.count());
+        foreach(UnclosedSector const &uc, unclosed)
+        {
+            writer << sectorIndex(uc.sector) << uc.nearPoint.x << uc.nearPoint.y;
+        }
+    }
+
+    /**
+     * Reads and validates an entry. Nothing is constructed, so an invalid
+     * entry can be rejected without side effects.
+     */
+    void read(Block const &data, Entry &entry) const
+    {
+        Reader reader(data);
+
+        duint32 magic, version;
+        String entryKey;
+        dint32 vertexCount, hedgeCount, faceCount;
+        reader >> magic >> version >> entryKey >> vertexCount >> hedgeCount >> faceCount;
+        checkEntry(magic == BSPCACHE_MAGIC && version == BSPCACHE_VERSION, "Unknown format");
+        checkEntry(entryKey == key, "Wrong key");
+        checkEntry(vertexCount == baseVertexCount && hedgeCount == baseHEdgeCount &&
+                   faceCount == baseFaceCount, "Map mesh mismatch");
+
+        // New vertexes.
+        entry.vertexOrigins.resize(readCount(reader));
+        for(int i = 0; i < entry.vertexOrigins.count(); ++i)
+        {
+            reader >> entry.vertexOrigins[i].x >> entry.vertexOrigins[i].y;
+        }
+        dint32 const totalVertexes = baseVertexCount + entry.vertexOrigins.count();
+
+        // Half-edge geometry.
+        entry.meshes.resize(readCount(reader));
+        checkEntry(!entry.meshes.isEmpty(), "No meshes");
+        dint32 totalHEdges = 0;
+        for(int m = 0; m < entry.meshes.count(); ++m)
+        {
+            MeshRecord &rec = entry.meshes[m];
+
+            rec.hedges.resize(readCount(reader));
+            for(int i = 0; i < rec.hedges.count(); ++i)
+            {
+                reader >> rec.hedges[i].vertex >> rec.hedges[i].twin;
+                checkEntry(rec.hedges[i].vertex >= 0 && rec.hedges[i].vertex < totalVertexes,
+                           "Invalid half-edge vertex");
+            }
+
+            rec.faces.resize(readCount(reader));
+            for(int i = 0; i < rec.faces.count(); ++i)
+            {
+                QVector<dint32> &ring = rec.faces[i];
+                ring.resize(readCount(reader));
+                // Faces of the map mesh are BSP leaf polygons, which must be convex.
+                checkEntry(ring.count() >= (m? 1 : 3), "Invalid face");
+                for(int k = 0; k < ring.count(); ++k)
+                {
+                    reader >> ring[k];
+                    checkEntry(ring[k] >= totalHEdges &&
+                               ring[k] < totalHEdges + rec.hedges.count(), "Invalid face half-edge");
+                    ring[k] -= totalHEdges;
+                }
+            }
+            totalHEdges += rec.hedges.count();
+        }
+
+        // Twins must be mutual; each half-edge belongs to at most one face.
+        QVector<HEdgeRecord const *> hedges;
+        hedges.reserve(totalHEdges);
+        foreach(MeshRecord const &rec, entry.meshes)
+        for(int i = 0; i < rec.hedges.count(); ++i)
+        {
+            hedges << &rec.hedges[i];
+        }
+        for(int i = 0; i < hedges.count(); ++i)
+        {
+            dint32 const twin = hedges[i]->twin;
+            checkEntry(twin == -1 || (twin >= 0 && twin < totalHEdges && twin != i &&
+                                      hedges[twin]->twin == i), "Invalid twin");
+        }
+        QVector<bool> inFace(totalHEdges, false);
+        totalHEdges = 0;
+        foreach(MeshRecord const &rec, entry.meshes)
+        {
+            foreach(QVector<dint32> const &ring, rec.faces)
+            foreach(dint32 k, ring)
+            {
+                checkEntry(!inFace[totalHEdges + k], "Half-edge in several faces");
+                inFace[totalHEdges + k] = true;
+            }
+            totalHEdges += rec.hedges.count();
+        }
+
+        // Line side segments.
+        QVector<bool> hasSegment(totalHEdges, false);
+        entry.segments.resize(readCount(reader));
+        for(int i = 0; i < entry.segments.count(); ++i)
+        {
+            SegmentRecord &seg = entry.segments[i];
+            reader >> seg.line >> seg.side >> seg.hedge;
+            checkEntry(linesByIndex.contains(seg.line) && (seg.side == 0 || seg.side == 1),
+                       "Invalid segment line");
+            checkEntry(seg.hedge >= 0 && seg.hedge < totalHEdges && !hasSegment[seg.hedge] &&
+                       hedges[seg.hedge]->twin != -1, "Invalid segment half-edge");
+            hasSegment[seg.hedge] = true;
+        }
+
+        // The BSP tree.
+        entry.elements.resize(readCount(reader));
+        checkEntry(!entry.elements.isEmpty(), "No BSP");
+        QVector<bool> isChild(entry.elements.count(), false);
+        QVector<bool> polyUsed(entry.meshes.first().faces.count(), false);
+        QVector<bool> meshUsed(entry.meshes.count(), false);
+        meshUsed[0] = true;
+        for(int i = 0; i < entry.elements.count(); ++i)
+        {
+            ElementRecord &elm = entry.elements[i];
+
+            duchar isLeaf;
+            reader >> isLeaf;
+            elm.isLeaf = (isLeaf != 0);
+            if(elm.isLeaf)
+            {
+                reader >> elm.sector >> elm.poly;
+                checkEntry(elm.sector >= -1 && elm.sector < sectors.count(), "Invalid leaf sector");
+                checkEntry(elm.poly == -1 || (elm.poly >= 0 && elm.poly < polyUsed.count() &&
+                                              !polyUsed[elm.poly]), "Invalid leaf polygon");
+                if(elm.poly >= 0) polyUsed[elm.poly] = true;
+
+                elm.extraMeshes.resize(readCount(reader));
+                for(int k = 0; k < elm.extraMeshes.count(); ++k)
+                {
+                    dint32 &m = elm.extraMeshes[k];
+                    reader >> m;
+                    checkEntry(m > 0 && m < meshUsed.count() && !meshUsed[m], "Invalid extra mesh");
+                    meshUsed[m] = true;
+                }
+            }
+            else
+            {
+                reader >> elm.partition.direction.x >> elm.partition.direction.y
+                       >> elm.partition.origin.x    >> elm.partition.origin.y;
+                for(int k = 0; k < 2; ++k)
+                {
+                    AABoxd &box = elm.aaBox[k];
+                    reader >> box.minX >> box.minY >> box.maxX >> box.maxY >> elm.child[k];
+
+                    // Children follow their parent (pre-order), so the tree is acyclic.
+                    dint32 const child = elm.child[k];
+                    checkEntry(child == -1 || (child > i && child < isChild.count() &&
+                                               !isChild[child]), "Invalid child");
+                    if(child > 0) isChild[child] = true;
+                }
+            }
+        }
+        // All elements must belong to the tree, and all extra meshes to leafs.
+        checkEntry(isChild.count(false) == 1 && meshUsed.count(false) == 0, "Unlinked elements");
+
+        entry.unclosed.resize(readCount(reader));
+        for(int i = 0; i < entry.unclosed.count(); ++i)
+        {
+            UnclosedRecord &uc = entry.unclosed[i];
+            reader >> uc.sector >> uc.nearPoint.x >> uc.nearPoint.y;
+            checkEntry(uc.sector >= 0 && uc.sector < sectors.count(), "Invalid unclosed sector");
+        }
+
+        checkEntry(reader.atEnd(), "Unexpected data");
+    }
+
+    /**
+     * Constructs the BSP described by a valid @a entry.
+     *
+     * @return  Root element of the BSP tree.
+     */
+    MapElement *construct(Entry const &entry)
+    {
+        QVector<Vertex *> vertexes;
+        vertexes.reserve(baseVertexCount + entry.vertexOrigins.count());
+        foreach(Vertex *vertex, mesh->vertexes())
+        {
+            vertexes << vertex;
+        }
+        foreach(Vector2d const &origin, entry.vertexOrigins)
+        {
+            vertexes << mesh->newVertex(origin);
+        }
+
+        QVector<Mesh *> meshes;
+        QVector<HEdge *> hedges;
+        QVector<Face *> polys;
+        for(int m = 0; m < entry.meshes.count(); ++m)
+        {
+            MeshRecord const &rec = entry.meshes[m];
+            Mesh *meshIt = (m? new Mesh : mesh);
+            meshes << meshIt;
+
+            int const firstHEdge = hedges.count();
+            foreach(HEdgeRecord const &hrec, rec.hedges)
+            {
+                hedges << meshIt->newHEdge(*vertexes[hrec.vertex]);
+            }
+
+            foreach(QVector<dint32> const &ring, rec.faces)
+            {
+                Face *face = meshIt->newFace();
+                for(int k = 0; k < ring.count(); ++k)
+                {
+                    HEdge *hedge = hedges[firstHEdge + ring[k]];
+                    HEdge *next  = hedges[firstHEdge + ring[(k + 1) % ring.count()]];
+
+                    hedge->setNext(next);
+                    next->setPrev(hedge);
+                    hedge->setFace(face);
+
+                    /// @todo Face should encapsulate.
+                    face->_hedgeCount += 1;
+                }
+                face->setHEdge(hedges[firstHEdge + ring.first()]);
+
+                /// @todo Face should encapsulate.
+                face->updateAABox();
+                face->updateCenter();
+
+                if(!m) polys << face;
+            }
+        }
+
+        int i = 0;
+        foreach(MeshRecord const &rec, entry.meshes)
+        foreach(HEdgeRecord const &hrec, rec.hedges)
+        {
+            if(hrec.twin >= 0)
+            {
+                hedges[i]->setTwin(hedges[hrec.twin]);
+            }
+            ++i;
+        }
+
+        foreach(SegmentRecord const &rec, entry.segments)
+        {
+            LineSide &side = linesByIndex[rec.line]->side(rec.side);
+            HEdge &hedge   = *hedges[rec.hedge];
+
+            LineSideSegment *seg = side.addSegment(hedge);
+#ifdef __CLIENT__
+            /// @todo LineSide::newSegment() should encapsulate:
+            seg->setLineSideOffset(Vector2d(side.from().origin() - hedge.origin()).length());
+            seg->setLength(Vector2d(hedge.twin().origin() - hedge.origin()).length());
+#else
+            DENG_UNUSED(seg);
+#endif
+        }
+
+        QVector<MapElement *> elements;
+        elements.reserve(entry.elements.count());
+        foreach(ElementRecord const &rec, entry.elements)
+        {
+            if(rec.isLeaf)
+            {
+                BspLeaf *leaf = new BspLeaf;
+                foreach(dint32 m, rec.extraMeshes)
+                {
+                    // Takes ownership.
+                    leaf->assignExtraMesh(*meshes[m]);
+                }
+                leaf->setParent(rec.sector >= 0? sectors[rec.sector] : 0);
+                if(rec.poly >= 0)
+                {
+                    leaf->setPoly(polys[rec.poly]);
+                }
+                elements << leaf;
+            }
+            else
+            {
+                BspNode *node = new BspNode(rec.partition);
+                node->setRightAABox(&rec.aaBox[BspNode::Right]);
+                node->setLeftAABox(&rec.aaBox[BspNode::Left]);
+                elements << node;
+            }
+        }
+
+        // Link the tree.
+        for(int k = 0; k < entry.elements.count(); ++k)
+        {
+            ElementRecord const &rec = entry.elements[k];
+            if(rec.isLeaf) continue;
+
+            BspNode &node = elements[k]->as<BspNode>();
+            if(rec.child[BspNode::Right] >= 0)
+                node.setRight(elements[rec.child[BspNode::Right]]);
+            if(rec.child[BspNode::Left] >= 0)
+                node.setLeft(elements[rec.child[BspNode::Left]]);
+        }
+
+        unclosed.clear();
+        foreach(UnclosedRecord const &rec, entry.unclosed)
+        {
+            unclosed << UnclosedSector(sectors[rec.sector], rec.nearPoint);
+        }
+
+        return elements.first();
+    }
+};
+
+BspCache::BspCache(Partitioner::LineSet const &lines, QList<Sector *> const &sectors,
+                   Mesh &mesh, int splitCostFactor)
+    : d(new Instance(lines, sectors, mesh))
+{
+    d->composeKey(splitCostFactor);
+}
+
+String const &BspCache::key() const
+{
+    return d->key;
+}
+
+MapElement *BspCache::load()
+{
+    LOG_AS("BspCache");
+
+    QFile file(d->entryPath());
+    if(!file.open(QFile::ReadOnly)) return 0;
+
+    Entry entry;
+    try
+    {
+        d->read(Block(file.readAll()), entry);
+    }
+    catch(Error const &er)
+    {
+        LOG_WARNING("Ignoring %s: %s") << d->entryPath() << er.asText();
+        return 0;
+    }
+
+    return d->construct(entry);
+}
+
+void BspCache::store(MapElement const &root)
+{
+    LOG_AS("BspCache");
+
+    Block data;
+    d->serialize(root, data);
+
+    F_MakePath(BSPCACHE_DIR);
+
+    // Write to a uniquely named temporary file first so that incomplete
+    // entries are never found.
+    String const path = d->entryPath();
+
+    QTemporaryFile file(path + ".XXXXXX");
+    if(!file.open())
+    {
+        LOG_WARNING("Failed to write %s.") << path;
+        return;
+    }
+    bool const ok = file.write(data) == data.size();
+    file.close();
+
+    // An existing (invalid) entry is replaced.
+    QFile::remove(path);
+    if(ok && file.rename(path))
+    {
+        file.setAutoRemove(false);
+    }
+}
+
+BspCache::UnclosedSectors const &BspCache::unclosedSectors() const
+{
+    return d->unclosed;
+}
+
+void BspCache::unclosedSectorFound(Sector &sector, Vector2d const &nearPoint)
+{
+    d->unclosed << UnclosedSector(&sector, nearPoint);
+}
+
+} // namespace bsp
+} // namespace de
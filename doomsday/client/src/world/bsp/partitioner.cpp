@@ -26,11 +26,14 @@
 
 #include <QList>
 #include <QHash>
+#include <QThread>
 #include <QtAlgorithms>
 
 #include <de/vector1.h>
 
 #include <de/Log>
+#include <de/Task>
+#include <de/TaskPool>
 
 #include "world/map.h"
 #include "BspLeaf"
@@ -59,6 +62,11 @@ typedef QList<ConvexSubspace>              ConvexSubspaces;
 typedef QHash<Vertex *, EdgeTips>          EdgeTipSetMap;
 typedef QList<LineSegment *>               LineSegments;
 typedef QList<Line *>                      Lines;
+typedef QList<LineSegmentSide *>           LineSegmentSides;
+
+/// Minimum number of partition candidates for which evaluation is split
+/// between multiple threads.
+static int const MIN_CANDIDATES_FOR_CONCURRENT_EVAL = 256;
 
 DENG2_PIMPL(Partitioner)
 {
@@ -452,22 +460,14 @@ DENG2_PIMPL(Partitioner)
         return true;
     }
 
-    void chooseNextPartitionFromSuperBlock(SuperBlock const &partList,
-        SuperBlock const &segs, LineSegmentSide **best, PartitionCost &bestCost)
+    /**
+     * Collect the line segments in @a block which are to be tested as potential
+     * partitions, in evaluation order.
+     */
+    void collectPartitionCandidates(SuperBlock const &block, LineSegmentSides &candidates)
     {
-        DENG2_ASSERT(best != 0);
-
-        //LOG_AS("chooseNextPartitionFromSuperBlock");
-
-        // Test each line segment as a potential partition.
-        foreach(LineSegmentSide *seg, partList.segments())
+        foreach(LineSegmentSide *seg, block.segments())
         {
-            //LOG_DEBUG("%sline segment %p sector:%d %s -> %s")
-            //    << (seg->hasMapLineSide()? "" : "mini-") << de::dintptr(*seg)
-            //    << (seg->sector? seg->sector->indexInMap() : -1)
-            //    << seg->fromOrigin().asText()
-            //    << seg->toOrigin().asText();
-
             // Optimization: Only the first line segment produced from a given
             // line is tested per round of partition costing (they are all
             // collinear).
@@ -479,26 +479,90 @@ DENG2_PIMPL(Partitioner)
                 seg->mapLine().setValidCount(validCount);
             }
 
+            candidates.append(seg);
+        }
+    }
+
+    /**
+     * Evaluate the candidates in the range [@a begin, @a end) as potential
+     * partitions, in order. Evaluation does not modify the partitioner, so
+     * several ranges of candidates can be evaluated concurrently.
+     *
+     * @param bestCost  Cost of the best candidate is written here.
+     *
+     * @return  The first candidate with the lowest cost; otherwise @c 0.
+     */
+    LineSegmentSide *chooseBestCandidate(SuperBlock const &segs,
+        LineSegmentSides const &candidates, int begin, int end,
+        PartitionCost &bestCost)
+    {
+        LineSegmentSide *best = 0;
+
+        for(int i = begin; i < end; ++i)
+        {
+            LineSegmentSide *seg = candidates.at(i);
+
             // Calculate the cost metrics for this line segment.
             PartitionCost cost;
-            if(evalPartition(segs, *best, bestCost, *seg, cost))
+            if(evalPartition(segs, best, bestCost, *seg, cost))
             {
                 // Suitable for use as a partition.
-                if(!*best || cost < bestCost)
+                if(!best || cost < bestCost)
                 {
                     // We have a new better choice.
                     bestCost = cost;
 
                     // Remember which line segment.
-                    *best = seg;
+                    best = seg;
                 }
             }
         }
+
+        return best;
     }
 
+    /// Result of evaluating a range of partition candidates.
+    struct CandidateRange
+    {
+        int begin, end;
+        LineSegmentSide *best;
+        PartitionCost bestCost;
+
+        CandidateRange(int begin = 0, int end = 0) : begin(begin), end(end), best(0)
+        {}
+    };
+
+    /// Evaluates a range of partition candidates in a worker thread.
+    class CandidateRangeTask : public Task
+    {
+    public:
+        CandidateRangeTask(Instance &inst, SuperBlock const &segs,
+                           LineSegmentSides const &candidates, CandidateRange &range)
+            : _inst(inst), _segs(segs), _candidates(candidates), _range(range)
+        {}
+
+        void runTask()
+        {
+            _range.best = _inst.chooseBestCandidate(_segs, _candidates, _range.begin,
+                                                    _range.end, _range.bestCost);
+        }
+
+    private:
+        Instance &_inst;
+        SuperBlock const &_segs;
+        LineSegmentSides const &_candidates;
+        CandidateRange &_range;
+    };
+
     /**
      * Find the best line segment to use as the next partition.
      *
+     * With many candidates the evaluation is split into ranges which are
+     * evaluated concurrently. As the cost of a candidate only increases during
+     * its evaluation, the first candidate with the lowest cost in each range
+     * can be reduced (in range order) to the same choice as made by a serial
+     * evaluation, so the resultant BSP is identical either way.
+     *
      * @param candidates  Candidate line segments to choose from.
      *
      * @return  The chosen line segment.
@@ -507,14 +571,13 @@ DENG2_PIMPL(Partitioner)
     {
         LOG_AS("Partitioner::choosePartition");
 
-        PartitionCost bestCost;
-        LineSegmentSide *best = 0;
-
         // Increment valid count so we can avoid testing the line segments
         // produced from a single line more than once per round of partition
         // selection.
         validCount++;
 
+        LineSegmentSides partCandidates;
+
         // Iterative pre-order traversal of SuperBlock.
         SuperBlock const *cur = &candidates;
         SuperBlock const *prev = 0;
@@ -522,7 +585,7 @@ DENG2_PIMPL(Partitioner)
         {
             while(cur)
             {
-                chooseNextPartitionFromSuperBlock(*cur, candidates, &best, bestCost);
+                collectPartitionCandidates(*cur, partCandidates);
 
                 if(prev == cur->parent())
                 {
@@ -552,6 +615,41 @@ DENG2_PIMPL(Partitioner)
             }
         }
 
+        int const numCandidates = partCandidates.count();
+        int const numRanges = de::min(QThread::idealThreadCount(),
+                                      numCandidates / MIN_CANDIDATES_FOR_CONCURRENT_EVAL);
+        if(numRanges <= 1)
+        {
+            PartitionCost bestCost;
+            return chooseBestCandidate(candidates, partCandidates, 0, numCandidates, bestCost);
+        }
+
+        QList<CandidateRange> ranges;
+        for(int i = 0; i < numRanges; ++i)
+        {
+            ranges.append(CandidateRange(numCandidates * i / numRanges,
+                                         numCandidates * (i + 1) / numRanges));
+        }
+
+        TaskPool tasks;
+        for(int i = 0; i < ranges.count(); ++i)
+        {
+            tasks.start(new CandidateRangeTask(*this, candidates, partCandidates, ranges[i]));
+        }
+        tasks.waitForDone();
+
+        // Choose the first of the best candidates.
+        LineSegmentSide *best = 0;
+        PartitionCost bestCost;
+        foreach(CandidateRange const &range, ranges)
+        {
+            if(range.best && (!best || range.bestCost < bestCost))
+            {
+                best     = range.best;
+                bestCost = range.bestCost;
+            }
+        }
+
         /*if(best)
         {
             LOG_DEBUG("best %p score: %d.%02d.")
@@ -44,6 +44,7 @@
 #include "Surface"
 #include "Vertex"
 
+#include "world/bsp/bspcache.h"
 #include "world/bsp/partitioner.h"
 
 #include "world/blockmap.h"
@@ -73,6 +74,7 @@
 #include "world/map.h"
 
 static int bspSplitFactor = 7; // cvar
+static byte bspCacheMode = 1; // cvar
 
 namespace de {
 
@@ -457,12 +459,19 @@ DENG2_OBSERVES(bsp::Partitioner, UnclosedSectorFound)
 
     void collateBspElements(bsp::Partitioner &partitioner, BspTreeNode &tree)
     {
-        if(tree.isLeaf())
+        // Take ownership of the BSP element.
+        DENG2_ASSERT(tree.userData() != 0);
+        MapElement &elm = *tree.userData();
+        partitioner.take(&elm);
+
+        collateBspElement(elm);
+    }
+
+    void collateBspElement(MapElement &elm)
+    {
+        if(elm.type() == DMU_BSPLEAF)
         {
-            // Take ownership of the BspLeaf.
-            DENG2_ASSERT(tree.userData() != 0);
-            BspLeaf &leaf = tree.userData()->as<BspLeaf>();
-            partitioner.take(&leaf);
+            BspLeaf &leaf = elm.as<BspLeaf>();
 
             // Add this BspLeaf to the LUT.
             leaf.setIndexInMap(bspLeafs.count());
@@ -508,11 +517,7 @@ DENG2_OBSERVES(bsp::Partitioner, UnclosedSectorFound)
             return;
         }
         // Else; a node.
-
-        // Take ownership of this BspNode.
-        DENG2_ASSERT(tree.userData() != 0);
-        BspNode &node = tree.userData()->as<BspNode>();
-        partitioner.take(&node);
+        BspNode &node = elm.as<BspNode>();
 
         // Add this BspNode to the LUT.
         node.setMap(thisPublic);
@@ -520,6 +525,58 @@ DENG2_OBSERVES(bsp::Partitioner, UnclosedSectorFound)
         bspNodes.append(&node);
     }
 
+    /**
+     * Attempt to construct the BSP tree from the cache entry for the map.
+     *
+     * @param cache          BSP cache for the map geometry.
+     * @param nextVertexOrd  Ordinal of the first vertex added by the BSP.
+     *
+     * @return  @c true iff a valid entry was found.
+     */
+    bool loadBspFromCache(bsp::BspCache &cache, int nextVertexOrd)
+    {
+        MapElement *rootElement = cache.load();
+        if(!rootElement) return false;
+
+        // Report the unclosed sectors found when the BSP was built.
+        foreach(bsp::BspCache::UnclosedSector const &unclosed, cache.unclosedSectors())
+        {
+            unclosedSectorFound(*unclosed.sector, unclosed.nearPoint);
+        }
+
+        // Attribute an index to any new vertexes.
+        for(int i = nextVertexOrd; i < mesh.vertexCount(); ++i)
+        {
+            Vertex *vtx = mesh.vertexes().at(i);
+            vtx->setMap(thisPublic);
+            vtx->setIndexInMap(i);
+        }
+
+        bspRoot = rootElement;
+
+        // Collate the elements in the same order as a built tree (pre-order,
+        // right child first).
+        QList<MapElement *> stack;
+        stack << rootElement;
+        while(!stack.isEmpty())
+        {
+            MapElement *elm = stack.takeLast();
+            collateBspElement(*elm);
+
+            if(elm->type() == DMU_BSPNODE)
+            {
+                BspNode &node = elm->as<BspNode>();
+                if(node.hasLeft())  stack << &node.child(BspNode::Left);
+                if(node.hasRight()) stack << &node.child(BspNode::Right);
+            }
+        }
+
+        LOG_INFO("BSP loaded: %d Nodes, %d Leafs and %d Vertexes.")
+            << bspNodes.count() << bspLeafs.count() << (mesh.vertexCount() - nextVertexOrd);
+
+        return true;
+    }
+
     /**
      * Build a new BSP tree.
      *
@@ -557,9 +614,19 @@ DENG2_OBSERVES(bsp::Partitioner, UnclosedSectorFound)
 
         try
         {
+            // An unchanged map's BSP may have been built before.
+            bsp::BspCache cache(linesToBuildBspFor, sectors, mesh, bspSplitFactor);
+            if(bspCacheMode && loadBspFromCache(cache, nextVertexOrd))
+            {
+                LOG_INFO(String("BSP loaded from the cache in %1 seconds.")
+                             .arg(begunAt.since(), 0, 'g', 2));
+                return true;
+            }
+
             // Configure a space partitioner.
             bsp::Partitioner partitioner(bspSplitFactor);
             partitioner.audienceForUnclosedSectorFound += this;
+            partitioner.audienceForUnclosedSectorFound += cache;
 
             // Build a BSP!
             BspTreeNode *rootNode = partitioner.buildBsp(linesToBuildBspFor, mesh);
@@ -630,6 +697,11 @@ DENG2_OBSERVES(bsp::Partitioner, UnclosedSectorFound)
                     cur = prev->parentPtr();
                 }
             }
+
+            if(bspCacheMode && bspRoot)
+            {
+                cache.store(*bspRoot);
+            }
         }
         catch(Error const &er)
         {
@@ -1141,7 +1213,9 @@ Map::Map(Uri const &uri) : d(new Instance(this, uri))
 void Map::consoleRegister() // static
 {
     Mobj_ConsoleRegister();
+    Thinkers::consoleRegister();
     C_VAR_INT("bsp-factor", &bspSplitFactor, CVF_NO_MAX, 0, 0);
+    C_VAR_BYTE("bsp-cache", &bspCacheMode, 0, 0, 1);
 }
 
 Mesh const &Map::mesh() const
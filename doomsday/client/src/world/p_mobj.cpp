@@ -99,7 +99,7 @@ mobj_t *P_MobjCreate(thinkfunc_t function, Vector3d const &origin, angle_t angle
     else
     {
         // No, we need to allocate another.
-        mo = (mobj_t *) Z_Calloc(MOBJ_SIZE, PU_MAP, NULL);
+        mo = App_World().map().thinkers().newMobj();
     }
 
     V3d_Set(mo->origin, origin.x, origin.y, origin.z);
@@ -19,12 +19,20 @@
 
 #define DENG_NO_API_MACROS_THINKER
 
+#include <algorithm>
+#include <cstring>
+
+#include <QHash>
 #include <QList>
+#include <QVector>
 #include <QtAlgorithms>
 
+#include <de/memoryblockset.h>
 #include <de/memoryzone.h>
+#include <de/Time>
 
 #include "de_base.h"
+#include "de_console.h"
 #include "world/map.h"
 #include "world/p_object.h"
 
@@ -39,6 +47,13 @@
 
 #include "world/thinkers.h"
 
+/// Number of mobjs allocated at a time in packed mode.
+#define MOBJ_BATCH_SIZE     256
+
+static byte thinkerPackedLists = false; // cvar
+
+D_CMD(BenchThinkers);
+
 boolean Thinker_IsMobjFunc(thinkfunc_t func)
 {
     return (func && func == reinterpret_cast<thinkfunc_t>(gx.MobjThinker));
@@ -46,13 +61,25 @@ boolean Thinker_IsMobjFunc(thinkfunc_t func)
 
 namespace de {
 
+static int runThinker(thinker_t *th, void *context);
+
 struct ThinkerList
 {
+    typedef QVector<thinker_t *> Members;
+
     bool isPublic; ///< All thinkers in this list are visible publically.
+    bool packed;   ///< Thinkers are also indexed in a contiguous array.
 
     thinker_t sentinel;
 
-    ThinkerList(thinkfunc_t func, bool isPublic) : isPublic(isPublic)
+    /// Contiguous index of the linked thinkers (in link order), used in packed
+    /// mode so that iteration need not chase the (scattered) list links. Slots
+    /// of destroyed thinkers are vacated and compacted after running.
+    Members members;
+    int vacatedCount;
+
+    ThinkerList(thinkfunc_t func, bool isPublic, bool packed = false)
+        : isPublic(isPublic), packed(packed), vacatedCount(0)
     {
         zap(sentinel);
 
@@ -65,6 +92,8 @@ struct ThinkerList
     void reinit()
     {
         sentinel.prev = sentinel.next = &sentinel;
+        members.clear();
+        vacatedCount = 0;
     }
 
     thinkfunc_t function() const
@@ -79,12 +108,32 @@ struct ThinkerList
         th.next = &sentinel;
         th.prev = sentinel.prev;
         sentinel.prev = &th;
+
+        if(packed)
+        {
+            members.append(&th);
+        }
     }
 
     int iterate(int (*callback) (thinker_t *, void *), void *parameters = 0)
     {
         int result = false;
 
+        if(packed)
+        {
+            // Note: the member count is re-read each time as the callback may
+            // link new thinkers to the list.
+            for(int i = 0; i < members.count(); ++i)
+            {
+                thinker_t *th = members[i];
+                if(!th) continue; // Vacated.
+
+                result = callback(th, parameters);
+                if(result) break;
+            }
+            return result;
+        }
+
         thinker_t *th = sentinel.next;
         while(th != &sentinel && th)
         {
@@ -102,22 +151,71 @@ struct ThinkerList
 
         return result;
     }
+
+    /**
+     * Run all thinkers in the list for one tic, destroying those which have
+     * been flagged for removal.
+     */
+    void run()
+    {
+        if(!packed)
+        {
+            iterate(runThinker);
+            return;
+        }
+
+        for(int i = 0; i < members.count(); ++i)
+        {
+            thinker_t *th = members[i];
+            if(!th) continue; // Vacated.
+
+            // Will the thinker be destroyed this time?
+            if(!th->inStasis && th->function == (thinkfunc_t) -1)
+            {
+                members[i] = 0;
+                vacatedCount += 1;
+            }
+
+            runThinker(th, 0);
+        }
+
+        // Compact the member index (preserving link order).
+        if(vacatedCount)
+        {
+            Members::iterator end = std::remove(members.begin(), members.end(),
+                                                static_cast<thinker_t *>(0));
+            members.erase(end, members.end());
+            vacatedCount = 0;
+        }
+    }
 };
 
 DENG2_PIMPL(Thinkers)
 {
     typedef QList<ThinkerList *> Lists;
+    typedef QHash<thid_t, mobj_t *> MobjHash;
 
     int idtable[2048]; // 65536 bits telling which IDs are in use.
     ushort iddealer;
 
+    /// Mobjs linked in the thinker lists, by unique identifier.
+    MobjHash mobjIdLookup;
+
     Lists lists;
     bool inited;
 
+    /// Packed mode is chosen when the thinkers are created (@c thinker-packed).
+    bool packed;
+
+    /// Storage of the mobjs in packed mode (allocated in contiguous batches).
+    blockset_t *mobjs;
+
     Instance(Public *i)
         : Base(i),
           iddealer(0),
-          inited(false)
+          inited(false),
+          packed(thinkerPackedLists != 0),
+          mobjs(0)
     {
         clearMobjIds();
     }
@@ -128,12 +226,16 @@ DENG2_PIMPL(Thinkers)
         /// so there is no memory leak here as this memory will be purged
         /// automatically when the map is "unloaded").
         qDeleteAll(lists);
+
+        if(mobjs) BlockSet_Delete(mobjs);
     }
 
     void clearMobjIds()
     {
         zap(idtable);
         idtable[0] |= 1; // ID zero is always "used" (it's not a valid ID).
+
+        mobjIdLookup.clear();
     }
 
     thid_t newMobjId()
@@ -161,7 +263,7 @@ DENG2_PIMPL(Thinkers)
         if(!canCreate) return 0;
 
         // A new thinker type.
-        lists.append(new ThinkerList(func, makePublic));
+        lists.append(new ThinkerList(func, makePublic, packed));
         return lists.last();
     }
 };
@@ -169,45 +271,56 @@ DENG2_PIMPL(Thinkers)
 Thinkers::Thinkers() : d(new Instance(this))
 {}
 
-bool Thinkers::isUsedMobjId(thid_t id)
+void Thinkers::consoleRegister() // static
 {
-    return d->idtable[id >> 5] & (1 << (id & 31) /*(id % 32) */ );
+    C_VAR_BYTE("thinker-packed", &thinkerPackedLists, 0, 0, 1);
+
+    C_CMD("benchthinkers", "i", BenchThinkers);
 }
 
-void Thinkers::setMobjId(thid_t id, bool inUse)
+struct mobj_s *Thinkers::newMobj()
 {
-    int c = id >> 5, bit = 1 << (id & 31); //(id % 32);
+    if(!d->packed)
+    {
+        return (mobj_t *) Z_Calloc(MOBJ_SIZE, PU_MAP, NULL);
+    }
 
-    if(inUse) d->idtable[c] |= bit;
-    else      d->idtable[c] &= ~bit;
+    if(!d->mobjs)
+    {
+        d->mobjs = BlockSet_New(MOBJ_SIZE, MOBJ_BATCH_SIZE);
+    }
+    mobj_t *mo = (mobj_t *) BlockSet_Allocate(d->mobjs);
+    std::memset(mo, 0, MOBJ_SIZE);
+    return mo;
 }
 
-struct mobjidlookup_t
+bool Thinkers::isUsedMobjId(thid_t id)
 {
-    thid_t id;
-    mobj_t *result;
-};
+    return d->idtable[id >> 5] & (1 << (id & 31) /*(id % 32) */ );
+}
 
-static int mobjIdLookup(thinker_t *thinker, void *context)
+void Thinkers::setMobjId(thid_t id, bool inUse)
 {
-    mobjidlookup_t *lookup = (mobjidlookup_t *) context;
-    if(thinker->id == lookup->id)
+    int c = id >> 5, bit = 1 << (id & 31); //(id % 32);
+
+    if(inUse)
     {
-        lookup->result = (mobj_t *) thinker;
-        return true; // Stop iteration.
+        d->idtable[c] |= bit;
+    }
+    else
+    {
+        d->idtable[c] &= ~bit;
+
+        // A free ID cannot be used to look up a mobj.
+        d->mobjIdLookup.remove(id);
     }
-    return false; // Continue iteration.
 }
 
 struct mobj_s *Thinkers::mobjById(int id)
 {
-    /// @todo  A hash table wouldn't hurt (see client's mobj id table).
-    mobjidlookup_t lookup;
-    lookup.id = id;
-    lookup.result = 0;
-    iterate(reinterpret_cast<thinkfunc_t>(gx.MobjThinker),
-            0x1/*mobjs are public*/, mobjIdLookup, &lookup);
-    return lookup.result;
+    // Only 16-bit identifiers are valid (zero is never used).
+    if(id <= 0 || id > 0xffff) return 0;
+    return d->mobjIdLookup.value(thid_t(id), 0);
 }
 
 void Thinkers::add(thinker_t &th, bool makePublic)
@@ -236,6 +349,12 @@ void Thinkers::add(thinker_t &th, bool makePublic)
     // Link the thinker to the thinker list.
     ThinkerList *list = d->listForThinkFunc(th.function, makePublic, true /*can create*/);
     list->link(th);
+
+    // Mobjs are publically addressable by their unique identifier.
+    if(th.id && makePublic)
+    {
+        d->mobjIdLookup.insert(th.id, reinterpret_cast<mobj_t *>(&th));
+    }
 }
 
 void Thinkers::remove(thinker_t &th)
@@ -332,6 +451,21 @@ int Thinkers::iterate(thinkfunc_t func, byte flags,
     return result;
 }
 
+void Thinkers::run(byte flags)
+{
+    if(!d->inited) return;
+
+    for(int i = 0; i < d->lists.count(); ++i)
+    {
+        ThinkerList *list = d->lists[i];
+
+        if(list->isPublic && !(flags & 0x1)) continue;
+        if(!list->isPublic && !(flags & 0x2)) continue;
+
+        list->run();
+    }
+}
+
 void unlinkThinkerFromList(thinker_t *th)
 {
     th->next->prev = th->prev;
@@ -383,6 +517,98 @@ static int runThinker(thinker_t *th, void *context)
     return false; // Continue iteration.
 }
 
+namespace internal {
+
+/// Thinker in the synthetic lists of Thinkers::benchmark().
+struct SyntheticThinker
+{
+    thinker_t thinker;
+    int counter;
+    byte payload[200]; // Roughly the size of a game mobj.
+};
+
+static void syntheticThink(void *th)
+{
+    reinterpret_cast<SyntheticThinker *>(th)->counter += 1;
+}
+
+/**
+ * Runs @a numThinkers synthetic thinkers for @a numTics tics and returns the
+ * time taken. In linked mode the thinkers are individually allocated from the
+ * zone and linked in a shuffled order, as after a map has been played for a
+ * while; in packed mode they are allocated in batches, in link order.
+ */
+static TimeDelta runSyntheticThinkers(bool packed, int numThinkers, int numTics)
+{
+    // The mode of the lists is chosen when they are created.
+    byte const oldPackedLists = thinkerPackedLists;
+    thinkerPackedLists = packed;
+    Thinkers thinkers;
+    thinkerPackedLists = oldPackedLists;
+
+    thinkers.initLists(0x1 | 0x2);
+
+    blockset_t *storage = 0;
+    QVector<SyntheticThinker *> synthetic(numThinkers);
+    if(packed)
+    {
+        storage = BlockSet_New(sizeof(SyntheticThinker), MOBJ_BATCH_SIZE);
+        for(int i = 0; i < numThinkers; ++i)
+        {
+            synthetic[i] = (SyntheticThinker *) BlockSet_Allocate(storage);
+            std::memset(synthetic[i], 0, sizeof(SyntheticThinker));
+        }
+    }
+    else
+    {
+        for(int i = 0; i < numThinkers; ++i)
+        {
+            synthetic[i] = (SyntheticThinker *) Z_Calloc(sizeof(SyntheticThinker), PU_APPSTATIC, 0);
+        }
+        std::random_shuffle(synthetic.begin(), synthetic.end());
+    }
+
+    foreach(SyntheticThinker *sth, synthetic)
+    {
+        sth->thinker.function = syntheticThink;
+        thinkers.add(sth->thinker, false /*not public*/);
+    }
+
+    Time startedAt;
+    for(int i = 0; i < numTics; ++i)
+    {
+        thinkers.run(0x1 | 0x2);
+    }
+    TimeDelta const runTime = startedAt.since();
+
+    if(storage)
+    {
+        BlockSet_Delete(storage);
+    }
+    else
+    {
+        foreach(SyntheticThinker *sth, synthetic) Z_Free(sth);
+    }
+    return runTime;
+}
+
+} // namespace internal
+
+void Thinkers::benchmark(int numThinkers)
+{
+    LOG_AS("Thinkers::benchmark");
+
+    int const numTics = 350;
+
+    TimeDelta const linkedTime = internal::runSyntheticThinkers(false, numThinkers, numTics);
+    TimeDelta const packedTime = internal::runSyntheticThinkers(true,  numThinkers, numTics);
+
+    double const perThinker = 1.0e9 / (double(numThinkers) * numTics);
+    LOG_INFO("%i thinkers run for %i tics:") << numThinkers << numTics;
+    LOG_INFO("  linked: %.2f ms (%.1f ns per thinker)") << linkedTime * 1000 << linkedTime * perThinker;
+    LOG_INFO("  packed: %.2f ms (%.1f ns per thinker)") << packedTime * 1000 << packedTime * perThinker;
+}
+
 } // namespace de
 
 using namespace de;
@@ -411,7 +637,7 @@ void Thinker_Run()
 {
     /// @todo fixme: Do not assume the current map.
     if(!App_World().hasMap()) return;
-    App_World().map().thinkers().iterate(NULL, 0x1 | 0x2, runThinker);
+    App_World().map().thinkers().run(0x1 | 0x2);
 }
 
 #undef Thinker_Add
@@ -446,6 +672,21 @@ int Thinker_Iterate(thinkfunc_t func, int (*callback) (thinker_t *, void *), voi
     return App_World().map().thinkers().iterate(func, 0x1, callback, context);
 }
 
+D_CMD(BenchThinkers)
+{
+    DENG_UNUSED(src); DENG_UNUSED(argc);
+
+    int const numThinkers = strtol(argv[1], 0, 0);
+    if(numThinkers <= 0)
+    {
+        Con_Printf("Usage: %s (num-thinkers)\n", argv[0]);
+        return false;
+    }
+
+    Thinkers::benchmark(numThinkers);
+    return true;
+}
+
 DENG_DECLARE_API(Thinker) =
 {
     { DE_API_THINKER },
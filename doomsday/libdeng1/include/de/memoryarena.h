@@ -0,0 +1,107 @@
+/**
+ * @file memoryarena.h
+ * Memory arena for allocations that share a lifetime. @ingroup system
+ *
+ * @authors Copyright © 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef LIBDENG_MEMORY_ARENA_H
+#define LIBDENG_MEMORY_ARENA_H
+
+#include "libdeng1.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct memoryarena_block_s;
+
+/**
+ * Bump allocator for allocations of any size that are all released at the
+ * same time (for instance, when a map is unloaded).
+ *
+ * Unlike a blockset, the allocations do not need to be of equal size.
+ * Allocating only advances a pointer in the current block of memory; a new
+ * block is acquired with M_Malloc() when the current one runs out. Individual
+ * allocations cannot be freed. Deleting or clearing the arena releases
+ * everything at once.
+ *
+ * The arena is not thread-safe.
+ */
+typedef struct memoryarena_s {
+    /// Size of each block of memory (unless an allocation needs more).
+    size_t _blockSize;
+
+    /// Running total of the number of allocated bytes (including alignment).
+    size_t _allocatedBytes;
+
+    /// Most recently acquired block first.
+    struct memoryarena_block_s *_blocks;
+} memoryarena_t;
+
+/**
+ * Creates a new memory arena.
+ *
+ * @param blockSize  Size of the blocks of memory from which allocations are
+ *                   made. Must be at least 1.
+ *
+ * @return  The new arena.
+ */
+DENG_PUBLIC memoryarena_t *MemoryArena_New(size_t blockSize);
+
+/**
+ * Deletes an arena and releases all memory allocated from it.
+ *
+ * @param arena  Arena to delete.
+ */
+DENG_PUBLIC void MemoryArena_Delete(memoryarena_t *arena);
+
+/**
+ * Allocates memory from the arena. The returned memory is suitably aligned
+ * for any type and is not initialized.
+ *
+ * @param arena  Arena to allocate from.
+ * @param size   Number of bytes to allocate.
+ *
+ * @return  Ptr to the allocated memory. Remains valid until the arena is
+ * cleared or deleted.
+ */
+DENG_PUBLIC void *MemoryArena_Allocate(memoryarena_t *arena, size_t size);
+
+/**
+ * Allocates memory from the arena and sets it to zero.
+ *
+ * @see MemoryArena_Allocate()
+ */
+DENG_PUBLIC void *MemoryArena_Calloc(memoryarena_t *arena, size_t size);
+
+/**
+ * Releases all memory allocated from the arena. The first block of memory is
+ * kept for reuse.
+ *
+ * @param arena  Arena to clear.
+ */
+DENG_PUBLIC void MemoryArena_Clear(memoryarena_t *arena);
+
+/// @return  Total number of bytes currently allocated from the arena.
+DENG_PUBLIC size_t MemoryArena_AllocatedBytes(memoryarena_t *arena);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif /* LIBDENG_MEMORY_ARENA_H */
@@ -181,6 +181,17 @@ DENG_PUBLIC void *ZBlockSet_Allocate(zblockset_t *set);
 
 DENG_PUBLIC void Z_PrintStatus(void);
 
+/**
+ * Determines how much memory is allocated with a specific tag. Tags above
+ * PU_PURGELEVEL are counted together with PU_PURGELEVEL.
+ *
+ * @param tag         Purge tag.
+ * @param blockCount  If not @c NULL, the number of blocks is written here.
+ *
+ * @return  Total size of the blocks in bytes (including block headers).
+ */
+DENG_PUBLIC size_t Z_TagMemory(int tag, uint *blockCount);
+
 ///@}
 
 #ifdef DENG_DEBUG
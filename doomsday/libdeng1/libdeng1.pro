@@ -72,6 +72,7 @@ HEADERS += \
     include/de/kdtree.h \
     include/de/mathutil.h \
     include/de/memory.h \
+    include/de/memoryarena.h \
     include/de/memoryblockset.h \
     include/de/memoryzone.h \
     include/de/point.h \
@@ -101,6 +102,7 @@ SOURCES += \
     src/kdtree.c \
     src/mathutil.c \
     src/memory.c \
+    src/memoryarena.c \
     src/memoryblockset.c \
     src/memoryzone.c \
     src/memoryzone_private.h \
@@ -0,0 +1,151 @@
+/**
+ * @file memoryarena.c
+ * Memory arena for allocations that share a lifetime. @ingroup system
+ *
+ * @authors Copyright © 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <string.h>
+#include "de/memoryarena.h"
+#include "de/memory.h"
+
+/// All allocations are aligned to this many bytes.
+#define ARENA_ALIGNMENT     16
+
+#define ARENA_ALIGNED(x)    (((x) + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1))
+
+typedef struct memoryarena_block_s {
+    struct memoryarena_block_s *next;
+    size_t size; ///< Size of the data area.
+    size_t used; ///< Number of bytes used in the data area.
+} memoryarena_block_t;
+
+/// The data area begins after the (aligned) block header.
+#define BLOCK_DATA(block)   ((byte *)(block) + ARENA_ALIGNED(sizeof(memoryarena_block_t)))
+
+static memoryarena_block_t *newBlock(size_t size)
+{
+    memoryarena_block_t *block = M_Malloc(ARENA_ALIGNED(sizeof(memoryarena_block_t)) + size);
+    block->next = 0;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+memoryarena_t *MemoryArena_New(size_t blockSize)
+{
+    memoryarena_t *arena;
+
+    DENG_ASSERT(blockSize > 0);
+
+    arena = M_Calloc(sizeof(*arena));
+    arena->_blockSize = ARENA_ALIGNED(blockSize);
+
+    // Acquire the first block right away.
+    arena->_blocks = newBlock(arena->_blockSize);
+
+    return arena;
+}
+
+void MemoryArena_Delete(memoryarena_t *arena)
+{
+    DENG_ASSERT(arena);
+
+    while(arena->_blocks)
+    {
+        memoryarena_block_t *next = arena->_blocks->next;
+        M_Free(arena->_blocks);
+        arena->_blocks = next;
+    }
+    M_Free(arena);
+}
+
+void *MemoryArena_Allocate(memoryarena_t *arena, size_t size)
+{
+    memoryarena_block_t *block;
+    void *ptr;
+
+    DENG_ASSERT(arena);
+
+    size = ARENA_ALIGNED(size);
+    block = arena->_blocks;
+
+    if(block->used + size > block->size)
+    {
+        if(size > arena->_blockSize / 2)
+        {
+            // Large allocations get a block of their own. It is placed after
+            // the current block so the space remaining there is not lost.
+            memoryarena_block_t *large = newBlock(size);
+            large->next = block->next;
+            block->next = large;
+            block = large;
+        }
+        else
+        {
+            block = newBlock(arena->_blockSize);
+            block->next = arena->_blocks;
+            arena->_blocks = block;
+        }
+    }
+
+    ptr = BLOCK_DATA(block) + block->used;
+    block->used += size;
+    arena->_allocatedBytes += size;
+    return ptr;
+}
+
+void *MemoryArena_Calloc(memoryarena_t *arena, size_t size)
+{
+    void *ptr = MemoryArena_Allocate(arena, size);
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void MemoryArena_Clear(memoryarena_t *arena)
+{
+    memoryarena_block_t *kept = 0;
+
+    DENG_ASSERT(arena);
+
+    // Keep one regular-sized block for reuse.
+    while(arena->_blocks)
+    {
+        memoryarena_block_t *next = arena->_blocks->next;
+        if(!kept && arena->_blocks->size == arena->_blockSize)
+        {
+            kept = arena->_blocks;
+        }
+        else
+        {
+            M_Free(arena->_blocks);
+        }
+        arena->_blocks = next;
+    }
+
+    kept->next = 0;
+    kept->used = 0;
+    arena->_blocks = kept;
+    arena->_allocatedBytes = 0;
+}
+
+size_t MemoryArena_AllocatedBytes(memoryarena_t *arena)
+{
+    DENG_ASSERT(arena);
+
+    return arena->_allocatedBytes;
+}
@@ -22,6 +22,7 @@
 
 #include "de/memoryblockset.h"
 #include "de/memory.h"
+#include "de/c_wrapper.h"
 
 typedef struct blockset_block_s {
     size_t count;   ///< Number of used elements.
@@ -47,6 +48,9 @@ static void addBlockToSet(blockset_t *set)
     block = &set->_blocks[set->_blockCount - 1];
     block->elements = M_Malloc(set->_elementSize * set->_elementsPerBlock);
     block->count = 0;
+
+    AllocationProfiler_Allocated("BlockSet", -1, block->elements,
+                                 set->_elementSize * set->_elementsPerBlock);
 }
 
 void *BlockSet_Allocate(blockset_t *set)
@@ -113,7 +117,10 @@ void BlockSet_Delete(blockset_t *set)
 
     // Free the elements from each block.
     for(i = 0; i < set->_blockCount; ++i)
+    {
+        AllocationProfiler_Freed(set->_blocks[i].elements);
         M_Free(set->_blocks[i].elements);
+    }
 
     M_Free(set->_blocks);
     M_Free(set);
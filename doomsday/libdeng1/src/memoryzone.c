@@ -31,6 +31,14 @@
  * all of them efficiently. This is possible because no block inside the
  * sequence could be purged by Z_Malloc() anyway.
  *
+ * @par Small Block Caches
+ * Small allocations are rounded up to a fixed set of size classes. Freed small
+ * blocks are not returned to the volume right away but kept in a cache for
+ * their size class, from which Z_Malloc() can reuse them in constant time. The
+ * cached blocks still appear allocated in the volume. The caches are flushed
+ * back to the volumes when tags are purged and before a new volume would be
+ * created.
+ *
  * @author Copyright &copy; 1999-2013 Jaakko Keränen <jaakko.keranen@iki.fi>
  * @author Copyright &copy; 2006-2013 Daniel Swanson <danij@dengine.net>
  * @author Copyright &copy; 2006 Jamie Jones <jamie_jones_au@yahoo.com.au>
@@ -65,9 +73,45 @@
 
 #define ALIGNED(x) (((x) + sizeof(void *) - 1)&(~(sizeof(void *) - 1)))
 
+/// Zone allocations are reported to the allocation profiler with this label.
+static char const *ALLOCATION_LABEL = "Zone";
+
 /// Special user pointer for blocks that are in use but have no single owner.
 #define MEMBLOCK_USER_ANONYMOUS    ((void *) 2)
 
+/// Special user pointer for freed small blocks kept in a size class cache.
+#define MEMBLOCK_USER_CACHED       ((void *) 3)
+
+/**
+ * Small allocations are rounded up to one of these size classes (payload bytes,
+ * not including the block header). When such a block is freed, it is kept in
+ * a per-class cache and handed out again by the next Z_Malloc of the same class
+ * without walking the volume with the rover.
+ */
+static size_t const smallBlockClasses[] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+#define NUM_SMALL_BLOCK_CLASSES     (sizeof(smallBlockClasses) / sizeof(smallBlockClasses[0]))
+#define MAX_SMALL_BLOCK_PAYLOAD     (256 + MINFRAGMENT) ///< Larger blocks are never cached.
+#define MAX_CACHED_BLOCKS_PER_CLASS 2048
+
+typedef struct smallblockcache_s {
+    memblock_t *first; ///< Next pointers are stored in the (unused) block payloads.
+    uint count;
+} smallblockcache_t;
+
+/**
+ * Allocated blocks are linked into lists by purge tag, so that freeing a range
+ * of tags only needs to visit the blocks that actually have those tags. Tags
+ * above PU_PURGELEVEL share the last list.
+ */
+typedef struct taglist_s {
+    memblock_t *first;
+    uint blockCount;
+    size_t bytes;
+} taglist_t;
+
+#define NUM_TAG_LISTS (PU_PURGELEVEL + 1)
+
 // Used for block allocation of memory from the zone.
 typedef struct zblockset_block_s {
     /// Maximum number of elements.
@@ -88,6 +132,13 @@ static memvolume_t *volumeLast;
 
 static mutex_t zoneMutex = 0;
 
+static taglist_t tagLists[NUM_TAG_LISTS];
+
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+static smallblockcache_t smallBlockCaches[NUM_SMALL_BLOCK_CLASSES];
+static size_t cachedBytes; ///< Total size of the blocks in the small block caches.
+#endif
+
 static size_t Z_AllocatedMemory(void);
 static size_t allocatedMemoryInVolume(memvolume_t *volume);
 
@@ -102,6 +153,51 @@ static __inline void unlockZone(void)
     Sys_Unlock(zoneMutex);
 }
 
+static __inline void *blockData(memblock_t *block)
+{
+#ifdef LIBDENG_FAKE_MEMORY_ZONE
+    return block->area;
+#else
+    return (byte *) block + sizeof(memblock_t);
+#endif
+}
+
+static __inline int tagListIndex(int tag)
+{
+    return MINMAX_OF(0, tag, NUM_TAG_LISTS - 1);
+}
+
+static void linkBlockToTagList(memblock_t *block)
+{
+    taglist_t *list = &tagLists[tagListIndex(block->tag)];
+
+    block->tagPrev = NULL;
+    block->tagNext = list->first;
+    if(list->first)
+        list->first->tagPrev = block;
+    list->first = block;
+
+    list->blockCount++;
+    list->bytes += block->size;
+}
+
+static void unlinkBlockFromTagList(memblock_t *block)
+{
+    taglist_t *list = &tagLists[tagListIndex(block->tag)];
+
+    if(block->tagPrev)
+        block->tagPrev->tagNext = block->tagNext;
+    else
+        list->first = block->tagNext;
+    if(block->tagNext)
+        block->tagNext->tagPrev = block->tagPrev;
+    block->tagPrev = block->tagNext = NULL;
+
+    DENG_ASSERT(list->blockCount > 0);
+    list->blockCount--;
+    list->bytes -= block->size;
+}
+
 /**
  * Conversion from string to long, with the "k" and "m" suffixes.
  */
@@ -211,6 +307,13 @@ void Z_Shutdown(void)
     LogBuffer_Printf(DE2_LOG_INFO,
             "Z_Shutdown: Used %i volumes, total %u bytes.\n", numVolumes, totalMemory);
 
+    memset(tagLists, 0, sizeof(tagLists));
+
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+    memset(smallBlockCaches, 0, sizeof(smallBlockCaches));
+    cachedBytes = 0;
+#endif
+
     Sys_DestroyMutex(zoneMutex);
     zoneMutex = 0;
 }
@@ -267,6 +370,13 @@ static void freeBlock(void *ptr, memblock_t **tracked)
     // The block was allocated from this volume.
     volume = block->volume;
 
+    // Cached small blocks have already been removed from their tag list.
+    if(block->user != MEMBLOCK_USER_CACHED)
+    {
+        unlinkBlockFromTagList(block);
+        AllocationProfiler_Freed(ptr);
+    }
+
     if(block->user > (void **) 0x100) // Smaller values are not pointers.
         *block->user = 0; // Clear the user's mark.
     block->user = NULL; // Mark as free.
@@ -342,8 +452,143 @@ static void freeBlock(void *ptr, memblock_t **tracked)
     unlockZone();
 }
 
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+
+/**
+ * Determines the size class for an allocation request.
+ *
+ * @param size  Aligned payload size.
+ *
+ * @return Index of the size class, or -1 if the request is not small.
+ */
+static int smallBlockClassForSize(size_t size)
+{
+    int i;
+    for(i = 0; i < (int)NUM_SMALL_BLOCK_CLASSES; ++i)
+    {
+        if(size <= smallBlockClasses[i]) return i;
+    }
+    return -1;
+}
+
+/**
+ * Determines which size class cache a freed block can be kept in. The block
+ * may be a little larger than its class if the leftover space was too small
+ * to be split off as a separate free block.
+ *
+ * @return Index of the size class, or -1 if the block should not be cached.
+ */
+static int smallBlockClassForBlock(memblock_t *block)
+{
+    size_t const payload = block->size - sizeof(memblock_t);
+    int i;
+
+    if(payload < smallBlockClasses[0] || payload > MAX_SMALL_BLOCK_PAYLOAD)
+        return -1;
+
+    // Map-static blocks are linked into sequences with their neighbors.
+    if(block->seqFirst) return -1;
+
+    for(i = NUM_SMALL_BLOCK_CLASSES - 1; i > 0; --i)
+    {
+        if(payload >= smallBlockClasses[i]) break;
+    }
+    return i;
+}
+
+/**
+ * Places a freed block into a size class cache. The block remains allocated
+ * as far as the volume is concerned, so it is skipped by the rovers.
+ *
+ * @return  @c true, if the block was cached.
+ */
+static boolean cacheSmallBlock(memblock_t *block)
+{
+    int const sc = smallBlockClassForBlock(block);
+    smallblockcache_t *cache;
+
+    if(sc < 0) return false;
+
+    cache = &smallBlockCaches[sc];
+    if(cache->count >= MAX_CACHED_BLOCKS_PER_CLASS) return false;
+
+    unlinkBlockFromTagList(block);
+    AllocationProfiler_Freed(blockData(block));
+
+    if(block->user > (void **) 0x100) // Smaller values are not pointers.
+        *block->user = 0; // Clear the user's mark.
+    block->user = MEMBLOCK_USER_CACHED;
+    block->tag = PU_APPSTATIC;
+    block->id = 0; // Catches attempts to free the block twice.
+
+    *(memblock_t **) ((byte *) block + sizeof(memblock_t)) = cache->first;
+    cache->first = block;
+    cache->count++;
+    cachedBytes += block->size;
+    return true;
+}
+
+static memblock_t *takeCachedSmallBlock(int sc)
+{
+    smallblockcache_t *cache = &smallBlockCaches[sc];
+    memblock_t *block = cache->first;
+
+    if(!block) return NULL;
+
+    cache->first = *(memblock_t **) ((byte *) block + sizeof(memblock_t));
+    cache->count--;
+    cachedBytes -= block->size;
+    return block;
+}
+
+/**
+ * Returns all cached small blocks back to their volumes.
+ *
+ * @return  @c true, if any blocks were freed.
+ */
+static boolean flushSmallBlockCaches(void)
+{
+    boolean flushed = false;
+    int i;
+
+    lockZone();
+    for(i = 0; i < (int)NUM_SMALL_BLOCK_CLASSES; ++i)
+    {
+        memblock_t *block;
+        while((block = takeCachedSmallBlock(i)) != NULL)
+        {
+            block->id = LIBDENG_ZONEID;
+            freeBlock((byte *) block + sizeof(memblock_t), 0);
+            flushed = true;
+        }
+    }
+    unlockZone();
+
+    return flushed;
+}
+
+#endif // !LIBDENG_FAKE_MEMORY_ZONE
+
 void Z_Free(void *ptr)
 {
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+    if(ptr)
+    {
+        memblock_t *block;
+        boolean cached = false;
+
+        lockZone();
+        block = Z_GetBlock(ptr);
+        if(block->id == LIBDENG_ZONEID)
+        {
+            cached = cacheSmallBlock(block);
+        }
+        unlockZone();
+
+        if(cached) return;
+    }
+#endif
+
     freeBlock(ptr, 0);
 }
 
@@ -430,6 +675,7 @@ static void splitFreeBlock(memblock_t *block, size_t size)
     newBlock->next = block->next;
     newBlock->next->prev = newBlock;
     newBlock->seqFirst = newBlock->seqLast = NULL;
+    newBlock->tagPrev = newBlock->tagNext = NULL;
 #ifdef LIBDENG_FAKE_MEMORY_ZONE
     newBlock->area = 0;
     newBlock->areaSize = 0;
@@ -459,6 +705,45 @@ void *Z_Malloc(size_t size, int tag, void *user)
     // Align to pointer size.
     size = ALIGNED(size);
 
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+    {
+        int const sc = smallBlockClassForSize(size);
+        if(sc >= 0)
+        {
+            memblock_t *block;
+
+            // Round up so the block can later be reused for any request of
+            // the same class.
+            size = smallBlockClasses[sc];
+
+            // Map-static blocks must be linked into sequences with their
+            // neighbors, so a recycled block will not do for them.
+            if(tag != PU_MAPSTATIC && (block = takeCachedSmallBlock(sc)) != NULL)
+            {
+                void *ptr = (byte *) block + sizeof(memblock_t);
+                if(user)
+                {
+                    block->user = user;
+                    *(void **) user = ptr;
+                }
+                else
+                {
+                    DENG_ASSERT(tag < PU_PURGELEVEL);
+                    block->user = MEMBLOCK_USER_ANONYMOUS;
+                }
+                block->tag = tag;
+                block->id = LIBDENG_ZONEID;
+                linkBlockToTagList(block);
+
+                AllocationProfiler_Allocated(ALLOCATION_LABEL, tag, ptr, block->size);
+
+                unlockZone();
+                return ptr;
+            }
+        }
+    }
+#endif
+
     // Account for size of block header.
     size += sizeof(memblock_t);
 
@@ -469,6 +754,15 @@ void *Z_Malloc(size_t size, int tag, void *user)
         uint numChecked = 0;
         boolean gotoNextVolume = false;
 
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+        if(volume == NULL && flushSmallBlockCaches())
+        {
+            // Before resorting to a new volume, give the cached small blocks
+            // back to the volumes and try again.
+            volume = volumeRoot;
+        }
+#endif
+
         if(volume == NULL)
         {
             // We've run out of volumes.  Let's allocate a new one
@@ -631,6 +925,9 @@ void *Z_Malloc(size_t size, int tag, void *user)
 
         iter->volume = volume;
         iter->id = LIBDENG_ZONEID;
+        linkBlockToTagList(iter);
+
+        AllocationProfiler_Allocated(ALLOCATION_LABEL, tag, blockData(iter), iter->size);
 
         unlockZone();
 
@@ -673,29 +970,32 @@ void *Z_Realloc(void *ptr, size_t n, int mallocTag)
 
 void Z_FreeTags(int lowTag, int highTag)
 {
-    memvolume_t *volume;
-    memblock_t *block, *next;
+    int i;
 
     LogBuffer_Printf(DE2_LOG_DEBUG,
             "MemoryZone: Free'ing all blocks in tag range:[%i, %i)\n",
             lowTag, highTag+1);
 
-    for(volume = volumeRoot; volume; volume = volume->next)
+    lockZone();
+
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+    // Release the cached small blocks, too, so that the space they occupy
+    // can be merged with the freed blocks.
+    flushSmallBlockCaches();
+#endif
+
+    // Only the blocks with tags in the range need to be visited.
+    for(i = tagListIndex(lowTag); i <= tagListIndex(highTag); ++i)
     {
-        for(block = volume->zone->blockList.next;
-            block != &volume->zone->blockList;
-            block = next)
+        memblock_t *block, *next;
+        for(block = tagLists[i].first; block; block = next)
         {
-            next = block->next;
+            next = block->tagNext;
 
-            if(block->user) // An allocated block?
+            // The last list may contain tags outside the range.
+            if(block->tag >= lowTag && block->tag <= highTag)
             {
-                if(block->tag >= lowTag && block->tag <= highTag)
-#ifdef LIBDENG_FAKE_MEMORY_ZONE
-                    Z_Free(block->area);
-#else
-                    Z_Free((byte *) block + sizeof(memblock_t));
-#endif
+                freeBlock(blockData(block), 0);
             }
         }
     }
@@ -703,6 +1003,8 @@ void Z_FreeTags(int lowTag, int highTag)
     // Now that there's plenty of new free space, let's keep the static
     // rover near the beginning of the volume.
     rewindStaticRovers();
+
+    unlockZone();
 }
 
 void Z_CheckHeap(void)
@@ -807,6 +1109,36 @@ void Z_CheckHeap(void)
         }
     }
 
+    // Every allocated block must be in a tag list (except the cached ones).
+    {
+        size_t taggedBytes = 0;
+        int i;
+        for(i = 0; i < NUM_TAG_LISTS; ++i)
+        {
+            memblock_t *block;
+            size_t listBytes = 0;
+            for(block = tagLists[i].first; block; block = block->tagNext)
+            {
+                if(tagListIndex(block->tag) != i)
+                    App_FatalError("Z_CheckHeap: block is in the wrong tag list");
+                listBytes += block->size;
+            }
+            if(listBytes != tagLists[i].bytes)
+                App_FatalError("Z_CheckHeap: tag list book-keeping is wrong");
+            taggedBytes += listBytes;
+        }
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+        taggedBytes += cachedBytes;
+#endif
+        if(taggedBytes != Z_AllocatedMemory())
+        {
+            LogBuffer_Printf(DE2_LOG_CRITICAL,
+                    "Z_CheckHeap: tag lists do not cover all allocated blocks (%u != %u)\n",
+                    (uint)taggedBytes, (uint)Z_AllocatedMemory());
+            App_FatalError("Z_CheckHeap: zone book-keeping is wrong");
+        }
+    }
+
     unlockZone();
 }
 
@@ -825,7 +1157,9 @@ void Z_ChangeTag2(void *ptr, int tag)
         }
         else
         {
+            unlinkBlockFromTagList(block);
             block->tag = tag;
+            linkBlockToTagList(block);
         }
     }
     unlockZone();
@@ -987,6 +1321,7 @@ static size_t allocatedMemoryInVolume(memvolume_t *volume)
 
 /**
  * Calculate the size of allocated memory blocks in all volumes combined.
+ * The per-volume counters are validated by Z_CheckHeap().
  */
 static size_t Z_AllocatedMemory(void)
 {
@@ -997,7 +1332,7 @@ static size_t Z_AllocatedMemory(void)
 
     for(volume = volumeRoot; volume; volume = volume->next)
     {
-        total += allocatedMemoryInVolume(volume);
+        total += volume->allocatedBytes;
     }
 
     unlockZone();
@@ -1009,38 +1344,63 @@ static size_t Z_AllocatedMemory(void)
  */
 size_t Z_FreeMemory(void)
 {
-    memvolume_t    *volume;
-    memblock_t     *block;
-    size_t          free = 0;
+    memvolume_t *volume;
+    size_t free = 0;
 
     lockZone();
 
+#ifdef DENG_DEBUG
     Z_CheckHeap();
+#endif
     for(volume = volumeRoot; volume; volume = volume->next)
     {
-        for(block = volume->zone->blockList.next;
-            block != &volume->zone->blockList;
-            block = block->next)
-        {
-            if(!block->user)
-            {
-                free += block->size;
-            }
-        }
+        // The blocks cover the entire volume.
+        free += volume->size - sizeof(memzone_t) - volume->allocatedBytes;
     }
 
     unlockZone();
     return free;
 }
 
+size_t Z_TagMemory(int tag, uint *blockCount)
+{
+    size_t bytes;
+
+    lockZone();
+    {
+        taglist_t const *list = &tagLists[tagListIndex(tag)];
+        if(blockCount) *blockCount = list->blockCount;
+        bytes = list->bytes;
+    }
+    unlockZone();
+
+    return bytes;
+}
+
 void Z_PrintStatus(void)
 {
     size_t allocated = Z_AllocatedMemory();
     size_t wasted = Z_FreeMemory();
+    int i;
 
     LogBuffer_Printf(DE2_LOG_DEBUG,
             "Memory zone status: %u volumes, %u bytes allocated, %u bytes free (%f%% in use)\n",
             Z_VolumeCount(), (uint)allocated, (uint)wasted, (float)allocated/(float)(allocated+wasted)*100.f);
+
+    lockZone();
+    for(i = 0; i < NUM_TAG_LISTS; ++i)
+    {
+        if(!tagLists[i].blockCount) continue;
+
+        LogBuffer_Printf(DE2_LOG_DEBUG, "  Tag %3i: %u blocks, %u bytes\n",
+                         i, tagLists[i].blockCount, (uint)tagLists[i].bytes);
+    }
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+    LogBuffer_Printf(DE2_LOG_DEBUG,
+            "  %u bytes of the allocated memory are freed small blocks kept for reuse\n",
+            (uint)cachedBytes);
+#endif
+    unlockZone();
 }
 
 /**
@@ -58,6 +58,7 @@ typedef struct memblock_s {
     struct memvolume_s *volume; // Volume this block belongs to.
     struct memblock_s *next, *prev;
     struct memblock_s *seqLast, *seqFirst;
+    struct memblock_s *tagPrev, *tagNext; // Allocated blocks with the same tag.
 #ifdef LIBDENG_FAKE_MEMORY_ZONE
     void *          area; // The real memory area.
     size_t          areaSize; // Size of the allocated memory area.
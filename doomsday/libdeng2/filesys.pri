@@ -1,5 +1,6 @@
 HEADERS += \
     include/de/ArchiveFeed \
+    include/de/ArchiveIndexCache \
     include/de/ArchiveEntryFile \
     include/de/ByteArrayFile \
     include/de/DirectoryFeed \
@@ -15,6 +16,7 @@ HEADERS += \
 
 HEADERS += \
     include/de/filesys/archivefeed.h \
+    include/de/filesys/archiveindexcache.h \
     include/de/filesys/archiveentryfile.h \
     include/de/filesys/bytearrayfile.h \
     include/de/filesys/directoryfeed.h \
@@ -29,6 +31,7 @@ HEADERS += \
 
 SOURCES += \
     src/filesys/archivefeed.cpp \
+    src/filesys/archiveindexcache.cpp \
     src/filesys/archiveentryfile.cpp \
     src/filesys/bytearrayfile.cpp \
     src/filesys/directoryfeed.cpp \
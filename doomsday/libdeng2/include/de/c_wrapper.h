@@ -91,6 +91,12 @@ DENG2_PUBLIC void LogBuffer_Clear(void);
 DENG2_PUBLIC void LogBuffer_Msg(char const *text);
 DENG2_PUBLIC void LogBuffer_Printf(legacycore_loglevel_t level, char const *format, ...);
 
+/*
+ * AllocationProfiler
+ */
+DENG2_PUBLIC void AllocationProfiler_Allocated(char const *label, int tag, void const *ptr, size_t size);
+DENG2_PUBLIC void AllocationProfiler_Freed(void const *ptr);
+
 /*
  * Info
  */
@@ -35,20 +35,41 @@ class DENG2_PUBLIC Task : public QRunnable
 {
 public:
     Task();
-    virtual ~Task() {}
+    virtual ~Task();
 
     TaskPool &pool() const;
     void run();
 
+    /**
+     * Sets the task that continues the work of this task. The continuation is
+     * started in the same pool, with the same priority, once this task has
+     * finished successfully. The pool is not considered done until the
+     * continuation has finished, too. If this task is aborted due to an
+     * exception, the continuation is discarded without being run.
+     *
+     * Continuations can be used to chain dependent tasks.
+     *
+     * @param continuation  Task to run after this one. Ownership given.
+     */
+    void setContinuation(Task *continuation);
+
     /**
      * Task classes must override this.
      */
     virtual void runTask() = 0;
 
+    /**
+     * Determines whether the calling thread is presently running a task, in
+     * other words, whether it is one of the shared pool's background threads.
+     */
+    static bool isRunningInCurrentThread();
+
 private:
     friend class TaskPool;
 
     TaskPool *_pool;
+    int _priority;
+    Task *_continuation;
 };
 
 } // namespace de
@@ -40,6 +40,10 @@ class Task;
  * provided for interrupting any of the started tasks. If that is required, the
  * Task instances in question should periodically check for an abort condition
  * and shut themselves down nicely when requested.
+ *
+ * Dependent work can be chained using Task::setContinuation(). For data
+ * parallel work, parallelFor() splits an index range between the pool's
+ * threads and the calling thread.
  */
 class DENG2_PUBLIC TaskPool : public QObject
 {
@@ -53,6 +57,22 @@ public:
         HighPriority   = 2
     };
 
+    /**
+     * Work consisting of independent items, identified by index, that can be
+     * processed concurrently in contiguous ranges. @see parallelFor()
+     */
+    class DENG2_PUBLIC IRangeWork
+    {
+    public:
+        virtual ~IRangeWork() {}
+
+        /**
+         * Process the items [@a begin, @a end). Called concurrently for
+         * non-overlapping ranges.
+         */
+        virtual void processRange(int begin, int end) = 0;
+    };
+
 public:
     TaskPool();
 
@@ -77,6 +97,24 @@ public:
      */
     bool isDone() const;
 
+    /**
+     * Processes the items [0, @a count) of @a work by dividing them into at most
+     * as many contiguous ranges as there are hardware threads. One of the ranges
+     * is processed in the calling thread and the rest in the shared pool of
+     * background threads. Blocks until all items have been processed.
+     *
+     * When called from a task (i.e., from one of the pool's threads), all the
+     * items are processed in the calling thread, so that nested calls cannot
+     * exhaust the pool. If processing a range fails in a background thread,
+     * an Error is thrown once all the ranges have finished.
+     *
+     * @param work          Work to process.
+     * @param count         Total number of items.
+     * @param minRangeSize  Minimum number of items per range. Smaller amounts
+     *                      of work are not worth the overhead of a thread.
+     */
+    static void parallelFor(IRangeWork &work, int count, int minRangeSize = 1);
+
 signals:
     void allTasksDone();
 
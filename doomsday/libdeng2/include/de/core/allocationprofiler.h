@@ -0,0 +1,96 @@
+/** @file allocationprofiler.h  Opt-in profiler for memory allocations.
+ *
+ * @authors Copyright (c) 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_ALLOCATIONPROFILER_H
+#define LIBDENG2_ALLOCATIONPROFILER_H
+
+#include "../libdeng2.h"
+#include "../String"
+
+namespace de {
+
+/**
+ * Opt-in profiler for memory allocations.
+ *
+ * Allocators report each allocation with a static label naming the allocator
+ * (e.g., "Zone") and an optional numeric tag (e.g., the purge tag); the call
+ * sites are not recorded. For each label and tag the profiler counts
+ * allocations and releases, the total and live bytes, the peak of live bytes,
+ * and the average lifetime of released allocations.
+ *
+ * While the profiler is disabled, reporting an allocation or a release costs
+ * one check of a flag. Allocations made while the profiler was disabled are
+ * unknown to it, so their release is ignored.
+ *
+ * All methods are thread-safe.
+ *
+ * @ingroup core
+ */
+class DENG2_PUBLIC AllocationProfiler
+{
+public:
+    enum SortOrder {
+        ByTotalBytes,
+        ByCount,
+        ByLiveBytes,
+        ByLifetime
+    };
+
+public:
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled();
+
+    /**
+     * Records an allocation.
+     *
+     * @param label  Static label of the allocator. The pointer is used for
+     *               identifying the label, so it must remain valid.
+     * @param tag    Additional identifier within the label, or -1.
+     * @param ptr    Address of the allocated memory. Allocations are
+     *               identified by the address of the memory itself, never
+     *               by the address of an object managing it, so that the
+     *               allocations of different allocators do not collide.
+     * @param size   Size of the allocation in bytes.
+     */
+    static void allocated(char const *label, int tag, void const *ptr, dsize size);
+
+    /**
+     * Records the release of an allocation.
+     *
+     * @param ptr  Address of the released memory.
+     */
+    static void freed(void const *ptr);
+
+    /**
+     * Forgets all recorded allocations and statistics.
+     */
+    static void clear();
+
+    /**
+     * Composes a report of the recorded statistics, one label and tag
+     * per line.
+     *
+     * @param order  Order of the lines in the report (descending).
+     */
+    static String report(SortOrder order = ByTotalBytes);
+};
+
+} // namespace de
+
+#endif // LIBDENG2_ALLOCATIONPROFILER_H
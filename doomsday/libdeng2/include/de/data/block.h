@@ -72,6 +72,8 @@ public:
      */
     Block(IByteArray const &array, Offset at, Size count);
 
+    virtual ~Block();
+
     // Implements IByteArray.
     Size size() const;
     void get(Offset at, Byte *values, Size count) const;
@@ -74,10 +74,29 @@ public:
      */
     ZipArchive(IByteArray const &data);
 
+    /**
+     * Constructs a ZIP archive instance using a previously read content
+     * index (see writeIndex()) instead of parsing the central directory of
+     * @a data. The index must have been written for the same source data.
+     *
+     * @param data             Data of the source archive. No copy of the data is made.
+     * @param serializedIndex  Content index.
+     */
+    ZipArchive(IByteArray const &data, Block const &serializedIndex);
+
     virtual ~ZipArchive();
 
     void operator >> (Writer &to) const;
 
+    /**
+     * Serializes the content index of the archive, as read from the source
+     * data, so that it can be later given to the constructor. Only
+     * meaningful for archives that have not been modified.
+     *
+     * @param serializedIndex  Content index is written here.
+     */
+    void writeIndex(Block &serializedIndex) const;
+
 public:
     /**
      * Determines whether a File looks like it could be accessed using
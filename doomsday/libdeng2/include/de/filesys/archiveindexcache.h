@@ -0,0 +1,104 @@
+/** @file archiveindexcache.h  Persistent cache of archive content indices.
+ *
+ * @authors Copyright © 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_ARCHIVEINDEXCACHE_H
+#define LIBDENG2_ARCHIVEINDEXCACHE_H
+
+#include "../File"
+#include "../NativePath"
+#include "../Block"
+
+namespace de {
+
+/**
+ * Persistent cache of the content indices of archives in the native file
+ * system (see ZipArchive::writeIndex()).
+ *
+ * Reading the index of a ZIP archive means parsing its central directory
+ * and visiting the local header of every entry. The parsed index is stored
+ * on disk together with the size and modification time of the archive, so
+ * that when the file system is populated again and the archive has not
+ * changed, the index can be reused as-is. The status of a native file is
+ * known anyway when it is added to the file system, so validating an entry
+ * costs nothing extra.
+ *
+ * Entries that are not looked up during a session are dropped when the
+ * cache is saved. Thread-safe.
+ *
+ * @ingroup fs
+ */
+class DENG2_PUBLIC ArchiveIndexCache
+{
+public:
+    ArchiveIndexCache();
+
+    /**
+     * Sets the native file where the cache is stored. The cache is disabled
+     * until a path is set.
+     *
+     * @param path  Native path of the cache file.
+     */
+    void setPath(NativePath const &path);
+
+    bool isEnabled() const;
+
+    /**
+     * Reads the cache file, unless already read. A missing or invalid file
+     * results in an empty cache.
+     */
+    void load();
+
+    /**
+     * Writes the cache file, if the contents have changed since loading.
+     */
+    void save();
+
+    /**
+     * Looks up the index of an archive.
+     *
+     * @param archivePath  Native path of the archive.
+     * @param status       Current status of the archive file.
+     * @param index        The index is written here, if found.
+     *
+     * @return  @c true, if an index for the archive with the same size and
+     * modification time was found.
+     */
+    bool find(NativePath const &archivePath, File::Status const &status, Block &index);
+
+    /**
+     * Stores the index of an archive in the cache.
+     *
+     * @param archivePath  Native path of the archive.
+     * @param status       Status of the archive file whose index this is.
+     * @param index        Serialized index.
+     */
+    void insert(NativePath const &archivePath, File::Status const &status, Block const &index);
+
+    /**
+     * Returns the number of lookups that found a valid index (@a hits) and
+     * the number that did not (@a misses), since the start of the session.
+     */
+    void statistics(int &hits, int &misses) const;
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+} // namespace de
+
+#endif // LIBDENG2_ARCHIVEINDEXCACHE_H
@@ -114,9 +114,27 @@ public:
 
 protected:
     void populateSubFolder(Folder &folder, String const &entryName);
-    void populateFile(Folder &folder, String const &entryName);
+
+    /**
+     * Opens the native file @a entryName and interprets its contents. The
+     * file is not added to @a folder. May be called concurrently for
+     * different entries.
+     *
+     * @return  Interpreted file. Caller gets ownership.
+     */
+    File *interpretFile(Folder &folder, String const &entryName) const;
+
+    /**
+     * Adds an interpreted file to @a folder and the main index.
+     *
+     * @param folder  Folder being populated.
+     * @param file    File returned by interpretFile(). Ownership given to @a folder.
+     */
+    void populateFile(Folder &folder, File *file);
 
 private:
+    struct InterpretWork;
+
     NativePath const _nativePath;
     Flags _mode;
 };
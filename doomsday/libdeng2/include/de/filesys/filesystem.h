@@ -21,6 +21,7 @@
 #define LIBDENG2_FILESYSTEM_H
 
 #include "../libdeng2.h"
+#include "../ArchiveIndexCache"
 #include "../Folder"
 #include "../System"
 
@@ -251,6 +252,12 @@ public:
      */
     void deindex(File &file);
 
+    /**
+     * Returns the cache of archive content indices used when populating
+     * the file system. The cache is disabled until its path is set.
+     */
+    ArchiveIndexCache &archiveIndexCache();
+
     void timeChanged(Clock const &);
 
 private:
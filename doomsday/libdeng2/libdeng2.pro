@@ -69,6 +69,7 @@ include(widgets.pri)
 
 # Convenience headers.
 HEADERS += \
+    include/de/AllocationProfiler \
     include/de/App \
     include/de/Asset \
     include/de/Clock \
@@ -102,6 +103,7 @@ HEADERS += \
     include/de/error.h \
     include/de/libdeng2.h \
     include/de/math.h \
+    include/de/core/allocationprofiler.h \
     include/de/core/app.h \
     include/de/core/asset.h \
     include/de/core/clock.h \
@@ -139,6 +141,7 @@ SOURCES += \
     src/error.cpp \
     src/matrix.cpp \
     src/version.cpp \
+    src/core/allocationprofiler.cpp \
     src/core/app.cpp \
     src/core/asset.cpp \
     src/core/callbacktimer.cpp \
@@ -18,6 +18,7 @@
  */
 
 #include "de/c_wrapper.h"
+#include "de/AllocationProfiler"
 #include "de/Error"
 #include "de/App"
 #include "de/Loop"
@@ -169,6 +170,16 @@ void LogBuffer_Printf(legacycore_loglevel_t level, char const *format, ...)
     logFragmentPrinter(logLevel, buffer);
 }
 
+void AllocationProfiler_Allocated(char const *label, int tag, void const *ptr, size_t size)
+{
+    de::AllocationProfiler::allocated(label, tag, ptr, size);
+}
+
+void AllocationProfiler_Freed(void const *ptr)
+{
+    de::AllocationProfiler::freed(ptr);
+}
+
 Info *Info_NewFromString(char const *utf8text)
 {
     try
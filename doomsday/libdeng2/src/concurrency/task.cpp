@@ -20,27 +20,75 @@
 #include "de/TaskPool"
 #include "de/Log"
 
+#include <QThreadStorage>
+
 namespace de {
 
-Task::Task() : _pool(0)
+/// Number of tasks being run in each thread (nonzero in pool threads only).
+static QThreadStorage<int> &runningTaskCount()
+{
+    static QThreadStorage<int> count;
+    return count;
+}
+
+namespace internal {
+
+/// Marks the calling thread as running a task for the lifetime of the object.
+struct RunningTaskMarker
+{
+    RunningTaskMarker()  { runningTaskCount().setLocalData(runningTaskCount().localData() + 1); }
+    ~RunningTaskMarker() { runningTaskCount().setLocalData(runningTaskCount().localData() - 1); }
+};
+
+} // namespace internal
+
+Task::Task() : _pool(0), _priority(0), _continuation(0)
 {}
 
+Task::~Task()
+{
+    delete _continuation;
+}
+
+void Task::setContinuation(Task *continuation)
+{
+    delete _continuation;
+    _continuation = continuation;
+}
+
 TaskPool &Task::pool() const
 {
     DENG2_ASSERT(_pool != 0);
     return *_pool;
 }
 
+bool Task::isRunningInCurrentThread()
+{
+    return runningTaskCount().hasLocalData() && runningTaskCount().localData() > 0;
+}
+
 void Task::run()
 {
+    bool aborted = false;
     try
     {
+        internal::RunningTaskMarker marker;
         runTask();
     }
     catch(Error const &er)
     {
         LOG_AS("Task");
         LOG_WARNING("Aborted due to exception: ") << er.asText();
+        aborted = true;
+    }
+
+    // Start the continuation before this task is considered finished, so that
+    // the pool does not become (momentarily) done in between.
+    if(_continuation && !aborted && _pool)
+    {
+        Task *next = _continuation;
+        _continuation = 0;
+        _pool->start(next, TaskPool::Priority(_priority));
     }
 
     // Cleanup.
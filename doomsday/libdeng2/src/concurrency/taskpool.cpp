@@ -19,9 +19,12 @@
 #include "de/TaskPool"
 #include "de/Task"
 #include "de/Guard"
+#include "de/Error"
+#include "de/String"
+#include "de/math.h"
 
+#include <QThread>
 #include <QThreadPool>
-#include <QSet>
 #include <de/Lockable>
 #include <de/Waitable>
 
@@ -29,11 +32,11 @@ namespace de {
 
 DENG2_PIMPL(TaskPool), public Lockable, public Waitable
 {
-    // Set of running tasks.
-    typedef QSet<Task *> Tasks;
-    Tasks tasks;
+    /// Number of started tasks that have not yet finished. A plain count is
+    /// sufficient as the tasks themselves are owned by the thread pool.
+    int taskCount;
 
-    Instance(Public *i) : Base(i)
+    Instance(Public *i) : Base(i), taskCount(0)
     {
         // When empty, the semaphore is available.
         post();
@@ -48,38 +51,100 @@ DENG2_PIMPL(TaskPool), public Lockable, public Waitable
     {
         DENG2_GUARD(this);
         t->_pool = &self;
-        if(tasks.isEmpty())
+        if(!taskCount)
         {
             wait(); // Semaphore now unavailable.
         }
-        tasks.insert(t);
+        taskCount++;
     }
 
-    void remove(Task *t)
+    /// @return  @c true if this was the last running task.
+    bool remove(Task *)
     {
         DENG2_GUARD(this);
-        tasks.remove(t);
-        if(tasks.isEmpty())
+        DENG2_ASSERT(taskCount > 0);
+        if(!--taskCount)
         {
             post();
+            return true;
         }
+        return false;
     }
 
     void waitForEmpty() const
     {
         wait();
         DENG2_GUARD(this);
-        DENG2_ASSERT(tasks.isEmpty());
+        DENG2_ASSERT(!taskCount);
         post();
     }
 
     bool isEmpty() const
     {
         DENG2_GUARD(this);
-        return tasks.isEmpty();
+        return !taskCount;
     }
 };
 
+namespace internal {
+
+/// Processes one range of a parallelFor().
+class RangeTask : public Task
+{
+public:
+    RangeTask(TaskPool::IRangeWork &work, int begin, int end, String &error, Lockable &errorLock)
+        : _work(work), _begin(begin), _end(end), _error(error), _errorLock(errorLock) {}
+
+    void runTask()
+    {
+        // Errors are passed to the caller of parallelFor() rather than
+        // aborting the background thread.
+        try
+        {
+            _work.processRange(_begin, _end);
+        }
+        catch(Error const &er)
+        {
+            setError(er.asText());
+        }
+        catch(std::exception const &er)
+        {
+            setError(er.what());
+        }
+        catch(...)
+        {
+            setError("Unknown exception");
+        }
+    }
+
+private:
+    void setError(String const &message)
+    {
+        DENG2_GUARD(_errorLock);
+        if(_error.isEmpty()) _error = message;
+    }
+
+    TaskPool::IRangeWork &_work;
+    int _begin;
+    int _end;
+    String &_error;
+    Lockable &_errorLock;
+};
+
+/**
+ * Waits for the tasks of a pool to finish when going out of scope, so that
+ * no task refers to the work after it has been destroyed, even if an
+ * exception is thrown.
+ */
+struct PoolWaiter
+{
+    TaskPool &pool;
+    PoolWaiter(TaskPool &p) : pool(p) {}
+    ~PoolWaiter() { pool.waitForDone(); }
+};
+
+} // namespace internal
+
 TaskPool::TaskPool() : d(new Instance(this))
 {}
 
@@ -88,6 +153,7 @@ TaskPool::~TaskPool()
 
 void TaskPool::start(Task *task, Priority priority)
 {
+    task->_priority = int(priority);
     d->add(task);
     QThreadPool::globalInstance()->start(task, int(priority));
 }
@@ -102,11 +168,49 @@ bool TaskPool::isDone() const
     return d->isEmpty();
 }
 
-void TaskPool::taskFinished(Task &task)
+void TaskPool::parallelFor(IRangeWork &work, int count, int minRangeSize)
 {
-    d->remove(&task);
+    if(count <= 0) return;
+
+    // When called from a task, the pool's threads may all be occupied by
+    // callers waiting for their ranges to be processed. The work is done
+    // in the calling thread instead.
+    int const numRanges = Task::isRunningInCurrentThread()? 1 :
+            de::max(1, de::min(QThread::idealThreadCount(), count / de::max(1, minRangeSize)));
+    if(numRanges == 1)
+    {
+        work.processRange(0, count);
+        return;
+    }
+
+    String error;
+    Lockable errorLock;
+    {
+        TaskPool pool;
+        internal::PoolWaiter waiter(pool);
+
+        for(int i = 1; i < numRanges; ++i)
+        {
+            // Computed in 64 bits so that large counts do not overflow.
+            int const begin = int(dint64(count) * i / numRanges);
+            int const end   = int(dint64(count) * (i + 1) / numRanges);
+            pool.start(new internal::RangeTask(work, begin, end, error, errorLock), HighPriority);
+        }
+
+        // The first range is processed in this thread.
+        work.processRange(0, int(dint64(count) / numRanges));
+    }
+
+    if(!error.isEmpty())
+    {
+        /// @throw Error  Processing a range in a background thread failed.
+        throw Error("TaskPool::parallelFor", error);
+    }
+}
 
-    if(d->isEmpty())
+void TaskPool::taskFinished(Task &task)
+{
+    if(d->remove(&task))
     {
         allTasksDone();
     }
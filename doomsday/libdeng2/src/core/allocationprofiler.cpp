@@ -0,0 +1,221 @@
+/** @file allocationprofiler.cpp  Opt-in profiler for memory allocations.
+ *
+ * @authors Copyright (c) 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/AllocationProfiler"
+#include "de/HighPerformanceTimer"
+#include "de/Lockable"
+#include "de/Guard"
+#include "de/math.h"
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QTextStream>
+#include <algorithm>
+
+namespace de {
+
+namespace internal {
+
+typedef QPair<char const *, int> LabelId;
+
+struct LabelStats
+{
+    duint64 allocCount;
+    duint64 freeCount;
+    duint64 totalBytes;
+    dint64 liveBytes;
+    dint64 peakLiveBytes;
+    ddouble totalLifetime; ///< Seconds, for the released allocations.
+
+    LabelStats()
+        : allocCount(0), freeCount(0), totalBytes(0),
+          liveBytes(0), peakLiveBytes(0), totalLifetime(0) {}
+
+    ddouble averageLifetime() const
+    {
+        return freeCount? totalLifetime / freeCount : 0;
+    }
+};
+
+struct LiveAllocation
+{
+    LabelId label;
+    dsize size;
+    ddouble allocatedAt;
+};
+
+typedef QHash<LabelId, LabelStats> Labels;
+typedef QHash<void const *, LiveAllocation> LiveAllocations;
+
+struct Profile : public Lockable
+{
+    HighPerformanceTimer timer;
+    Labels labels;
+    LiveAllocations live;
+};
+
+struct LabelOrder
+{
+    AllocationProfiler::SortOrder order;
+
+    LabelOrder(AllocationProfiler::SortOrder o) : order(o) {}
+
+    bool operator () (QPair<LabelId, LabelStats> const &a, QPair<LabelId, LabelStats> const &b) const
+    {
+        switch(order)
+        {
+        case AllocationProfiler::ByCount:
+            return a.second.allocCount > b.second.allocCount;
+
+        case AllocationProfiler::ByLiveBytes:
+            return a.second.liveBytes > b.second.liveBytes;
+
+        case AllocationProfiler::ByLifetime:
+            return a.second.averageLifetime() > b.second.averageLifetime();
+
+        default:
+            return a.second.totalBytes > b.second.totalBytes;
+        }
+    }
+};
+
+} // namespace internal
+
+using namespace internal;
+
+/// Checked by every allocator, so it is not guarded by the profile's lock.
+static QAtomicInt profilerEnabled(0);
+
+static inline bool profilerIsEnabled()
+{
+#ifdef DENG2_QT_5_0_OR_NEWER
+    return profilerEnabled.loadAcquire() != 0;
+#else
+    return int(profilerEnabled) != 0;
+#endif
+}
+
+static Profile &profile()
+{
+    static Profile p;
+    return p;
+}
+
+void AllocationProfiler::setEnabled(bool enabled)
+{
+    // Make sure the profile exists before anyone starts recording.
+    profile();
+    profilerEnabled.fetchAndStoreOrdered(enabled? 1 : 0);
+}
+
+bool AllocationProfiler::isEnabled()
+{
+    return profilerIsEnabled();
+}
+
+void AllocationProfiler::allocated(char const *label, int tag, void const *ptr, dsize size)
+{
+    if(!profilerIsEnabled() || !ptr) return;
+
+    Profile &prof = profile();
+    DENG2_GUARD(prof);
+
+    LabelId const id(label, tag);
+    LabelStats &stats = prof.labels[id];
+    stats.allocCount++;
+    stats.totalBytes += size;
+    stats.liveBytes  += size;
+    stats.peakLiveBytes = de::max(stats.peakLiveBytes, stats.liveBytes);
+
+    LiveAllocation alloc;
+    alloc.label       = label;
+    alloc.size        = size;
+    alloc.allocatedAt = prof.timer.elapsed();
+    prof.live.insert(ptr, alloc);
+}
+
+void AllocationProfiler::freed(void const *ptr)
+{
+    if(!profilerIsEnabled() || !ptr) return;
+
+    Profile &prof = profile();
+    DENG2_GUARD(prof);
+
+    LiveAllocations::iterator found = prof.live.find(ptr);
+    if(found == prof.live.end()) return; // Not allocated while profiling.
+
+    LabelStats &stats = prof.labels[found.value().label];
+    stats.freeCount++;
+    stats.liveBytes -= found.value().size;
+    stats.totalLifetime += prof.timer.elapsed() - found.value().allocatedAt;
+
+    prof.live.erase(found);
+}
+
+void AllocationProfiler::clear()
+{
+    Profile &prof = profile();
+    DENG2_GUARD(prof);
+
+    prof.labels.clear();
+    prof.live.clear();
+}
+
+String AllocationProfiler::report(SortOrder order)
+{
+    QList<QPair<LabelId, LabelStats> > sorted;
+    {
+        Profile &prof = profile();
+        DENG2_GUARD(prof);
+
+        for(Labels::const_iterator i = prof.labels.constBegin(); i != prof.labels.constEnd(); ++i)
+        {
+            sorted.append(qMakePair(i.key(), i.value()));
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(), LabelOrder(order));
+
+    String str;
+    QTextStream os(&str);
+    os << qSetFieldWidth(24) << left << "Label" << right
+       << qSetFieldWidth(12) << "Allocs" << "Frees" << "Bytes" << "Live" << "Peak"
+       << "Lifetime(s)" << qSetFieldWidth(0) << "\n";
+
+    for(int i = 0; i < sorted.size(); ++i)
+    {
+        LabelId const &id = sorted[i].first;
+        LabelStats const &stats = sorted[i].second;
+
+        String label = id.first;
+        if(id.second >= 0) label += String(" %1").arg(id.second);
+
+        os << qSetFieldWidth(24) << left << label << right
+           << qSetFieldWidth(12)
+           << stats.allocCount << stats.freeCount << stats.totalBytes
+           << stats.liveBytes << stats.peakLiveBytes
+           << fixed << qSetRealNumberPrecision(3) << stats.averageLifetime()
+           << qSetFieldWidth(0) << "\n";
+    }
+
+    os.flush();
+    return str;
+}
+
+} // namespace de
@@ -161,6 +161,10 @@ DENG2_PIMPL(App)
         fs.makeFolder("/home").attach(new DirectoryFeed(self.nativeHomePath(),
             DirectoryFeed::AllowWrite | DirectoryFeed::CreateIfMissing));
 
+        // Archive contents are indexed only when they have changed since the
+        // previous session.
+        fs.archiveIndexCache().setPath(self.nativeHomePath() / "archiveindex.cache");
+
         // Populate the file system.
         fs.refresh();
     }
@@ -19,9 +19,68 @@
 
 #include "de/Block"
 #include "de/File"
+#include "de/AllocationProfiler"
 
 using namespace de;
 
+/// Blocks report their data buffers to the allocation profiler when the
+/// buffer is allocated by a constructor or one of the methods of Block. Copies
+/// of a block or a byte array share the buffer implicitly; a shared buffer is
+/// reported released by the last block holding it.
+static char const *ALLOCATION_LABEL = "Block";
+
+/// Address of the block's data buffer, or @c 0 if it has none.
+static inline void const *payload(Block const &block)
+{
+    return block.isEmpty()? 0 : block.constData();
+}
+
+namespace de {
+namespace internal {
+
+/**
+ * Reports to the allocation profiler if the data buffer of a block is
+ * reallocated during the lifetime of the object. Nothing is done if the
+ * profiler is disabled when the object is created.
+ */
+class ProfiledChange
+{
+public:
+    ProfiledChange(Block &block)
+        : _block(block), _enabled(AllocationProfiler::isEnabled()), _oldData(0), _oldShared(false)
+    {
+        if(!_enabled) return;
+
+        _oldData   = payload(block);
+        _oldShared = !block.isDetached();
+    }
+
+    ~ProfiledChange()
+    {
+        if(!_enabled) return;
+
+        void const *newData = payload(_block);
+        if(newData == _oldData) return;
+
+        // A shared buffer is still held by someone else, and it was (or
+        // will be) reported by its owner.
+        if(!_oldShared) AllocationProfiler::freed(_oldData);
+        if(_block.isDetached())
+        {
+            AllocationProfiler::allocated(ALLOCATION_LABEL, -1, newData, _block.size());
+        }
+    }
+
+private:
+    Block &_block;
+    bool _enabled;
+    void const *_oldData;
+    bool _oldShared;
+};
+
+} // namespace internal
+} // namespace de
+
 Block::Block(Size initialSize)
 {
     resize(initialSize);
@@ -44,11 +103,15 @@ Block::Block(QByteArray const &byteArray)
 
 Block::Block(char const *nullTerminatedCStr)
     : QByteArray(nullTerminatedCStr)
-{}
+{
+    AllocationProfiler::allocated(ALLOCATION_LABEL, -1, payload(*this), size());
+}
 
 Block::Block(void const *data, Size length)
     : QByteArray(reinterpret_cast<char const *>(data), length), IByteArray(), IBlock()
-{}
+{
+    AllocationProfiler::allocated(ALLOCATION_LABEL, -1, payload(*this), size());
+}
 
 Block::Block(IIStream &stream)
 {
@@ -65,6 +128,11 @@ Block::Block(IByteArray const &other, Offset at, Size count) : IByteArray()
     copyFrom(other, at, count);
 }
 
+Block::~Block()
+{
+    if(isDetached()) AllocationProfiler::freed(payload(*this));
+}
+
 Block::Size Block::size() const
 {
     return QByteArray::size();
@@ -91,18 +159,22 @@ void Block::set(Offset at, Byte const *values, Size count)
         /// @throw OffsetError The accessed region of the block was out of range.
         throw OffsetError("Block::set", "Out of range");
     }
+    internal::ProfiledChange change(*this);
     replace(at, count, QByteArray((char const *) values, count));
 }
 
 void Block::copyFrom(IByteArray const &array, Offset at, Size count)
 {
+    internal::ProfiledChange change(*this);
+
     // Read the other's data directly into our data buffer.
-    resize(count);
+    QByteArray::resize(count);
     array.get(at, data(), count);
 }
 
 void Block::resize(Size size)
 {
+    internal::ProfiledChange change(*this);
     QByteArray::resize(size);
 }
 
@@ -118,20 +190,23 @@ Block::Byte const *Block::data() const
 
 Block &Block::operator += (Block const &other)
 {
+    internal::ProfiledChange change(*this);
     append(other);
     return *this;
 }
 
 Block &Block::operator += (IByteArray const &byteArray)
 {
+    internal::ProfiledChange change(*this);
     Offset pos = size();
-    resize(size() + byteArray.size());
+    QByteArray::resize(size() + byteArray.size());
     byteArray.get(0, data() + pos, byteArray.size());
     return *this;
 }
 
 Block &Block::operator = (Block const &other)
 {
+    internal::ProfiledChange change(*this);
     *static_cast<QByteArray *>(this) = static_cast<QByteArray const &>(other);
     return *this;
 }
@@ -144,5 +219,6 @@ Block &Block::operator = (IByteArray const &byteArray)
 
 void Block::clear()
 {
+    internal::ProfiledChange change(*this);
     QByteArray::clear();
 }
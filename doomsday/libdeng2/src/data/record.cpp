@@ -32,15 +32,18 @@
 #include "de/Vector"
 #include "de/String"
 
+#include <QAtomicInt>
 #include <QTextStream>
 
 namespace de {
 
 /**
  * Each record is given a unique identifier, so that serialized record
- * references can be tracked to their original target.
+ * references can be tracked to their original target. Records may be
+ * created in several threads at once (e.g., file info when populating
+ * folders), so the counter is atomic.
  */
-static duint32 recordIdCounter = 0;
+static QAtomicInt recordIdCounter(0);
 
 DENG2_PIMPL(Record)
 {
@@ -50,7 +53,8 @@ DENG2_PIMPL(Record)
 
     typedef QMap<duint32, Record *> RefMap;
 
-    Instance(Public &r) : Base(r), uniqueId(++recordIdCounter), oldUniqueId(0)
+    Instance(Public &r)
+        : Base(r), uniqueId(duint32(recordIdCounter.fetchAndAddOrdered(1) + 1)), oldUniqueId(0)
     {}
 
     bool isSubrecord(Variable const &var) const
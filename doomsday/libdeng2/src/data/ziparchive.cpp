@@ -374,9 +374,67 @@ ZipArchive::ZipArchive(IByteArray const &archive) : Archive(archive)
     }
 }
 
+ZipArchive::ZipArchive(IByteArray const &archive, Block const &serializedIndex) : Archive(archive)
+{
+    setIndex(new Index);
+
+    Reader reader(serializedIndex);
+
+    duint32 entryCount;
+    reader >> entryCount;
+    for(duint32 i = 0; i < entryCount; ++i)
+    {
+        String fileName;
+        duint64 offset, size, sizeInArchive, localHeaderOffset;
+        duint16 compression;
+        duint32 crc32;
+        Time modifiedAt;
+        reader >> fileName >> offset >> size >> sizeInArchive
+               >> compression >> crc32 >> localHeaderOffset >> modifiedAt;
+
+        if(offset > archive.size() || sizeInArchive > archive.size() - offset)
+        {
+            /// @throw FormatError  The index does not match the source data.
+            throw FormatError("ZipArchive::Archive", "Index does not match the archive");
+        }
+        if(compression != NO_COMPRESSION && compression != DEFLATED)
+        {
+            /// @throw UnknownCompressionError  Deflation is the only compression
+            /// algorithm supported by the implementation.
+            throw UnknownCompressionError("ZipArchive::Archive",
+                "Entry '" + fileName + "' uses an unsupported compression algorithm");
+        }
+
+        ZipEntry &entry = static_cast<ZipEntry &>(insertEntry(fileName));
+
+        entry.offset            = offset;
+        entry.size              = size;
+        entry.sizeInArchive     = sizeInArchive;
+        entry.compression       = compression;
+        entry.crc32             = crc32;
+        entry.localHeaderOffset = localHeaderOffset;
+        entry.modifiedAt        = modifiedAt;
+    }
+}
+
 ZipArchive::~ZipArchive()
 {}
 
+void ZipArchive::writeIndex(Block &serializedIndex) const
+{
+    Writer writer(serializedIndex);
+
+    writer << duint32(index().leafNodes().size());
+    for(PathTreeIterator<Index> iter(index().leafNodes()); iter.hasNext(); )
+    {
+        ZipEntry const &entry = iter.next();
+
+        writer << entry.path().toString() << duint64(entry.offset) << duint64(entry.size)
+               << duint64(entry.sizeInArchive) << entry.compression << entry.crc32
+               << duint64(entry.localHeaderOffset) << entry.modifiedAt;
+    }
+}
+
 void ZipArchive::readFromSource(Entry const &e, Path const &, IBlock &uncompressedData) const
 {
     ZipEntry const &entry = static_cast<ZipEntry const &>(e);
@@ -21,7 +21,9 @@
 
 #include "de/ArchiveFeed"
 #include "de/ArchiveEntryFile"
+#include "de/ArchiveIndexCache"
 #include "de/ByteArrayFile"
+#include "de/NativeFile"
 #include "de/ZipArchive"
 #include "de/Writer"
 #include "de/Folder"
@@ -60,7 +62,7 @@ DENG2_PIMPL(ArchiveFeed)
         {
             LOG_TRACE("Source %s is a byte array") << f.description();
 
-            arch = new ZipArchive(*bytes);
+            arch = openArchive(*bytes);
         }
         else
         {
@@ -73,6 +75,42 @@ DENG2_PIMPL(ArchiveFeed)
         }
     }
 
+    /**
+     * Opens the archive stored in @a bytes. The content index of an archive
+     * in a native file is looked up from the archive index cache of the file
+     * system, so the central directory only needs to be parsed when the file
+     * has changed.
+     */
+    Archive *openArchive(IByteArray const &bytes)
+    {
+        NativeFile const *native = dynamic_cast<NativeFile const *>(&file);
+        ArchiveIndexCache &cache = file.fileSystem().archiveIndexCache();
+
+        if(!native || !cache.isEnabled())
+        {
+            return new ZipArchive(bytes);
+        }
+
+        Block serializedIndex;
+        if(cache.find(native->nativePath(), native->status(), serializedIndex))
+        {
+            try
+            {
+                return new ZipArchive(bytes, serializedIndex);
+            }
+            catch(Error const &er)
+            {
+                LOG_DEBUG("Cached index of %s is invalid: %s") << file.description() << er.asText();
+            }
+        }
+
+        std::auto_ptr<ZipArchive> zip(new ZipArchive(bytes));
+        serializedIndex.clear();
+        zip->writeIndex(serializedIndex);
+        cache.insert(native->nativePath(), native->status(), serializedIndex);
+        return zip.release();
+    }
+
     Instance(Public *feed, ArchiveFeed &parentFeed, String const &path)
         : Base(feed), file(parentFeed.d->file), arch(0), basePath(path), parentFeed(&parentFeed)
     {}
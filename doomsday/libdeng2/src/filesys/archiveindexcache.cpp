@@ -0,0 +1,207 @@
+/** @file archiveindexcache.cpp  Persistent cache of archive content indices.
+ *
+ * @authors Copyright © 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/ArchiveIndexCache"
+#include "de/Reader"
+#include "de/Writer"
+#include "de/Lockable"
+#include "de/Guard"
+#include "de/Log"
+
+#include <QFile>
+#include <QHash>
+
+namespace de {
+
+/// Identifies the cache file.
+#define ARCHIVEINDEXCACHE_MAGIC     0x31434941 // "AIC1"
+
+DENG2_PIMPL_NOREF(ArchiveIndexCache), public Lockable
+{
+    struct Entry
+    {
+        File::Status status;
+        Block index;
+        bool used; ///< Looked up during this session.
+
+        Entry() : used(false) {}
+    };
+
+    /// Entries are keyed by the native path of the archive.
+    typedef QHash<String, Entry> Entries;
+    Entries entries;
+
+    NativePath path;
+    bool loaded;
+    bool changed;
+    int hits;
+    int misses;
+
+    Instance() : loaded(false), changed(false), hits(0), misses(0) {}
+
+    void read(Block const &data)
+    {
+        Reader reader(data);
+        reader.withHeader();
+
+        duint32 magic, count;
+        reader >> magic;
+        if(magic != ARCHIVEINDEXCACHE_MAGIC)
+        {
+            throw Error("ArchiveIndexCache::read", "Not an archive index cache");
+        }
+        reader >> count;
+        for(duint32 i = 0; i < count; ++i)
+        {
+            String archivePath;
+            duint64 size;
+            Entry entry;
+            reader >> archivePath >> size >> entry.status.modifiedAt >> entry.index;
+            entry.status.size = size;
+            entries.insert(archivePath, entry);
+        }
+    }
+
+    void write(Block &data) const
+    {
+        Writer writer(data);
+        writer.withHeader();
+
+        // Only the archives that still exist are worth keeping.
+        duint32 count = 0;
+        DENG2_FOR_EACH_CONST(Entries, i, entries)
+        {
+            if(i.value().used) count++;
+        }
+
+        writer << duint32(ARCHIVEINDEXCACHE_MAGIC) << count;
+        DENG2_FOR_EACH_CONST(Entries, i, entries)
+        {
+            if(!i.value().used) continue;
+
+            writer << i.key() << duint64(i.value().status.size)
+                   << i.value().status.modifiedAt << i.value().index;
+        }
+    }
+};
+
+ArchiveIndexCache::ArchiveIndexCache() : d(new Instance)
+{}
+
+void ArchiveIndexCache::setPath(NativePath const &path)
+{
+    DENG2_GUARD_FOR(*d, G);
+    d->path = path;
+}
+
+bool ArchiveIndexCache::isEnabled() const
+{
+    DENG2_GUARD_FOR(*d, G);
+    return !d->path.isEmpty();
+}
+
+void ArchiveIndexCache::load()
+{
+    LOG_AS("ArchiveIndexCache");
+
+    DENG2_GUARD_FOR(*d, G);
+
+    if(d->path.isEmpty() || d->loaded) return;
+    d->loaded = true;
+
+    QFile file(d->path);
+    if(!file.open(QFile::ReadOnly)) return;
+
+    try
+    {
+        d->read(Block(file.readAll()));
+
+        LOG_DEBUG("%i archive indices in %s") << d->entries.size() << d->path.pretty();
+    }
+    catch(Error const &er)
+    {
+        LOG_WARNING("Ignoring %s: %s") << d->path.pretty() << er.asText();
+        d->entries.clear();
+    }
+}
+
+void ArchiveIndexCache::save()
+{
+    LOG_AS("ArchiveIndexCache");
+
+    DENG2_GUARD_FOR(*d, G);
+
+    if(d->path.isEmpty()) return;
+
+    // Dropping the entries of archives that no longer exist is a change, too.
+    bool changed = d->changed;
+    DENG2_FOR_EACH_CONST(Instance::Entries, i, d->entries)
+    {
+        if(!i.value().used) changed = true;
+    }
+    if(!changed) return;
+
+    Block data;
+    d->write(data);
+
+    QFile file(d->path);
+    if(!file.open(QFile::WriteOnly | QFile::Truncate) || file.write(data) != data.size())
+    {
+        LOG_WARNING("Failed to write %s") << d->path.pretty();
+        return;
+    }
+    d->changed = false;
+}
+
+bool ArchiveIndexCache::find(NativePath const &archivePath, File::Status const &status, Block &index)
+{
+    DENG2_GUARD_FOR(*d, G);
+
+    Instance::Entries::iterator found = d->entries.find(archivePath);
+    if(found == d->entries.end() || found.value().status != status)
+    {
+        d->misses++;
+        return false;
+    }
+
+    found.value().used = true;
+    index = found.value().index;
+    d->hits++;
+    return true;
+}
+
+void ArchiveIndexCache::insert(NativePath const &archivePath, File::Status const &status,
+                               Block const &index)
+{
+    DENG2_GUARD_FOR(*d, G);
+
+    Instance::Entry &entry = d->entries[archivePath];
+    entry.status = status;
+    entry.index  = index;
+    entry.used   = true;
+    d->changed = true;
+}
+
+void ArchiveIndexCache::statistics(int &hits, int &misses) const
+{
+    DENG2_GUARD_FOR(*d, G);
+    hits   = d->hits;
+    misses = d->misses;
+}
+
+} // namespace de
@@ -25,12 +25,50 @@
 #include "de/FS"
 #include "de/Date"
 #include "de/App"
+#include "de/TaskPool"
 
 #include <QDir>
 #include <QFileInfo>
+#include <QVector>
 
 using namespace de;
 
+/**
+ * Interprets the files of a directory concurrently. Interpreting means
+ * reading the file headers (and the central directories of archives), so
+ * with many packages it is the bulk of populating a folder.
+ */
+struct DirectoryFeed::InterpretWork : public TaskPool::IRangeWork
+{
+    DirectoryFeed const &feed;
+    Folder &folder;
+    QStringList const &names;
+    QVector<File *> files; ///< Interpreted files in the order of @a names.
+    QVector<bool> failed;  ///< Interpreting the file threw an exception.
+
+    InterpretWork(DirectoryFeed const &feed, Folder &folder, QStringList const &names)
+        : feed(feed), folder(folder), names(names),
+          files(names.size(), 0), failed(names.size(), false)
+    {}
+
+    void processRange(int begin, int end)
+    {
+        for(int i = begin; i < end; ++i)
+        {
+            try
+            {
+                files[i] = feed.interpretFile(folder, names.at(i));
+            }
+            catch(...)
+            {
+                // Errors must not escape the pool's threads; the caller
+                // interprets the file again to raise the error in order.
+                failed[i] = true;
+            }
+        }
+    }
+};
+
 DirectoryFeed::DirectoryFeed(NativePath const &nativePath, Flags const &mode)
     : _nativePath(nativePath), _mode(mode) {}
 
@@ -61,6 +99,7 @@ void DirectoryFeed::populate(Folder &folder)
     }
     QStringList nameFilters;
     nameFilters << "*";
+    QStringList fileNames;
     foreach(QFileInfo entry,
             dir.entryInfoList(nameFilters, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot))
     {
@@ -68,10 +107,39 @@ void DirectoryFeed::populate(Folder &folder)
         {
             populateSubFolder(folder, entry.fileName());
         }
-        else
+        else if(!folder.has(entry.fileName()))
         {
-            populateFile(folder, entry.fileName());
+            fileNames << entry.fileName();
         }
+        // Otherwise there already is an entry for this, skip it (wasn't
+        // pruned so it's OK).
+    }
+
+    // The files are interpreted concurrently but added in the directory
+    // order, so the resulting tree does not depend on thread timing.
+    InterpretWork work(*this, folder, fileNames);
+    TaskPool::parallelFor(work, fileNames.size(), 8);
+
+    for(int i = 0; i < fileNames.size(); ++i)
+    {
+        File *file = work.files.at(i);
+        if(work.failed.at(i))
+        {
+            // Interpret the file again in this thread, so that the error
+            // propagates with its original type.
+            try
+            {
+                file = interpretFile(folder, fileNames.at(i));
+            }
+            catch(...)
+            {
+                // Discard the rest, like the failed file would have
+                // interrupted populating the folder.
+                for(int k = i + 1; k < fileNames.size(); ++k) delete work.files.at(k);
+                throw;
+            }
+        }
+        populateFile(folder, file);
     }
 }
 
@@ -95,14 +163,8 @@ void DirectoryFeed::populateSubFolder(Folder &folder, String const &entryName)
     }
 }
 
-void DirectoryFeed::populateFile(Folder &folder, String const &entryName)
+File *DirectoryFeed::interpretFile(Folder &folder, String const &entryName) const
 {
-    if(folder.has(entryName))
-    {
-        // Already has an entry for this, skip it (wasn't pruned so it's OK).
-        return;
-    }
-
     NativePath entryPath = _nativePath / entryName;
 
     // Open the native file.
@@ -113,7 +175,11 @@ void DirectoryFeed::populateFile(Folder &folder, String const &entryName)
         nativeFile->setMode(File::Write);
     }
 
-    File *file = folder.fileSystem().interpret(nativeFile.release());
+    return folder.fileSystem().interpret(nativeFile.release());
+}
+
+void DirectoryFeed::populateFile(Folder &folder, File *file)
+{
     folder.add(file);
 
     // We will decide on pruning this.
@@ -45,6 +45,9 @@ DENG2_PIMPL_NOREF(FileSystem), public ReadWriteLockable
 
     /// The root folder of the entire file system.
     Folder root;
+
+    /// Content indices of the archives, saved between sessions.
+    ArchiveIndexCache archiveIndexCache;
 };
 
 FileSystem::FileSystem() : d(new Instance)
@@ -55,10 +58,19 @@ void FileSystem::refresh()
     LOG_AS("FS::refresh");
 
     Time startedAt;
+    d->archiveIndexCache.load();
     d->root.populate();
+    d->archiveIndexCache.save();
 
     LOG_DEBUG("Completed in %.2f seconds.") << startedAt.since();
 
+    if(d->archiveIndexCache.isEnabled())
+    {
+        int hits, misses;
+        d->archiveIndexCache.statistics(hits, misses);
+        LOG_INFO("Archive index cache: %i hits, %i misses") << hits << misses;
+    }
+
     printIndex();
 }
 
@@ -250,6 +262,11 @@ void FileSystem::deindex(File &file)
     removeFromIndex(d->typeIndex[DENG2_TYPE_NAME(file)], file);
 }
 
+ArchiveIndexCache &FileSystem::archiveIndexCache()
+{
+    return d->archiveIndexCache;
+}
+
 void FileSystem::timeChanged(Clock const &)
 {
     // perform time-based processing (indexing/pruning/refreshing)
@@ -172,6 +172,12 @@ public:
 
     inline bool isEmpty() const { return !imageCount(); }
 
+    /**
+     * Returns the fraction of the total area that is used by the allocated
+     * images (0...1). The margins between the images are not included.
+     */
+    float occupancy() const;
+
     /**
      * Returns the identifiers of all images in the atlas.
      */
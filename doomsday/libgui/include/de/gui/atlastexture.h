@@ -44,6 +44,17 @@ public:
     static AtlasTexture *newWithRowAllocator(Atlas::Flags const &flags = DefaultFlags,
                                              Atlas::Size const &totalSize = Atlas::Size());
 
+    /**
+     * Constructs an AtlasTexture with a SkylineAtlasAllocator.
+     *
+     * @param flags      Atlas flags.
+     * @param totalSize  Total size for atlas.
+     *
+     * @return AtlasTexture instance.
+     */
+    static AtlasTexture *newWithSkylineAllocator(Atlas::Flags const &flags = DefaultFlags,
+                                                 Atlas::Size const &totalSize = Atlas::Size());
+
     void clear();
 
 protected:
@@ -0,0 +1,72 @@
+/** @file skylineatlasallocator.h  Skyline-based atlas allocator.
+ *
+ * @authors Copyright (c) 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small> 
+ */
+
+#ifndef LIBGUI_SKYLINEATLASALLOCATOR_H
+#define LIBGUI_SKYLINEATLASALLOCATOR_H
+
+#include "../Atlas"
+
+namespace de {
+
+/**
+ * Skyline-based atlas allocator.
+ *
+ * Keeps track of the lowest used point along the width of the atlas (the
+ * "skyline") and places each new allocation where its bottom edge ends up as
+ * high as possible. Unlike RowAtlasAllocator, this does not waste space when
+ * the heights of the allocations vary.
+ *
+ * Space left unused below the skyline and space of released allocations is
+ * kept in a list of free rectangles, which is checked first when allocating.
+ * Defragmentation is done incrementally as allocations are released: adjacent
+ * free rectangles are merged, and free space directly on top of the skyline
+ * is returned to it. A full repacking with optimize() is therefore needed
+ * less often.
+ *
+ * @see Atlas
+ */
+class LIBGUI_PUBLIC SkylineAtlasAllocator : public Atlas::IAllocator
+{
+public:
+    SkylineAtlasAllocator();
+
+    void setMetrics(Atlas::Size const &totalSize, int margin);
+
+    void clear();
+    Id allocate(Atlas::Size const &size, Rectanglei &rect);
+    void release(Id const &id);
+    bool optimize();
+
+    int count() const;
+    Atlas::Ids ids() const;
+    void rect(Id const &id, Rectanglei &rect) const;
+    Allocations allocs() const;
+
+    /**
+     * Returns the number of free rectangles below the skyline. This is an
+     * indication of how fragmented the atlas is.
+     */
+    int freeRectCount() const;
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+} // namespace de
+
+#endif // LIBGUI_SKYLINEATLASALLOCATOR_H
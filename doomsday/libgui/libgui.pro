@@ -72,6 +72,7 @@ HEADERS += \
     include/de/MouseEventSource \
     include/de/PersistentCanvasWindow \
     include/de/RowAtlasAllocator \
+    include/de/SkylineAtlasAllocator \
     include/de/VertexBuilder \
     \
     include/de/gui/atlas.h \
@@ -105,6 +106,7 @@ HEADERS += \
     include/de/gui/opengl.h \
     include/de/gui/persistentcanvaswindow.h \
     include/de/gui/rowatlasallocator.h \
+    include/de/gui/skylineatlasallocator.h \
     include/de/gui/vertexbuilder.h
 
 # Sources and private headers.
@@ -133,7 +135,8 @@ SOURCES +=  \
     src/keyevent.cpp \
     src/mouseevent.cpp \
     src/persistentcanvaswindow.cpp \
-    src/rowatlasallocator.cpp
+    src/rowatlasallocator.cpp \
+    src/skylineatlasallocator.cpp
 
 # DisplayMode
 !deng_nodisplaymode {
@@ -290,6 +290,13 @@ int Atlas::imageCount() const
     return d->allocator->count();
 }
 
+float Atlas::occupancy() const
+{
+    DENG2_GUARD(this);
+
+    return d->usedPercentage();
+}
+
 Atlas::Ids Atlas::allImages() const
 {
     DENG2_GUARD(this);
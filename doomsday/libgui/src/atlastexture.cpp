@@ -18,6 +18,7 @@
 
 #include "de/AtlasTexture"
 #include "de/RowAtlasAllocator"
+#include "de/SkylineAtlasAllocator"
 
 namespace de {
 
@@ -35,6 +36,13 @@ AtlasTexture *AtlasTexture::newWithRowAllocator(Atlas::Flags const &flags, Atlas
     return atlas;
 }
 
+AtlasTexture *AtlasTexture::newWithSkylineAllocator(Atlas::Flags const &flags, Atlas::Size const &totalSize)
+{
+    AtlasTexture *atlas = new AtlasTexture(flags, totalSize);
+    atlas->setAllocator(new SkylineAtlasAllocator);
+    return atlas;
+}
+
 void AtlasTexture::clear()
 {
     Atlas::clear();
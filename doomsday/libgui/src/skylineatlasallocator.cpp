@@ -0,0 +1,456 @@
+/** @file skylineatlasallocator.cpp  Skyline-based atlas allocator.
+ *
+ * @authors Copyright (c) 2013 Deng Team
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/SkylineAtlasAllocator"
+
+#include <QList>
+
+namespace de {
+
+DENG2_PIMPL(SkylineAtlasAllocator)
+{
+    /// Horizontal segment of the skyline. Everything below @a y is unused.
+    struct Segment {
+        int x;
+        int y;
+        int width;
+
+        Segment(int x_, int y_, int width_) : x(x_), y(y_), width(width_) {}
+        int right() const { return x + width; }
+    };
+    typedef QList<Segment> Skyline;
+
+    /// Free area above the skyline.
+    struct Area {
+        int x;
+        int y;
+        int width;
+        int height;
+
+        Area(int x_, int y_, int width_, int height_)
+            : x(x_), y(y_), width(width_), height(height_) {}
+        int right() const { return x + width; }
+        int bottom() const { return y + height; }
+        int area() const { return width * height; }
+    };
+    typedef QList<Area> Areas;
+
+    Atlas::Size size;
+    int margin;
+    Allocations allocs;
+    Skyline skyline;
+    Areas unused;
+
+    Instance(Public *i) : Base(i), margin(0)
+    {}
+
+    void resetLayout()
+    {
+        unused.clear();
+        skyline.clear();
+        skyline.append(Segment(margin, margin, int(size.x) - margin));
+    }
+
+    /*
+     * All the areas handled below include the margin that follows each
+     * allocation on the right and at the bottom. The margin will be left as a
+     * gap between regions.
+     */
+
+    /**
+     * Checks if an area fits on the skyline, with its left edge at the start of
+     * segment @a index.
+     *
+     * @param y  Top edge of the area, if it fits.
+     */
+    bool fitsOnSkyline(int index, int width, int height, int &y) const
+    {
+        if(skyline[index].x + width > int(size.x)) return false;
+
+        y = 0;
+        for(int i = index, left = width; left > 0; ++i)
+        {
+            DENG2_ASSERT(i < skyline.size());
+
+            y = de::max(y, skyline[i].y);
+            if(y + height > int(size.y)) return false;
+
+            left -= skyline[i].width;
+        }
+        return true;
+    }
+
+    void mergeSegments()
+    {
+        for(int i = 0; i < skyline.size() - 1; )
+        {
+            if(skyline[i].y == skyline[i + 1].y)
+            {
+                skyline[i].width += skyline[i + 1].width;
+                skyline.removeAt(i + 1);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    bool allocOnSkyline(int width, int height, Vector2i &pos)
+    {
+        // Choose the position where the bottom edge ends up highest.
+        int best = -1;
+        int bestY = 0;
+        for(int i = 0; i < skyline.size(); ++i)
+        {
+            int y;
+            if(!fitsOnSkyline(i, width, height, y)) continue;
+
+            if(best < 0 || y < bestY ||
+               (y == bestY && skyline[i].width < skyline[best].width))
+            {
+                best  = i;
+                bestY = y;
+            }
+        }
+        if(best < 0) return false;
+
+        int const x = skyline[best].x;
+        pos = Vector2i(x, bestY);
+
+        // Space between the skyline and the new area remains unused.
+        for(int i = best; i < skyline.size() && skyline[i].x < x + width; ++i)
+        {
+            Segment const &seg = skyline[i];
+            if(seg.y < bestY)
+            {
+                unused.append(Area(seg.x, seg.y, de::min(seg.right(), x + width) - seg.x,
+                                   bestY - seg.y));
+            }
+        }
+
+        // Raise the skyline.
+        skyline.insert(best, Segment(x, bestY + height, width));
+        for(int i = best + 1; i < skyline.size(); )
+        {
+            Segment &seg = skyline[i];
+            if(seg.x >= x + width) break;
+
+            int const covered = x + width - seg.x;
+            if(covered >= seg.width)
+            {
+                skyline.removeAt(i);
+                continue;
+            }
+            seg.x     += covered;
+            seg.width -= covered;
+            break;
+        }
+        mergeSegments();
+        return true;
+    }
+
+    bool allocFromUnused(int width, int height, Vector2i &pos)
+    {
+        // Choose the area that leaves the least space unused.
+        int best = -1;
+        for(int i = 0; i < unused.size(); ++i)
+        {
+            Area const &area = unused[i];
+            if(area.width < width || area.height < height) continue;
+
+            if(best < 0 || area.area() < unused[best].area())
+            {
+                best = i;
+            }
+        }
+        if(best < 0) return false;
+
+        Area const area = unused.takeAt(best);
+        pos = Vector2i(area.x, area.y);
+
+        // Split the remainder along the shorter leftover axis so that the
+        // larger piece stays as big as possible.
+        int const leftoverWidth  = area.width  - width;
+        int const leftoverHeight = area.height - height;
+        if(leftoverWidth < leftoverHeight)
+        {
+            if(leftoverWidth)  unused.append(Area(area.x + width, area.y, leftoverWidth, height));
+            if(leftoverHeight) unused.append(Area(area.x, area.y + height, area.width, leftoverHeight));
+        }
+        else
+        {
+            if(leftoverWidth)  unused.append(Area(area.x + width, area.y, leftoverWidth, area.height));
+            if(leftoverHeight) unused.append(Area(area.x, area.y + height, width, leftoverHeight));
+        }
+        return true;
+    }
+
+    bool alloc(Atlas::Size const &allocSize, Rectanglei &rect)
+    {
+        int const width  = allocSize.x + margin;
+        int const height = allocSize.y + margin;
+
+        Vector2i pos;
+        if(!allocFromUnused(width, height, pos) &&
+           !allocOnSkyline(width, height, pos))
+        {
+            return false;
+        }
+        rect = Rectanglei::fromSize(pos, allocSize);
+        return true;
+    }
+
+    /**
+     * Lowers the skyline to the top of @a area, if the area lies directly on
+     * the skyline along its full width.
+     */
+    bool returnToSkyline(Area const &area)
+    {
+        bool touches = false;
+        DENG2_FOR_EACH_CONST(Skyline, i, skyline)
+        {
+            if(i->right() <= area.x) continue;
+            if(i->x >= area.right()) break;
+            if(i->y != area.bottom()) return false;
+            touches = true;
+        }
+        if(!touches) return false;
+
+        Skyline lowered;
+        bool inserted = false;
+        DENG2_FOR_EACH_CONST(Skyline, i, skyline)
+        {
+            if(i->right() <= area.x || i->x >= area.right())
+            {
+                lowered.append(*i);
+                continue;
+            }
+            if(i->x < area.x)
+            {
+                lowered.append(Segment(i->x, i->y, area.x - i->x));
+            }
+            if(!inserted)
+            {
+                lowered.append(Segment(area.x, area.y, area.width));
+                inserted = true;
+            }
+            if(i->right() > area.right())
+            {
+                lowered.append(Segment(area.right(), i->y, i->right() - area.right()));
+            }
+        }
+        skyline = lowered;
+        mergeSegments();
+        return true;
+    }
+
+    /**
+     * Marks an area unused. This is where the incremental defragmentation
+     * happens: the area is merged with its unused neighbors, and returned to
+     * the skyline if possible.
+     */
+    void addUnused(Area area)
+    {
+        for(bool merged = true; merged; )
+        {
+            merged = false;
+            for(int i = 0; i < unused.size(); ++i)
+            {
+                Area const &other = unused[i];
+                if(other.x == area.x && other.width == area.width &&
+                   (other.bottom() == area.y || area.bottom() == other.y))
+                {
+                    area.y = de::min(area.y, other.y);
+                    area.height += other.height;
+                }
+                else if(other.y == area.y && other.height == area.height &&
+                        (other.right() == area.x || area.right() == other.x))
+                {
+                    area.x = de::min(area.x, other.x);
+                    area.width += other.width;
+                }
+                else
+                {
+                    continue;
+                }
+                unused.removeAt(i);
+                merged = true;
+                break;
+            }
+        }
+
+        if(!returnToSkyline(area))
+        {
+            unused.append(area);
+            return;
+        }
+
+        // The skyline was lowered, so other unused areas may now lie on it.
+        for(int i = 0; i < unused.size(); )
+        {
+            if(returnToSkyline(unused[i]))
+            {
+                unused.removeAt(i);
+                i = 0;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    struct ContentSize {
+        Id::Type id;
+        int width;
+        int height;
+
+        ContentSize(Id const &allocId, Vector2ui const &size)
+            : id(allocId), width(size.x), height(size.y) {}
+
+        // Sort descending.
+        bool operator < (ContentSize const &other) const {
+            if(height == other.height) {
+                // Secondary sorting by descending width.
+                return width > other.width;
+            }
+            return height > other.height;
+        }
+    };
+
+    bool optimize()
+    {
+        QList<ContentSize> descending;
+        DENG2_FOR_EACH(Allocations, i, allocs)
+        {
+            descending.append(ContentSize(i.key(), i.value().size()));
+        }
+        qSort(descending);
+
+        Skyline const oldSkyline = skyline;
+        Areas const oldUnused = unused;
+        resetLayout();
+
+        // Place the tallest allocations first.
+        Allocations optimal;
+        DENG2_FOR_EACH_CONST(QList<ContentSize>, i, descending)
+        {
+            Rectanglei optRect;
+            if(!alloc(allocs[i->id].size(), optRect))
+            {
+                // Failed to optimize: maybe the new total size is smaller
+                // than what we had before. Keep the old layout.
+                skyline = oldSkyline;
+                unused  = oldUnused;
+                return false;
+            }
+            optimal[i->id] = optRect;
+        }
+
+        // Use the new layout.
+        allocs = optimal;
+        return true;
+    }
+};
+
+SkylineAtlasAllocator::SkylineAtlasAllocator() : d(new Instance(this))
+{}
+
+void SkylineAtlasAllocator::setMetrics(Atlas::Size const &totalSize, int margin)
+{
+    int const oldWidth = d->size.x;
+
+    d->size   = totalSize;
+    d->margin = margin;
+
+    // The existing allocations stay in place when the atlas grows, so the
+    // skyline must reach the new right edge.
+    if(!d->skyline.isEmpty() && int(totalSize.x) > oldWidth)
+    {
+        d->skyline.append(Instance::Segment(oldWidth, margin, int(totalSize.x) - oldWidth));
+        d->mergeSegments();
+    }
+}
+
+void SkylineAtlasAllocator::clear()
+{
+    d->allocs.clear();
+    d->resetLayout();
+}
+
+Id SkylineAtlasAllocator::allocate(Atlas::Size const &size, Rectanglei &rect)
+{
+    if(!d->alloc(size, rect))
+    {
+        // We're completely tapped out.
+        return 0;
+    }
+
+    Id newId;
+    d->allocs[newId] = rect;
+    return newId;
+}
+
+void SkylineAtlasAllocator::release(Id const &id)
+{
+    DENG2_ASSERT(d->allocs.contains(id));
+
+    Rectanglei const rect = d->allocs.take(id);
+    d->addUnused(Instance::Area(rect.topLeft.x, rect.topLeft.y,
+                                rect.width()  + d->margin,
+                                rect.height() + d->margin));
+}
+
+int SkylineAtlasAllocator::count() const
+{
+    return d->allocs.size();
+}
+
+Atlas::Ids SkylineAtlasAllocator::ids() const
+{
+    Atlas::Ids ids;
+    foreach(Id const &id, d->allocs.keys())
+    {
+        ids.insert(id);
+    }
+    return ids;
+}
+
+void SkylineAtlasAllocator::rect(Id const &id, Rectanglei &rect) const
+{
+    DENG2_ASSERT(d->allocs.contains(id));
+    rect = d->allocs[id];
+}
+
+SkylineAtlasAllocator::Allocations SkylineAtlasAllocator::allocs() const
+{
+    return d->allocs;
+}
+
+bool SkylineAtlasAllocator::optimize()
+{
+    return d->optimize();
+}
+
+int SkylineAtlasAllocator::freeRectCount() const
+{
+    return d->unused.size();
+}
+
+} // namespace de
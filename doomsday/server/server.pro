@@ -230,6 +230,7 @@ DENG_HEADERS += \
     $$SRC/include/uri.hh \
     $$SRC/include/world/dmuargs.h \
     $$SRC/include/world/blockmap.h \
+    $$SRC/include/world/bsp/bspcache.h \
     $$SRC/include/world/bsp/bsptreenode.h \
     $$SRC/include/world/bsp/convexsubspace.h \
     $$SRC/include/world/bsp/edgetip.h \
@@ -373,6 +374,7 @@ SOURCES += \
     $$SRC/src/resource/compositetexture.cpp \
     $$SRC/src/resource/hq2x.cpp \
     $$SRC/src/resource/image.cpp \
+    $$SRC/src/resource/lumpcache.cpp \
     $$SRC/src/resource/material.cpp \
     $$SRC/src/resource/materialarchive.cpp \
     $$SRC/src/resource/materialmanifest.cpp \
@@ -401,6 +403,7 @@ SOURCES += \
     $$SRC/src/world/api_map.cpp \
     $$SRC/src/world/api_mapedit.cpp \
     $$SRC/src/world/blockmap.cpp \
+    $$SRC/src/world/bsp/bspcache.cpp \
     $$SRC/src/world/bsp/convexsubspace.cpp \
     $$SRC/src/world/bsp/hplane.cpp \
     $$SRC/src/world/bsp/linesegment.cpp \
@@ -1,6 +1,9 @@
 include(../config.pri)
 include(../dep_deng2.pri)
 
+# Shared test headers (testcheck.h).
+INCLUDEPATH += $$PWD
+
 mod.files = \
     $$DENG_MODULES_DIR/Config.de \
     $$DENG_MODULES_DIR/recutil.de
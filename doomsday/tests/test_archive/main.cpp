@@ -25,9 +25,13 @@
 #include <de/Reader>
 #include <de/Writer>
 #include <de/FS>
+#include <de/PackageFolder>
+#include <de/ArchiveIndexCache>
 
 #include <QDebug>
 
+#include "testcheck.h"
+
 using namespace de;
 
 int main(int argc, char **argv)
@@ -55,6 +59,63 @@ int main(int argc, char **argv)
         String content = String::fromUtf8(Block(hello));
         LOG_MSG("The contents: \"%s\"") << content;
 
+        // The content index can be reused instead of parsing the central
+        // directory again.
+        PackageFolder &pack = app.fileSystem().find<PackageFolder>("test.zip");
+        Block serializedIndex;
+        static_cast<ZipArchive &>(pack.archive()).writeIndex(serializedIndex);
+        ZipArchive cached(*pack.archive().source(), serializedIndex);
+        LOG_MSG("Index of test.zip: %i bytes, hello.txt from the cached index: \"%s\"")
+                << serializedIndex.size()
+                << String::fromUtf8(cached.constEntryBlock(Path("hello.txt")));
+
+        Archive::Names names, cachedNames;
+        pack.archive().listFiles(names);
+        cached.listFiles(cachedNames);
+        check(!names.empty() && names == cachedNames, "cached index lists the same entries");
+        DENG2_FOR_EACH_CONST(Archive::Names, i, names)
+        {
+            check(cached.constEntryBlock(Path(*i)) == pack.archive().constEntryBlock(Path(*i)),
+                  "entry read with the cached index equals the original");
+        }
+
+        // An index with an unsupported compression method is rejected.
+        {
+            Block badIndex;
+            Writer(badIndex) << duint32(1) << String("bad.txt") << duint64(0) << duint64(0)
+                             << duint64(0) << duint16(99) << duint32(0) << duint64(0) << Time();
+            bool rejected = false;
+            try
+            {
+                ZipArchive bad(*pack.archive().source(), badIndex);
+            }
+            catch(ZipArchive::UnknownCompressionError const &)
+            {
+                rejected = true;
+            }
+            check(rejected, "unknown compression in a cached index is rejected");
+        }
+
+        // A cached index is only valid for the same status of the archive.
+        {
+            NativePath const archivePath("test.zip");
+            File::Status const status(1234, Time());
+            ArchiveIndexCache cache;
+            cache.insert(archivePath, status, serializedIndex);
+
+            Block found;
+            check(cache.find(archivePath, status, found) && found == serializedIndex,
+                  "cached index found with the same status");
+            check(!cache.find(archivePath, File::Status(status.size + 1, status.modifiedAt), found),
+                  "changed size misses the cache");
+            check(!cache.find(archivePath, File::Status(status.size, status.modifiedAt + 1.0), found),
+                  "changed modification time misses the cache");
+
+            int hits, misses;
+            cache.statistics(hits, misses);
+            check(hits == 1 && misses == 2, "cache statistics");
+        }
+
         try
         {
             // Make a second entry.
@@ -80,8 +141,9 @@ int main(int argc, char **argv)
     catch(Error const &err)
     {
         qWarning() << err.asText();
+        return 1;
     }
 
     qDebug() << "Exiting main()...";
-    return 0;        
+    return checkResult();
 }
@@ -0,0 +1,345 @@
+/**
+ * @file main.cpp
+ *
+ * Atlas allocator benchmark. @ingroup tests
+ *
+ * Replays a trace of atlas allocations and releases and reports how full the
+ * atlas gets and how long the allocations take with each allocator. No GL is
+ * used. The trace is read from the file given on the command line, or else
+ * generated to resemble the usage of the log widget's entry atlas.
+ *
+ * Trace format, one event per line:
+ * - <tt>a KEY WIDTH HEIGHT</tt>: allocate an image for KEY
+ * - <tt>r KEY</tt>: release the image of KEY
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/TextApp>
+#include <de/Atlas>
+#include <de/RowAtlasAllocator>
+#include <de/SkylineAtlasAllocator>
+#include <de/Time>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QTextStream>
+
+#include "testcheck.h"
+
+using namespace de;
+
+/// Same as the size of the log widget's entry atlas.
+static Atlas::Size const ATLAS_SIZE(4096, 2048);
+
+struct Event
+{
+    bool alloc;
+    int key;
+    Atlas::Size size;
+
+    Event(bool a, int k, Atlas::Size const &s = Atlas::Size()) : alloc(a), key(k), size(s) {}
+};
+
+typedef QList<Event> Trace;
+
+/**
+ * Checks that all the allocations lie inside an atlas of size @a size and
+ * that no two of them overlap.
+ */
+static bool isValidLayout(QList<Rectanglei> const &rects, Atlas::Size const &size)
+{
+    for(int i = 0; i < rects.size(); ++i)
+    {
+        Rectanglei const &a = rects[i];
+        if(a.left() < 0 || a.top() < 0 ||
+           a.right() > int(size.x) || a.bottom() > int(size.y))
+        {
+            qWarning() << "Allocation" << a.asText() << "is outside the atlas";
+            return false;
+        }
+        for(int k = i + 1; k < rects.size(); ++k)
+        {
+            Rectanglei const &b = rects[k];
+            if(a.left() < b.right() && b.left() < a.right() &&
+               a.top() < b.bottom() && b.top() < a.bottom())
+            {
+                qWarning() << "Allocations" << a.asText() << "and" << b.asText() << "overlap";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool isValidLayout(Atlas const &atlas)
+{
+    QList<Rectanglei> rects;
+    foreach(Id const &id, atlas.allImages())
+    {
+        rects.append(atlas.imageRect(id));
+    }
+    return isValidLayout(rects, atlas.totalSize());
+}
+
+/// Atlas whose content is not committed anywhere.
+class BenchmarkAtlas : public Atlas, DENG2_OBSERVES(Atlas, Reposition)
+{
+public:
+    int defragCount;
+
+    BenchmarkAtlas()
+        : Atlas(BackingStore | AllowDefragment, ATLAS_SIZE), defragCount(0)
+    {
+        audienceForReposition += this;
+    }
+
+    void atlasContentRepositioned(Atlas &)
+    {
+        defragCount++;
+        check(isValidLayout(*this), "valid layout after defragmenting");
+    }
+
+protected:
+    void commitFull(Image const &) const {}
+    void commit(Image const &, Vector2i const &) const {}
+};
+
+static bool readTrace(String const &path, Trace &trace)
+{
+    QFile file(path);
+    if(!file.open(QFile::ReadOnly | QFile::Text)) return false;
+
+    QTextStream is(&file);
+    while(!is.atEnd())
+    {
+        QString type;
+        int key = 0;
+        is >> type >> key;
+        if(type == "a")
+        {
+            int w = 0, h = 0;
+            is >> w >> h;
+            trace.append(Event(true, key, Atlas::Size(w, h)));
+        }
+        else if(type == "r")
+        {
+            trace.append(Event(false, key));
+        }
+        is.readLine();
+    }
+    return true;
+}
+
+/**
+ * Generates a trace like the one produced by the log widget: entries of one
+ * or more wrapped lines are added at the bottom, each line consisting of a
+ * few segments with different styles (and heights). Old entries are pruned,
+ * and everything is reallocated when the text is rewrapped to a new width.
+ */
+static void generateTrace(Trace &trace)
+{
+    int const MAX_ENTRIES = 1000;
+    int const NUM_ENTRIES = 20000;
+    int const lineHeights[] = { 14, 16, 20, 28 };
+
+    qsrand(1);
+
+    int width = 800;
+    int key = 0;
+    QList<QList<int> > entries; // Keys of each entry's segments.
+    QHash<int, Atlas::Size> sizes;
+
+    for(int n = 0; n < NUM_ENTRIES; ++n)
+    {
+        if(n && !(n % 5000))
+        {
+            // The widget was resized; rewrap everything.
+            width = 600 + qrand() % 600;
+            for(int i = 0; i < entries.size(); ++i)
+            {
+                for(int k = 0; k < entries[i].size(); ++k)
+                {
+                    int const seg = entries[i][k];
+                    trace.append(Event(false, seg));
+                    Atlas::Size size = sizes[seg];
+                    size.x = de::min(int(size.x), width);
+                    trace.append(Event(true, seg, size));
+                    sizes[seg] = size;
+                }
+            }
+        }
+
+        QList<int> entry;
+        int const lines = (qrand() % 8 == 0? 2 + qrand() % 6 : 1);
+        int const height = lineHeights[qrand() % 4 == 0? qrand() % 4 : 1];
+        for(int i = 0; i < lines; ++i)
+        {
+            int left = width;
+            int const segments = 1 + qrand() % 3;
+            for(int s = 0; s < segments && left > 8; ++s)
+            {
+                int const w = (s == segments - 1? left : 8 + qrand() % left);
+                Atlas::Size const size(w, height);
+                trace.append(Event(true, key, size));
+                sizes[key] = size;
+                entry.append(key++);
+                left -= w;
+            }
+        }
+        entries.append(entry);
+
+        if(entries.size() > MAX_ENTRIES)
+        {
+            foreach(int seg, entries.takeFirst())
+            {
+                trace.append(Event(false, seg));
+            }
+        }
+    }
+}
+
+static void replay(Trace const &trace, Atlas::IAllocator *allocator, char const *name)
+{
+    BenchmarkAtlas atlas;
+    atlas.setAllocator(allocator);
+
+    QHash<int, Id> ids;
+    QList<int> order; // Allocated keys, oldest first.
+    int allocCount = 0;
+    int outOfSpace = 0;
+    double occupancySum = 0;
+    int eventCount = 0;
+    TimeDelta allocTime = 0;
+
+    foreach(Event const &ev, trace)
+    {
+        if(ev.alloc)
+        {
+            Image const image(QImage(QSize(ev.size.x, ev.size.y), QImage::Format_ARGB32));
+
+            for(;;)
+            {
+                Time startedAt;
+                Id const id = atlas.alloc(image);
+                allocTime += startedAt.since();
+                if(!id.isNone())
+                {
+                    Rectanglei const rect = atlas.imageRect(id);
+                    check(rect.size() == ev.size, "allocation has the requested size");
+                    check(isValidLayout(QList<Rectanglei>() << rect, atlas.totalSize()),
+                          "allocation inside the atlas");
+
+                    ids.insert(ev.key, id);
+                    order.append(ev.key);
+                    allocCount++;
+                    break;
+                }
+                outOfSpace++;
+                if(order.isEmpty()) break; // Does not fit at all.
+
+                // Make room like the log widget does, by letting go of the
+                // entries that were allocated earliest.
+                for(int i = 0; i < 20 && !order.isEmpty(); ++i)
+                {
+                    atlas.release(ids.take(order.takeFirst()));
+                }
+            }
+        }
+        else if(ids.contains(ev.key))
+        {
+            atlas.release(ids.take(ev.key));
+            order.removeOne(ev.key);
+        }
+        occupancySum += atlas.occupancy();
+
+        if(!(++eventCount % 1000))
+        {
+            check(isValidLayout(atlas), "valid layout during replay");
+        }
+    }
+    check(isValidLayout(atlas), "valid layout after replay");
+
+    qDebug() << name << ":" << allocCount << "allocations," << outOfSpace << "out of space,"
+             << atlas.defragCount << "defragmentations";
+    qDebug() << "  average fill" << 100 * occupancySum / de::max(1, trace.size()) << "%, final fill"
+             << 100 * atlas.occupancy() << "%";
+    qDebug() << "  allocation time" << allocTime * 1000 << "ms," << allocTime * 1.0e6 / de::max(1, allocCount)
+             << "us per allocation";
+}
+
+/**
+ * Fills an allocator, grows its total size, and checks that the added space
+ * is used without overlapping the existing allocations.
+ */
+static void testGrowing(Atlas::IAllocator *allocator, char const *name)
+{
+    QScopedPointer<Atlas::IAllocator> alloc(allocator);
+    Atlas::Size const itemSize(30, 20);
+    Rectanglei rect;
+
+    alloc->setMetrics(Atlas::Size(256, 256), 1);
+    alloc->clear();
+    while(!alloc->allocate(itemSize, rect).isNone()) {}
+    int const fullCount = alloc->count();
+    check(isValidLayout(alloc->allocs().values(), Atlas::Size(256, 256)), "valid layout when full");
+
+    alloc->setMetrics(Atlas::Size(512, 256), 1);
+    while(!alloc->allocate(itemSize, rect).isNone()) {}
+    check(alloc->count() > fullCount, "space added by growing is used");
+    check(isValidLayout(alloc->allocs().values(), Atlas::Size(512, 256)), "valid layout after growing");
+
+    qDebug() << name << ":" << fullCount << "allocations before growing," << alloc->count() << "after";
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        TextApp app(argc, argv);
+        app.initSubsystems(App::DisablePlugins);
+
+        Trace trace;
+        if(argc > 1)
+        {
+            if(!readTrace(argv[1], trace))
+            {
+                qWarning() << "Failed to read" << argv[1];
+                return 1;
+            }
+        }
+        else
+        {
+            generateTrace(trace);
+        }
+        qDebug() << "Replaying" << trace.size() << "events in a"
+                 << ATLAS_SIZE.asText() << "atlas";
+
+        replay(trace, new RowAtlasAllocator, "RowAtlasAllocator");
+        replay(trace, new SkylineAtlasAllocator, "SkylineAtlasAllocator");
+
+        testGrowing(new RowAtlasAllocator, "RowAtlasAllocator");
+        testGrowing(new SkylineAtlasAllocator, "SkylineAtlasAllocator");
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText();
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...";
+    return checkResult();
+}
@@ -0,0 +1,15 @@
+CONFIG += deng_qtgui
+
+include(../config_test.pri)
+include(../../dep_gui.pri)
+
+TEMPLATE = app
+TARGET = test_atlas
+
+SOURCES += main.cpp
+
+deployTest($$TARGET)
+
+macx {
+    linkBinaryToBundledLibdengGui($${TARGET}.app/Contents/MacOS/$${TARGET})
+}
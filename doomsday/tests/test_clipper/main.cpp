@@ -0,0 +1,429 @@
+/**
+ * @file main.cpp
+ *
+ * Angle clipper range tests and benchmark. @ingroup tests
+ *
+ * Replays a trace of clip range operations against the sorted range array of
+ * the client's angle clipper and against a copy of the original clip node
+ * list implementation, checks that both give the same answers, and reports how
+ * long the replay takes with each. The trace is read from the file given on
+ * the command line, or else generated to resemble the front-to-back rendering
+ * of a map (many narrow ranges, most of them adjacent to earlier ones).
+ *
+ * Trace format, one operation per line (angles are 16-bit binary angles):
+ * - <tt>c</tt>: clear all ranges (start of a frame)
+ * - <tt>a START END</tt>: add a range
+ * - <tt>r START END</tt>: check whether a range is visible
+ * - <tt>v ANGLE</tt>: check whether an angle is visible
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/Time>
+#include <de/math.h>
+#include <QDebug>
+#include <QFile>
+#include <QList>
+#include <QTextStream>
+#include <vector>
+
+#include "render/cliprangearray.h"
+#include "testcheck.h"
+
+using namespace de;
+
+static int const NUM_FRAMES = 200;
+static int const NUM_ADDS_PER_FRAME = 600;
+static int const NUM_REPEATS = 20;
+
+/**
+ * The clip node list of the angle clipper before the range array was added
+ * (C_AddRange() in rend_clip.cpp). Unused nodes are kept for reuse, like the
+ * clipper's rover does.
+ */
+class ClipNodeList
+{
+public:
+    ClipNodeList() : _head(0), _used(0) {}
+
+    ~ClipNodeList()
+    {
+        for(std::size_t i = 0; i < _nodes.size(); ++i) delete _nodes[i];
+    }
+
+    void clear()
+    {
+        _head = 0;
+        _used = 0;
+        _free.clear();
+    }
+
+    void add(binangle_t startAngle, binangle_t endAngle)
+    {
+        if(!_head)
+        {
+            _head = newNode(startAngle, endAngle);
+            return;
+        }
+
+        // Check that the new range isn't contained by any of the old ones.
+        for(Node *ci = _head; ci; ci = ci->next)
+        {
+            if(startAngle >= ci->start && endAngle <= ci->end)
+                return;
+        }
+
+        // Remove the old ranges contained by the new one.
+        for(Node *ci = _head; ci;)
+        {
+            if(ci->start >= startAngle && ci->end <= endAngle)
+            {
+                Node *crange = ci;
+                ci = ci->next;
+                remove(crange);
+                continue;
+            }
+            ci = ci->next;
+        }
+
+        // The new range may overlap one or two (consecutive) old ranges.
+        Node *crange = 0;
+        for(Node *ci = _head; ci; ci = ci->next)
+        {
+            if(ci->start < endAngle)
+            {
+                crange = ci;
+            }
+
+            if(ci->start >= startAngle && ci->start <= endAngle)
+            {
+                ci->start = startAngle;
+                return;
+            }
+
+            if(ci->end >= startAngle && ci->end <= endAngle)
+            {
+                crange = ci->next;
+                if(!crange)
+                {
+                    ci->end = endAngle;
+                }
+                else if(crange->start <= endAngle)
+                {
+                    ci->end = crange->end;
+                    remove(crange);
+                }
+                else
+                {
+                    ci->end = endAngle;
+                }
+                return;
+            }
+        }
+
+        // Disconnected from the others; crange marks the spot.
+        if(!crange)
+        {
+            crange = _head;
+            _head = newNode(startAngle, endAngle);
+            _head->next = crange;
+            if(crange) crange->prev = _head;
+        }
+        else
+        {
+            Node *ci = newNode(startAngle, endAngle);
+            ci->next = crange->next;
+            if(ci->next) ci->next->prev = ci;
+            ci->prev = crange;
+            crange->next = ci;
+        }
+    }
+
+    bool isRangeVisible(binangle_t startAngle, binangle_t endAngle) const
+    {
+        for(Node *ci = _head; ci; ci = ci->next)
+        {
+            if(startAngle >= ci->start && endAngle <= ci->end)
+                return false;
+        }
+        return true;
+    }
+
+    bool isAngleVisible(binangle_t angle) const
+    {
+        for(Node *ci = _head; ci; ci = ci->next)
+        {
+            if(angle > ci->start && angle < ci->end)
+                return false;
+        }
+        return true;
+    }
+
+    bool isFull() const
+    {
+        return _head && _head->start == 0 && _head->end == BANG_MAX;
+    }
+
+private:
+    struct Node
+    {
+        Node *prev, *next;
+        binangle_t start, end;
+    };
+
+    Node *newNode(binangle_t start, binangle_t end)
+    {
+        Node *node;
+        if(!_free.empty())
+        {
+            node = _free.back();
+            _free.pop_back();
+        }
+        else if(_used < _nodes.size())
+        {
+            node = _nodes[_used++];
+        }
+        else
+        {
+            node = new Node;
+            _nodes.push_back(node);
+            _used++;
+        }
+        node->start = start;
+        node->end = end;
+        node->prev = node->next = 0;
+        return node;
+    }
+
+    void remove(Node *node)
+    {
+        if(_head == node) _head = node->next;
+        if(node->prev) node->prev->next = node->next;
+        if(node->next) node->next->prev = node->prev;
+        node->prev = node->next = 0;
+        _free.push_back(node);
+    }
+
+    Node *_head;
+    std::size_t _used;
+    std::vector<Node *> _nodes;
+    std::vector<Node *> _free;
+};
+
+struct Operation
+{
+    enum Type { Clear, Add, CheckRange, CheckAngle };
+
+    Type type;
+    binangle_t start, end;
+
+    Operation(Type type = Clear, binangle_t start = 0, binangle_t end = 0)
+        : type(type), start(start), end(end) {}
+};
+
+typedef QList<Operation> Trace;
+
+static Trace loadTrace(QString const &fileName)
+{
+    Trace trace;
+    QFile file(fileName);
+    if(!file.open(QFile::ReadOnly | QFile::Text))
+    {
+        qWarning() << "Cannot read" << fileName;
+        return trace;
+    }
+    QTextStream is(&file);
+    while(!is.atEnd())
+    {
+        QString const line = is.readLine().trimmed();
+        if(line.isEmpty()) continue;
+
+        QStringList const args = line.split(' ', QString::SkipEmptyParts);
+        if(args[0] == "c")
+        {
+            trace << Operation(Operation::Clear);
+        }
+        else if(args[0] == "a" && args.size() >= 3)
+        {
+            trace << Operation(Operation::Add, args[1].toUShort(), args[2].toUShort());
+        }
+        else if(args[0] == "r" && args.size() >= 3)
+        {
+            trace << Operation(Operation::CheckRange, args[1].toUShort(), args[2].toUShort());
+        }
+        else if(args[0] == "v" && args.size() >= 2)
+        {
+            trace << Operation(Operation::CheckAngle, args[1].toUShort());
+        }
+    }
+    return trace;
+}
+
+/// Deterministic pseudo-random numbers, so that every run replays the same trace.
+static duint32 randomSeed = 1;
+static int randomNumber(int range)
+{
+    randomSeed = randomSeed * 1103515245 + 12345;
+    return int((randomSeed >> 8) % duint32(range));
+}
+
+/**
+ * Generates frames where the view is filled with walls front to back: each
+ * wall continues from a wall already drawn, or begins somewhere else, and
+ * walls and sprites behind the drawn ones are checked in between.
+ */
+static Trace generateTrace()
+{
+    Trace trace;
+    for(int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        trace << Operation(Operation::Clear);
+
+        int cursor = randomNumber(BANG_MAX);
+        for(int i = 0; i < NUM_ADDS_PER_FRAME; ++i)
+        {
+            if(randomNumber(8) == 0) cursor = randomNumber(BANG_MAX);
+
+            int const width = 1 + randomNumber(i < NUM_ADDS_PER_FRAME / 2? 300 : 2000);
+            int const start = cursor;
+            int const end   = de::min(start + width, int(BANG_MAX));
+            trace << Operation(Operation::Add, binangle_t(start), binangle_t(end));
+            cursor = (end < BANG_MAX? end : 0);
+
+            for(int k = 0; k < 3; ++k)
+            {
+                int const a = randomNumber(BANG_MAX);
+                int const b = de::min(a + randomNumber(1000), int(BANG_MAX));
+                trace << Operation(Operation::CheckRange, binangle_t(a), binangle_t(b));
+                trace << Operation(Operation::CheckAngle, binangle_t(randomNumber(BANG_MAX + 1)));
+            }
+        }
+
+        // Finally the whole view is covered.
+        trace << Operation(Operation::Add, 0, BANG_MAX);
+        trace << Operation(Operation::CheckAngle, binangle_t(randomNumber(BANG_MAX + 1)));
+    }
+    return trace;
+}
+
+/**
+ * Replays the trace. The answers to the checks (and whether the ranges are full
+ * after each addition) are appended to @a answers.
+ */
+template <typename RangesType>
+static void replay(Trace const &trace, RangesType &ranges, std::vector<bool> &answers)
+{
+    foreach(Operation const &op, trace)
+    {
+        switch(op.type)
+        {
+        case Operation::Clear:
+            ranges.clear();
+            break;
+
+        case Operation::Add:
+            ranges.add(op.start, op.end);
+            answers.push_back(ranges.isFull());
+            break;
+
+        case Operation::CheckRange:
+            answers.push_back(ranges.isRangeVisible(op.start, op.end));
+            break;
+
+        case Operation::CheckAngle:
+            answers.push_back(ranges.isAngleVisible(op.start));
+            break;
+        }
+    }
+}
+
+template <typename RangesType>
+static TimeDelta benchmark(Trace const &trace)
+{
+    RangesType ranges;
+    std::vector<bool> answers;
+    answers.reserve(trace.size());
+
+    Time startedAt;
+    for(int i = 0; i < NUM_REPEATS; ++i)
+    {
+        answers.clear();
+        replay(trace, ranges, answers);
+    }
+    return startedAt.since();
+}
+
+/// Ranges given in any order are merged into disjoint, sorted ranges.
+static void testMerging()
+{
+    ClipRangeArray ranges;
+    ranges.add(100, 200);
+    ranges.add(300, 400);
+    ranges.add(200, 300); // Touches both.
+    check(ranges.ranges().size() == 1, "touching ranges merged");
+    check(ranges.ranges()[0].start == 100 && ranges.ranges()[0].end == 400, "merged range");
+
+    ranges.add(50, 60);
+    ranges.add(500, 600);
+    ranges.add(550, 560); // Contained.
+    check(ranges.ranges().size() == 3, "disjoint ranges kept");
+    check(!ranges.isRangeVisible(120, 380), "contained range clipped");
+    check(ranges.isRangeVisible(380, 450), "partially clipped range visible");
+    check(ranges.isAngleVisible(100), "range edge not clipped");
+    check(!ranges.isAngleVisible(101), "angle inside range clipped");
+    check(!ranges.isFull(), "not full");
+
+    ranges.add(0, BANG_MAX);
+    check(ranges.isFull(), "full");
+
+    ranges.clear();
+    check(ranges.ranges().empty(), "empty after clearing");
+    check(ranges.isAngleVisible(101), "angle visible after clearing");
+}
+
+int main(int argc, char **argv)
+{
+    testMerging();
+
+    Trace const trace = (argc > 1? loadTrace(argv[1]) : generateTrace());
+    qDebug() << "Replaying" << trace.size() << "operations";
+
+    // Both implementations must give the same answers.
+    std::vector<bool> listAnswers, arrayAnswers;
+    {
+        ClipNodeList list;
+        replay(trace, list, listAnswers);
+
+        ClipRangeArray array;
+        replay(trace, array, arrayAnswers);
+    }
+    int mismatches = 0;
+    for(std::size_t i = 0; i < listAnswers.size(); ++i)
+    {
+        if(listAnswers[i] != arrayAnswers[i]) mismatches++;
+    }
+    qDebug() << "Answers:" << listAnswers.size() << "mismatches:" << mismatches;
+    check(!mismatches, "same answers as the clip node list");
+
+    TimeDelta const listTime  = benchmark<ClipNodeList>(trace);
+    TimeDelta const arrayTime = benchmark<ClipRangeArray>(trace);
+    double const ops = double(trace.size()) * NUM_REPEATS;
+
+    qDebug() << "List: " << listTime * 1000  << "ms" << ops / listTime  / 1.0e6 << "Mop/s";
+    qDebug() << "Array:" << arrayTime * 1000 << "ms" << ops / arrayTime / 1.0e6 << "Mop/s";
+
+    qDebug() << "Exiting main()...";
+    return checkResult();
+}
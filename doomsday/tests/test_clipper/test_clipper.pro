@@ -0,0 +1,15 @@
+include(../config_test.pri)
+
+TEMPLATE = app
+TARGET = test_clipper
+
+# The range array of the client's angle clipper is built into the test.
+INCLUDEPATH += \
+    $$PWD/../../client/include \
+    $$PWD/../../libdeng1/include
+
+SOURCES += \
+    main.cpp \
+    ../../client/src/render/cliprangearray.cpp
+
+deployTest($$TARGET)
@@ -0,0 +1,549 @@
+/**
+ * @file main.cpp
+ *
+ * Image resampling tests and benchmark. @ingroup tests
+ *
+ * Compares the output of the client's image resampling and mipmap reduction
+ * functions (gl_resample.cpp) with that of the original serial implementations,
+ * which are included here as the reference. Images of various sizes and pixel
+ * formats are generated deterministically; every component of the output must
+ * be within TOLERANCE of the reference. Finally the throughput of each
+ * function is reported in megapixels of source image per second.
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/fixedpoint.h>
+#include <de/math.h>
+#include <de/memory.h>
+#include <de/Time>
+#include <QDebug>
+#include <QVector>
+#include <cstdlib>
+#include <cstring>
+
+#include "gl/gl_resample.h"
+#include "testcheck.h"
+
+using namespace de;
+
+/// Largest allowed difference of an output component from the reference.
+static int const TOLERANCE = 1;
+
+static int const BENCHMARK_SIZE = 1024;
+static int const BENCHMARK_REPEATS = 5;
+
+namespace reference {
+
+// Copies of the original implementations (before the resampling functions
+// were made reentrant and parallel). Only unsigned byte data is handled.
+
+static void scaleLine(const uint8_t* in, int inStride, uint8_t* out, int outStride,
+    int outLen, int inLen, int comps)
+{
+    float inToOutScale = outLen / (float) inLen;
+    int i, c;
+
+    if(inToOutScale > 1)
+    {
+        fixed_t inPosDelta = (FRACUNIT * (inLen - 1)) / (outLen - 1);
+        fixed_t inPos = inPosDelta;
+        const uint8_t* col1, *col2;
+        int weight, invWeight;
+
+        memcpy(out, in, comps);
+        out += outStride;
+
+        for(i = 1; i < outLen - 1; ++i, out += outStride, inPos += inPosDelta)
+        {
+            col1 = in + (inPos >> FRACBITS) * inStride;
+            col2 = col1 + inStride;
+            weight = inPos & 0xffff;
+            invWeight = 0x10000 - weight;
+
+            for(c = 0; c < comps; ++c)
+                out[c] = (uint8_t)((col1[c] * invWeight + col2[c] * weight) >> 16);
+        }
+
+        memcpy(out, in + (inLen - 1) * inStride, comps);
+        return;
+    }
+
+    if(inToOutScale < 1)
+    {
+        uint cumul[4] = { 0, 0, 0, 0 }, count = 0;
+        int outpos = 0;
+
+        for(i = 0; i < inLen; ++i, in += inStride)
+        {
+            if((int) (i * inToOutScale) != outpos)
+            {
+                outpos = (int) (i * inToOutScale);
+
+                for(c = 0; c < comps; ++c)
+                {
+                    out[c] = (uint8_t)(cumul[c] / count);
+                    cumul[c] = 0;
+                }
+                count = 0;
+                out += outStride;
+            }
+            for(c = 0; c < comps; ++c)
+                cumul[c] += in[c];
+            count++;
+        }
+        if(count)
+            for(c = 0; c < comps; ++c)
+                out[c] = (uint8_t)(cumul[c] / count);
+        return;
+    }
+
+    for(i = outLen; i > 0; i--, out += outStride, in += inStride)
+    {
+        for(c = 0; c < comps; ++c)
+            out[c] = in[c];
+    }
+}
+
+static uint8_t* scaleBuffer(const uint8_t* in, int width, int height, int comps,
+    int outWidth, int outHeight)
+{
+    uint8_t* buffer = (uint8_t*) M_Malloc(comps * outWidth * height);
+    uint8_t* out = (uint8_t*) M_Malloc(comps * outWidth * outHeight);
+
+    for(int i = 0; i < height; ++i)
+    {
+        scaleLine(in + i * width * comps, comps, buffer + i * outWidth * comps, comps,
+                  outWidth, width, comps);
+    }
+
+    int const stride = outWidth * comps;
+    for(int i = 0; i < outWidth; ++i)
+    {
+        scaleLine(buffer + i * comps, stride, out + i * comps, stride,
+                  outHeight, height, comps);
+    }
+
+    M_Free(buffer);
+    return out;
+}
+
+static void* scaleBufferEx(const void* dataIn, int widthIn, int heightIn, int bpp,
+    int unpackRowLength, int unpackAlignment, int unpackSkipRows, int unpackSkipPixels,
+    int widthOut, int heightOut)
+{
+    int i, j, k, rowStride, rowLen;
+    float sx, sy;
+
+    float* tempIn  = (float*) M_Malloc(widthIn * heightIn * bpp * sizeof(float));
+    float* tempOut = (float*) M_Malloc(widthOut * heightOut * bpp * sizeof(float));
+
+    rowLen = (unpackRowLength > 0? unpackRowLength : widthIn);
+    if(1 >= unpackAlignment)
+        rowStride = bpp * rowLen;
+    else
+        rowStride = unpackAlignment * CEILING(bpp * rowLen, unpackAlignment);
+
+    k = 0;
+    for(i = 0; i < heightIn; ++i)
+    {
+        const uint8_t* ubptr = (const uint8_t*) dataIn
+            + i * rowStride
+            + unpackSkipRows * rowStride + unpackSkipPixels * bpp;
+        for(j = 0; j < widthIn * bpp; ++j)
+        {
+            tempIn[k++] = (float) *ubptr++;
+        }
+    }
+
+    if(widthOut > 1)
+        sx = (float) (widthIn - 1) / (float) (widthOut - 1);
+    else
+        sx = (float) (widthIn - 1);
+    if(heightOut > 1)
+        sy = (float) (heightIn - 1) / (float) (heightOut - 1);
+    else
+        sy = (float) (heightIn - 1);
+
+    if(sx < 1.0 && sy < 1.0)
+    {
+        int i0, i1, j0, j1;
+        float alpha, beta;
+        float* src00, *src01, *src10, *src11;
+        float s1, s2;
+        float* dst;
+
+        for(i = 0; i < heightOut; ++i)
+        {
+            i0 = i * sy;
+            i1 = i0 + 1;
+            if(i1 >= heightIn)
+                i1 = heightIn - 1;
+            alpha = i * sy - i0;
+            for(j = 0; j < widthOut; ++j)
+            {
+                j0 = j * sx;
+                j1 = j0 + 1;
+                if(j1 >= widthIn)
+                    j1 = widthIn - 1;
+                beta = j * sx - j0;
+
+                src00 = tempIn + (i0 * widthIn + j0) * bpp;
+                src01 = tempIn + (i0 * widthIn + j1) * bpp;
+                src10 = tempIn + (i1 * widthIn + j0) * bpp;
+                src11 = tempIn + (i1 * widthIn + j1) * bpp;
+
+                dst = tempOut + (i * widthOut + j) * bpp;
+
+                for(k = 0; k < bpp; ++k)
+                {
+                    s1 = *src00++ * (1.0 - beta) + *src01++ * beta;
+                    s2 = *src10++ * (1.0 - beta) + *src11++ * beta;
+                    *dst++ = s1 * (1.0 - alpha) + s2 * alpha;
+                }
+            }
+        }
+    }
+    else
+    {
+        int i0, i1, j0, j1, ii, jj;
+        float sum, *dst;
+
+        for(i = 0; i < heightOut; ++i)
+        {
+            i0 = i * sy;
+            i1 = i0 + 1;
+            if(i1 >= heightIn)
+                i1 = heightIn - 1;
+
+            for(j = 0; j < widthOut; ++j)
+            {
+                j0 = j * sx;
+                j1 = j0 + 1;
+                if(j1 >= widthIn)
+                    j1 = widthIn - 1;
+
+                dst = tempOut + (i * widthOut + j) * bpp;
+
+                for(k = 0; k < bpp; ++k)
+                {
+                    sum = 0.0;
+                    for(ii = i0; ii <= i1; ++ii)
+                    {
+                        for(jj = j0; jj <= j1; ++jj)
+                        {
+                            sum += *(tempIn + (ii * widthIn + jj) * bpp + k);
+                        }
+                    }
+                    sum /= (j1 - j0 + 1) * (i1 - i0 + 1);
+                    *dst++ = sum;
+                }
+            }
+        }
+    }
+    M_Free(tempIn);
+
+    // Packed without row padding or skipping.
+    uint8_t* dataOut = (uint8_t*) M_Malloc(bpp * widthOut * heightOut);
+    for(k = 0; k < widthOut * heightOut * bpp; ++k)
+    {
+        dataOut[k] = (uint8_t) tempOut[k];
+    }
+    M_Free(tempOut);
+    return dataOut;
+}
+
+static void downMipmap32(uint8_t* in, int width, int height, int comps)
+{
+    int x, y, c, outW = width >> 1, outH = height >> 1;
+    uint8_t* out;
+
+    if(!outW || !outH)
+    {
+        int outDim = (width > 1 ? outW : outH);
+
+        out = in;
+        for(x = 0; x < outDim; ++x, in += comps * 2)
+            for(c = 0; c < comps; ++c, out++)
+                *out = (uint8_t)((in[c] + in[comps + c]) >> 1);
+        return;
+    }
+
+    out = in;
+    for(y = 0; y < outH; ++y, in += width * comps)
+        for(x = 0; x < outW; ++x, in += comps * 2)
+            for(c = 0; c < comps; ++c, out++)
+                *out = (uint8_t)((in[c] + in[comps + c] + in[comps * width + c] +
+                              in[comps * (width + 1) + c]) >> 2);
+}
+
+static void downMipmap8(uint8_t* in, uint8_t* fadedOut, int width, int height, float fade)
+{
+    int x, y, outW = width / 2, outH = height / 2;
+    float invFade;
+    byte* out = in;
+
+    if(fade > 1)
+        fade = 1;
+    invFade = 1 - fade;
+
+    if(!outW || !outH)
+    {
+        int outDim = (width > 1 ? outW : outH);
+
+        for(x = 0; x < outDim; x++, in += 2)
+        {
+            *out = (in[0] + in[1]) / 2;
+            *fadedOut++ = (byte) (*out * invFade + 0x80 * fade);
+            out++;
+        }
+    }
+    else
+    {
+        for(y = 0; y < outH; y++, in += width)
+            for(x = 0; x < outW; x++, in += 2)
+            {
+                *out = (in[0] + in[1] + in[width] + in[width + 1]) / 4;
+                *fadedOut++ = (byte) (*out * invFade + 0x80 * fade);
+                out++;
+            }
+    }
+}
+
+} // namespace reference
+
+typedef QVector<uint8_t> Pixels;
+
+/**
+ * Generates a test image: smooth gradients with deterministic noise, so that
+ * both interpolation and averaging are exercised.
+ */
+static Pixels makeImage(int width, int height, int comps, int stride = 0)
+{
+    if(!stride) stride = width * comps;
+
+    Pixels img(stride * height);
+    duint32 seed = duint32(width * 7919 + height * 104729 + comps);
+    for(int y = 0; y < height; ++y)
+    {
+        for(int x = 0; x < width; ++x)
+        {
+            for(int c = 0; c < comps; ++c)
+            {
+                seed = seed * 1103515245 + 12345;
+                int const gradient = (x * 255 / de::max(1, width - 1) + y * 97 + c * 61) & 0xff;
+                int const noise = int((seed >> 16) % 32) - 16;
+                img[y * stride + x * comps + c] = uint8_t(de::clamp(0, gradient + noise, 255));
+            }
+        }
+    }
+    return img;
+}
+
+/// Largest difference between the components of two images.
+static int maxDifference(uint8_t const *a, uint8_t const *b, int size)
+{
+    int diff = 0;
+    for(int i = 0; i < size; ++i)
+    {
+        diff = de::max(diff, std::abs(int(a[i]) - int(b[i])));
+    }
+    return diff;
+}
+
+static void compare(char const *what, uint8_t const *result, uint8_t const *expected,
+                    int size, int width, int height, int comps)
+{
+    int const diff = maxDifference(result, expected, size);
+    if(diff > TOLERANCE)
+    {
+        qWarning() << what << width << "x" << height << "comps" << comps
+                   << "differs from the reference by" << diff;
+    }
+    check(diff <= TOLERANCE, what);
+}
+
+struct Size { int w, h; };
+
+static void testScaling()
+{
+    static Size const sizes[][2] = {
+        { { 1, 1 },     { 2, 2 } },
+        { { 2, 2 },     { 1, 1 } },
+        { { 3, 5 },     { 7, 3 } },
+        { { 17, 9 },    { 64, 64 } },
+        { { 64, 64 },   { 32, 16 } },
+        { { 100, 37 },  { 33, 100 } },
+        { { 256, 256 }, { 128, 128 } },
+        { { 256, 128 }, { 512, 512 } },
+        { { 200, 300 }, { 256, 256 } }
+    };
+
+    for(unsigned n = 0; n < sizeof(sizes) / sizeof(sizes[0]); ++n)
+    {
+        Size const in = sizes[n][0], out = sizes[n][1];
+
+        for(int comps = 1; comps <= 4; ++comps)
+        {
+            Pixels const img = makeImage(in.w, in.h, comps);
+            int const outSize = out.w * out.h * comps;
+
+            uint8_t *result   = GL_ScaleBuffer(img.constData(), in.w, in.h, comps, out.w, out.h);
+            uint8_t *expected = reference::scaleBuffer(img.constData(), in.w, in.h, comps, out.w, out.h);
+            compare("GL_ScaleBuffer", result, expected, outSize, in.w, in.h, comps);
+            M_Free(result);
+            M_Free(expected);
+
+            // Unpacked with each alignment, with and without skipping.
+            for(int align = 1; align <= 8; align *= 2)
+            {
+                for(int skip = 0; skip <= 1; ++skip)
+                {
+                    int const rowLength = in.w + skip;
+                    int const stride = align * CEILING(rowLength * comps, align);
+                    Pixels const padded = makeImage(rowLength, in.h + skip, comps, stride);
+
+                    void *exResult = GL_ScaleBufferEx(padded.constData(), in.w, in.h, comps,
+                                                      rowLength, align, skip, skip,
+                                                      out.w, out.h, 0, 1, 0, 0);
+                    void *exExpected = reference::scaleBufferEx(padded.constData(), in.w, in.h, comps,
+                                                                rowLength, align, skip, skip,
+                                                                out.w, out.h);
+                    compare("GL_ScaleBufferEx", (uint8_t *) exResult, (uint8_t *) exExpected,
+                            outSize, in.w, in.h, comps);
+                    M_Free(exResult);
+                    M_Free(exExpected);
+                }
+            }
+        }
+    }
+}
+
+static void testMipmaps()
+{
+    static Size const sizes[] = {
+        { 2, 1 }, { 1, 2 }, { 1, 64 }, { 64, 1 }, { 2, 2 }, { 16, 4 }, { 256, 256 }
+    };
+
+    for(unsigned n = 0; n < sizeof(sizes) / sizeof(sizes[0]); ++n)
+    {
+        Size const in = sizes[n];
+        int const outW = de::max(1, in.w / 2), outH = de::max(1, in.h / 2);
+
+        for(int comps = 1; comps <= 4; ++comps)
+        {
+            Pixels result = makeImage(in.w, in.h, comps);
+            Pixels expected = result;
+            GL_DownMipmap32(result.data(), in.w, in.h, comps);
+            reference::downMipmap32(expected.data(), in.w, in.h, comps);
+            compare("GL_DownMipmap32", result.constData(), expected.constData(),
+                    outW * outH * comps, in.w, in.h, comps);
+        }
+
+        for(int f = 0; f <= 4; ++f)
+        {
+            float const fade = f / 3.f; // Includes a fade above one.
+            Pixels result = makeImage(in.w, in.h, 1);
+            Pixels expected = result;
+            Pixels resultFaded(outW * outH), expectedFaded(outW * outH);
+            GL_DownMipmap8(result.data(), resultFaded.data(), in.w, in.h, fade);
+            reference::downMipmap8(expected.data(), expectedFaded.data(), in.w, in.h, fade);
+            compare("GL_DownMipmap8", result.constData(), expected.constData(),
+                    outW * outH, in.w, in.h, 1);
+            compare("GL_DownMipmap8 (faded)", resultFaded.constData(), expectedFaded.constData(),
+                    outW * outH, in.w, in.h, 1);
+        }
+    }
+}
+
+/// Reports the throughput of a function in source megapixels per second.
+static void report(char const *what, TimeDelta const &elapsed, TimeDelta const &refElapsed)
+{
+    double const mpix = double(BENCHMARK_SIZE) * BENCHMARK_SIZE * BENCHMARK_REPEATS / 1.0e6;
+    qDebug() << what << ":" << mpix / elapsed << "MPix/s, reference:"
+             << mpix / refElapsed << "MPix/s";
+}
+
+static void benchmark()
+{
+    int const size = BENCHMARK_SIZE;
+    Pixels const rgba = makeImage(size, size, 4);
+    Pixels const paletted = makeImage(size, size, 1);
+
+    qDebug() << "Throughput with a" << size << "x" << size << "source image:";
+
+    Time startedAt;
+    for(int i = 0; i < BENCHMARK_REPEATS; ++i)
+        M_Free(GL_ScaleBuffer(rgba.constData(), size, size, 4, 2 * size, 2 * size));
+    TimeDelta elapsed = startedAt.since();
+    startedAt = Time();
+    for(int i = 0; i < BENCHMARK_REPEATS; ++i)
+        M_Free(reference::scaleBuffer(rgba.constData(), size, size, 4, 2 * size, 2 * size));
+    report("GL_ScaleBuffer (RGBA, 2x)", elapsed, startedAt.since());
+
+    startedAt = Time();
+    for(int i = 0; i < BENCHMARK_REPEATS; ++i)
+        M_Free(GL_ScaleBufferEx(rgba.constData(), size, size, 4, 0, 1, 0, 0,
+                                size / 2, size / 2, 0, 1, 0, 0));
+    elapsed = startedAt.since();
+    startedAt = Time();
+    for(int i = 0; i < BENCHMARK_REPEATS; ++i)
+        M_Free(reference::scaleBufferEx(rgba.constData(), size, size, 4, 0, 1, 0, 0,
+                                        size / 2, size / 2));
+    report("GL_ScaleBufferEx (RGBA, 1/2x)", elapsed, startedAt.since());
+
+    TimeDelta refElapsed = 0;
+    elapsed = 0;
+    for(int i = 0; i < BENCHMARK_REPEATS; ++i)
+    {
+        Pixels img = rgba;
+        startedAt = Time();
+        GL_DownMipmap32(img.data(), size, size, 4);
+        elapsed += startedAt.since();
+
+        img = rgba;
+        startedAt = Time();
+        reference::downMipmap32(img.data(), size, size, 4);
+        refElapsed += startedAt.since();
+    }
+    report("GL_DownMipmap32 (RGBA)", elapsed, refElapsed);
+
+    Pixels faded(size * size / 4);
+    refElapsed = 0;
+    elapsed = 0;
+    for(int i = 0; i < BENCHMARK_REPEATS; ++i)
+    {
+        Pixels img = paletted;
+        startedAt = Time();
+        GL_DownMipmap8(img.data(), faded.data(), size, size, .5f);
+        elapsed += startedAt.since();
+
+        img = paletted;
+        startedAt = Time();
+        reference::downMipmap8(img.data(), faded.data(), size, size, .5f);
+        refElapsed += startedAt.since();
+    }
+    report("GL_DownMipmap8", elapsed, refElapsed);
+}
+
+int main(int, char **)
+{
+    testScaling();
+    testMipmaps();
+    benchmark();
+
+    qDebug() << "Exiting main()...";
+    return checkResult();
+}
@@ -0,0 +1,14 @@
+include(../config_test.pri)
+include(../../dep_deng1.pri)
+
+TEMPLATE = app
+TARGET = test_resample
+
+# The image resampling functions of the client are built into the test.
+INCLUDEPATH += $$PWD/../../client/include
+
+SOURCES += \
+    main.cpp \
+    ../../client/src/gl/gl_resample.cpp
+
+deployTest($$TARGET)
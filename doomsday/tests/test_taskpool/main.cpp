@@ -0,0 +1,196 @@
+/**
+ * @file main.cpp
+ *
+ * TaskPool tests and throughput benchmark. @ingroup tests
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/Task>
+#include <de/TaskPool>
+#include <de/Time>
+#include <QAtomicInt>
+#include <QThread>
+#include <QDebug>
+
+#include "testcheck.h"
+
+using namespace de;
+
+static int const NUM_TINY_TASKS = 1000000;
+
+static QAtomicInt counter;
+
+static int counterValue()
+{
+    return counter.fetchAndAddOrdered(0);
+}
+
+/// Smallest possible unit of work.
+class TinyTask : public Task
+{
+public:
+    void runTask()
+    {
+        counter.fetchAndAddOrdered(1);
+    }
+};
+
+/// Checks that it is run after all of its predecessors in the chain.
+class ChainTask : public Task
+{
+public:
+    ChainTask(int expected) : _expected(expected) {}
+
+    void runTask()
+    {
+        check(counterValue() == _expected, "continuation run in order");
+        counter.fetchAndAddOrdered(1);
+    }
+
+private:
+    int _expected;
+};
+
+class TinyRangeWork : public TaskPool::IRangeWork
+{
+public:
+    void processRange(int begin, int end)
+    {
+        for(int i = begin; i < end; ++i)
+        {
+            counter.fetchAndAddOrdered(1);
+        }
+    }
+};
+
+/// Fails on one of the ranges.
+class FailingRangeWork : public TaskPool::IRangeWork
+{
+public:
+    void processRange(int begin, int end)
+    {
+        if(begin <= 500 && 500 < end)
+        {
+            throw Error("FailingRangeWork", "Item 500 failed");
+        }
+    }
+};
+
+/// Runs a parallelFor inside each task.
+class NestingTask : public Task
+{
+public:
+    void runTask()
+    {
+        TinyRangeWork work;
+        TaskPool::parallelFor(work, 1000);
+    }
+};
+
+int main(int, char **)
+{
+    try
+    {
+        // Continuations are run in order.
+        {
+            counter = 0;
+            ChainTask *first = new ChainTask(0);
+            Task *last = first;
+            for(int i = 1; i < 100; ++i)
+            {
+                Task *next = new ChainTask(i);
+                last->setContinuation(next);
+                last = next;
+            }
+
+            TaskPool pool;
+            pool.start(first);
+            pool.waitForDone();
+            check(pool.isDone(), "pool done after waiting");
+            check(counterValue() == 100, "all continuations run");
+            qDebug() << "Chain of" << counterValue() << "tasks completed.";
+        }
+
+        // Throughput of individually started tasks.
+        {
+            counter = 0;
+            Time startedAt;
+
+            TaskPool pool;
+            for(int i = 0; i < NUM_TINY_TASKS; ++i)
+            {
+                pool.start(new TinyTask);
+            }
+            pool.waitForDone();
+
+            TimeDelta const elapsed = startedAt.since();
+            check(counterValue() == NUM_TINY_TASKS, "all tasks run");
+            qDebug() << NUM_TINY_TASKS << "tasks started individually in"
+                     << elapsed << "seconds:" << NUM_TINY_TASKS / elapsed << "tasks/s";
+        }
+
+        // Throughput of the same work as a parallel for.
+        {
+            counter = 0;
+            Time startedAt;
+
+            TinyRangeWork work;
+            TaskPool::parallelFor(work, NUM_TINY_TASKS, 1024);
+
+            TimeDelta const elapsed = startedAt.since();
+            check(counterValue() == NUM_TINY_TASKS, "all items processed");
+            qDebug() << NUM_TINY_TASKS << "items processed with parallelFor in"
+                     << elapsed << "seconds:" << NUM_TINY_TASKS / elapsed << "items/s";
+        }
+
+        // Nested parallelFors from more tasks than there are threads.
+        {
+            counter = 0;
+            int const numTasks = 4 * QThread::idealThreadCount();
+
+            TaskPool pool;
+            for(int i = 0; i < numTasks; ++i)
+            {
+                pool.start(new NestingTask);
+            }
+            pool.waitForDone();
+            check(counterValue() == numTasks * 1000, "nested parallelFor completed");
+        }
+
+        // Errors in ranges are passed to the caller.
+        {
+            bool thrown = false;
+            try
+            {
+                FailingRangeWork work;
+                TaskPool::parallelFor(work, 1000);
+            }
+            catch(Error const &)
+            {
+                thrown = true;
+            }
+            check(thrown, "parallelFor error passed to caller");
+        }
+    }
+    catch(Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        check(false, "no uncaught errors");
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return checkResult();
+}
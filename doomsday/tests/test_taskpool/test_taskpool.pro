@@ -0,0 +1,8 @@
+include(../config_test.pri)
+
+TEMPLATE = app
+TARGET = test_taskpool
+
+SOURCES += main.cpp
+
+deployTest($$TARGET)
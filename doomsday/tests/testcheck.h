@@ -0,0 +1,59 @@
+/**
+ * @file testcheck.h
+ *
+ * Checks shared by the tests. @ingroup tests
+ *
+ * Unlike DENG2_ASSERT, the checks are also made in release builds. Failed
+ * checks are reported and counted, and the count determines the exit code of
+ * the test.
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_TESTS_TESTCHECK_H
+#define DENG_TESTS_TESTCHECK_H
+
+#include <QAtomicInt>
+#include <QDebug>
+
+/// Number of failed checks. Checks may be made in any thread.
+inline QAtomicInt &checkFailures()
+{
+    static QAtomicInt failures;
+    return failures;
+}
+
+/**
+ * Checks a condition. If it does not hold, the failure is reported using
+ * @a description and counted.
+ */
+inline void check(bool condition, char const *description)
+{
+    if(!condition)
+    {
+        qWarning() << "FAILED:" << description;
+        checkFailures().fetchAndAddOrdered(1);
+    }
+}
+
+/**
+ * Returns the exit code of the test: zero if all checks passed.
+ */
+inline int checkResult()
+{
+    return checkFailures().fetchAndAddOrdered(0)? 1 : 0;
+}
+
+#endif // DENG_TESTS_TESTCHECK_H
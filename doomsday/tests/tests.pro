@@ -7,13 +7,17 @@ TEMPLATE = subdirs
 
 deng_tests: SUBDIRS += \
     test_archive \
+    test_atlas \
     test_bitfield \
+    test_clipper \
     test_glsandbox \
     test_info \
     test_log \
     test_record \
+    test_resample \
     test_script \
     test_string \
     test_stringpool \
+    test_taskpool \
     test_vectors
     #basiclink